@@ -0,0 +1,121 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+/**
+ * @brief   Single benchmark measurement, either a timing of @p ops operations or a value
+ *          in the given unit.
+ */
+struct Result
+{
+    std::string name;
+    uint64_t    ops;
+    double      seconds;
+    double      value;
+    std::string unit; // empty for timings
+};
+
+/**
+ * @brief   Output format of the results.
+ */
+enum class Format
+{
+    Text,
+    Json,
+    Csv,
+};
+
+/**
+ * @brief   Collects the results of all benchmark cases and prints them.
+ *
+ * @details Text results are printed as soon as they are added, JSON and CSV results
+ *          are written at once by @ref write() so the output stays well-formed.
+ */
+class Reporter
+{
+public:
+
+    explicit Reporter(Format format = Format::Text) : m_format(format) {}
+
+    /**
+     * @brief   Records a measurement of @p ops operations that took @p seconds.
+     */
+    void add(const std::string& name, uint64_t ops, double seconds);
+
+    /**
+     * @brief   Records the p50, p90, p99, p99.9 and maximum of the given latency samples
+     *          in nanoseconds, each as a single operation named "name/pNN".
+     */
+    void addPercentiles(const std::string& name, std::vector<double> samplesNs);
+
+    /**
+     * @brief   Records a value in the given unit that isn't a timing, e.g. a compression
+     *          ratio.
+     */
+    void addValue(const std::string& name, double value, const std::string& unit);
+
+    /**
+     * @brief   Writes all results in a machine-readable format, nothing is written for
+     *          the text format.
+     */
+    void write(FILE* out) const;
+
+    const std::vector<Result>& results() const
+    {
+        return m_results;
+    }
+
+private:
+
+    Format              m_format;
+    std::vector<Result> m_results;
+};
+
+using CaseFn = void (*)(Reporter&);
+
+/**
+ * @brief   Registers a benchmark case at static initialization time. Use @ref BENCH_CASE
+ *          instead of instantiating it directly.
+ */
+struct Registrar
+{
+    Registrar(const char* name, CaseFn fn);
+};
+
+/**
+ * @brief   Runs the given callable once and returns the elapsed wall time in seconds.
+ */
+template<typename Fn>
+double timeIt(Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * @brief   Prevents the compiler from optimizing away the computation of @p val.
+ */
+template<typename T>
+inline void doNotOptimize(const T& val)
+{
+    asm volatile("" : : "r,m"(val) : "memory");
+}
+
+} // namespace bench
+
+#define BENCH_CASE(name)                                                                 \
+    static void                   name(bench::Reporter& rep);                            \
+    static const bench::Registrar name##Registrar(#name, name);                          \
+    static void                   name(bench::Reporter& rep)
+
+#endif
\ No newline at end of file
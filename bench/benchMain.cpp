@@ -0,0 +1,211 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <utility>
+
+namespace bench
+{
+
+namespace
+{
+
+std::vector<std::pair<const char*, CaseFn>>& registry()
+{
+    static std::vector<std::pair<const char*, CaseFn>> cases;
+    return cases;
+}
+
+double nsPerOp(const Result& res)
+{
+    return (res.ops > 0) ? (res.seconds * 1e9 / res.ops) : 0;
+}
+
+double opsPerS(const Result& res)
+{
+    return (res.seconds > 0) ? (res.ops / res.seconds) : 0;
+}
+
+} // namespace
+
+Registrar::Registrar(const char* name, CaseFn fn)
+{
+    registry().emplace_back(name, fn);
+}
+
+void Reporter::add(const std::string& name, uint64_t ops, double seconds)
+{
+    m_results.push_back({name, ops, seconds, 0, ""});
+    if (m_format != Format::Text)
+    {
+        return;
+    }
+
+    const Result& res = m_results.back();
+    printf("%-56s %12.2f ns/op %14.0f ops/s\n", name.c_str(), nsPerOp(res), opsPerS(res));
+    fflush(stdout);
+}
+
+void Reporter::addPercentiles(const std::string& name, std::vector<double> samplesNs)
+{
+    if (samplesNs.empty())
+    {
+        return;
+    }
+    std::sort(samplesNs.begin(), samplesNs.end());
+
+    const std::pair<const char*, double> points[] = {
+        {"p50", 0.5}, {"p90", 0.9}, {"p99", 0.99}, {"p999", 0.999}, {"max", 1.0}};
+    for (const auto& point: points)
+    {
+        const size_t idx = (size_t)(point.second * (double)(samplesNs.size() - 1));
+        add(name + "/" + point.first, 1, samplesNs[idx] * 1e-9);
+    }
+}
+
+void Reporter::addValue(const std::string& name, double value, const std::string& unit)
+{
+    m_results.push_back({name, 0, 0, value, unit});
+    if (m_format != Format::Text)
+    {
+        return;
+    }
+
+    printf("%-56s %12.2f %s\n", name.c_str(), value, unit.c_str());
+    fflush(stdout);
+}
+
+void Reporter::write(FILE* out) const
+{
+    if (m_format == Format::Csv)
+    {
+        fprintf(out, "name,ops,seconds,ns_per_op,ops_per_s,value,unit\n");
+        for (const Result& res: m_results)
+        {
+            if (!res.unit.empty())
+            {
+                fprintf(out, "%s,,,,,%.6f,%s\n", res.name.c_str(), res.value,
+                        res.unit.c_str());
+                continue;
+            }
+            fprintf(out, "%s,%llu,%.9f,%.3f,%.0f,,\n", res.name.c_str(),
+                    (unsigned long long)res.ops, res.seconds, nsPerOp(res), opsPerS(res));
+        }
+    }
+    else if (m_format == Format::Json)
+    {
+        // case names only contain characters that need no escaping
+        fprintf(out, "{\n  \"timestamp\": %lld,\n  \"hw_threads\": %u,\n  \"results\": [",
+                (long long)time(NULL), std::thread::hardware_concurrency());
+        for (size_t i = 0; i < m_results.size(); ++i)
+        {
+            const Result& res = m_results[i];
+            if (!res.unit.empty())
+            {
+                fprintf(out, "%s\n    {\"name\": \"%s\", \"value\": %.6f, "
+                             "\"unit\": \"%s\"}",
+                        (i > 0) ? "," : "", res.name.c_str(), res.value,
+                        res.unit.c_str());
+                continue;
+            }
+            fprintf(out,
+                    "%s\n    {\"name\": \"%s\", \"ops\": %llu, \"seconds\": %.9f, "
+                    "\"ns_per_op\": %.3f, \"ops_per_s\": %.0f}",
+                    (i > 0) ? "," : "", res.name.c_str(), (unsigned long long)res.ops,
+                    res.seconds, nsPerOp(res), opsPerS(res));
+        }
+        fprintf(out, "\n  ]\n}\n");
+    }
+}
+
+} // namespace bench
+
+namespace
+{
+
+void printUsage(const char* prog)
+{
+    fprintf(stderr, "Usage: %s [--format text|json|csv] [--out FILE] [filter]\n", prog);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bench::Format format  = bench::Format::Text;
+    const char*   outPath = NULL;
+    const char*   filter  = ""; // substring that case names must contain
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(argv[i], "--format") == 0) && (i + 1 < argc))
+        {
+            const char* name = argv[++i];
+            if (strcmp(name, "text") == 0)
+            {
+                format = bench::Format::Text;
+            }
+            else if (strcmp(name, "json") == 0)
+            {
+                format = bench::Format::Json;
+            }
+            else if (strcmp(name, "csv") == 0)
+            {
+                format = bench::Format::Csv;
+            }
+            else
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if ((strcmp(argv[i], "--out") == 0) && (i + 1 < argc))
+        {
+            outPath = argv[++i];
+        }
+        else if (argv[i][0] == '-')
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            filter = argv[i];
+        }
+    }
+
+    FILE* out = stdout;
+    if (outPath != NULL)
+    {
+        out = fopen(outPath, "w");
+        if (out == NULL)
+        {
+            perror(outPath);
+            return 1;
+        }
+    }
+
+    bench::Reporter rep(format);
+    for (const auto& benchCase: bench::registry())
+    {
+        if (strstr(benchCase.first, filter) != NULL)
+        {
+            // progress goes to stderr so that stdout stays machine-readable
+            if (format != bench::Format::Text)
+            {
+                fprintf(stderr, "running %s\n", benchCase.first);
+            }
+            benchCase.second(rep);
+        }
+    }
+    rep.write(out);
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    return 0;
+}
\ No newline at end of file
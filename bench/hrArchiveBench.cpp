@@ -0,0 +1,103 @@
+#include "bench.h"
+
+#include "hr_archive.h"
+#include "hr_gen.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const size_t kSamples = 1u << 20;
+const int    kRounds  = 20;
+
+// slowly drifting heart rate, a constant one as the best case, and the uniform generator
+// output as the worst case
+std::vector<uint8_t> signal(const std::string& kind)
+{
+    std::vector<uint8_t> samples(kSamples, 70);
+    if (kind == "constant")
+    {
+        return samples;
+    }
+    if (kind == "uniform")
+    {
+        hr_gen_t gen;
+        hr_gen_init(&gen, 1);
+        hr_gen_fill(&gen, samples.data(), samples.size());
+        return samples;
+    }
+
+    std::mt19937                       gen(1);
+    std::uniform_int_distribution<int> step(-2, 2);
+    int                                val = 70;
+    for (uint8_t& sample: samples)
+    {
+        val    = std::max(val + step(gen), (int)HR_GEN_MIN_HR);
+        val    = std::min(val, (int)HR_GEN_MAX_HR);
+        sample = (uint8_t)val;
+    }
+    return samples;
+}
+
+// Scans of the whole history out of the plain ring buffer and out of the archive, and
+// the encoding of the history into the archive. One operation is one sample. The ratio
+// is the size of the raw samples over the bytes of their encoded blocks.
+BENCH_CASE(hr_archive_scan)
+{
+    for (const char* kind: {"walk", "constant", "uniform"})
+    {
+        const std::string          prefix  = kind;
+        const std::vector<uint8_t> samples = signal(prefix);
+        std::vector<uint8_t>       out(kSamples);
+
+        std::vector<uint8_t> buff(kSamples + 1);
+        ring_buffer_t        rb;
+        rb_init(&rb, buff.data(), buff.size(), sizeof(uint8_t));
+        rb_add_n(&rb, samples.data(), samples.size(), NULL);
+
+        double seconds = bench::timeIt([&]() {
+            for (int r = 0; r < kRounds; ++r)
+            {
+                rb_it_t it;
+                size_t  n;
+                rb_init_read_it(&rb, &it);
+                rb_read_n(&it, out.data(), out.size(), &n);
+                bench::doNotOptimize(out.data());
+            }
+        });
+        rep.add("hr_archive_scan/" + prefix + "/ring_read", kSamples * kRounds, seconds);
+
+        std::vector<char> mem(hr_archive_mem_size(kSamples));
+        hr_archive_t      ar;
+        seconds = bench::timeIt([&]() {
+            for (int r = 0; r < kRounds; ++r)
+            {
+                hr_archive_init(&ar, mem.data(), mem.size());
+                hr_archive_push(&ar, samples.data(), samples.size());
+            }
+        });
+        rep.add("hr_archive_scan/" + prefix + "/encode", kSamples * kRounds, seconds);
+
+        uint64_t encoded;
+        size_t   bytes;
+        hr_archive_usage(&ar, &encoded, &bytes);
+        rep.addValue("hr_archive_scan/" + prefix + "/ratio",
+                     (double)(encoded * sizeof(uint8_t)) / (double)bytes, "x");
+
+        seconds = bench::timeIt([&]() {
+            for (int r = 0; r < kRounds; ++r)
+            {
+                size_t n;
+                hr_archive_read(&ar, 0, out.data(), out.size(), &n);
+                bench::doNotOptimize(out.data());
+            }
+        });
+        rep.add("hr_archive_scan/" + prefix + "/decode", kSamples * kRounds, seconds);
+    }
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "bench.h"
+
+#include "hr_ema_batch.h"
+#include "hr_gen.h"
+
+#include <vector>
+
+namespace
+{
+
+const uint64_t kUpdates  = 40000000;
+const size_t   kChannels = 4096;
+const size_t   kWindow   = 10;
+
+// one channel update is one sample added to one channel
+BENCH_CASE(hr_ema_batch)
+{
+    const uint64_t nSteps = kUpdates / kChannels;
+
+    std::vector<uint8_t> samples(kChannels);
+    std::vector<uint8_t> res(kChannels);
+    for (auto& sample: samples)
+    {
+        sample = hr_gen_random();
+    }
+
+    // the single channel state advanced once per channel, as a baseline
+    {
+        std::vector<std::vector<uint8_t>> buffs(kChannels,
+                                                std::vector<uint8_t>(kWindow + 1));
+        std::vector<ring_buffer_t>        rbs(kChannels);
+        std::vector<hr_ema_state_t>       states(kChannels);
+        for (size_t c = 0; c < kChannels; ++c)
+        {
+            rb_init(&rbs[c], buffs[c].data(), kWindow + 1, sizeof(uint8_t));
+            hr_ema_init(&states[c], &rbs[c]);
+        }
+
+        double seconds = bench::timeIt([&]() {
+            for (uint64_t i = 0; i < nSteps; ++i)
+            {
+                for (size_t c = 0; c < kChannels; ++c)
+                {
+                    uint8_t old;
+                    bool    evicted;
+                    rb_push_overwrite(&rbs[c], &samples[c], &old, &evicted);
+                    hr_ema_push(&states[c], samples[c], evicted ? &old : NULL, &res[c]);
+                }
+                samples[i % kChannels]++;
+            }
+            bench::doNotOptimize(res);
+        });
+        rep.add("hr_ema_batch/4096ch/per_channel", nSteps * kChannels, seconds);
+    }
+
+    const hr_ema_isa_t isas[]  = {HR_EMA_ISA_SCALAR, HR_EMA_ISA_SSE2, HR_EMA_ISA_AVX2};
+    const char*        names[] = {"scalar", "sse2", "avx2"};
+    for (size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); ++i)
+    {
+        hr_ema_batch_t    batch;
+        std::vector<char> mem(hr_ema_batch_mem_size(kChannels, kWindow));
+        hr_ema_batch_init(&batch, mem.data(), mem.size(), kChannels, kWindow);
+        if (hr_ema_batch_set_isa(&batch, isas[i]) != RB_OK)
+        {
+            continue;
+        }
+
+        double seconds = bench::timeIt([&]() {
+            for (uint64_t s = 0; s < nSteps; ++s)
+            {
+                hr_ema_batch_push(&batch, samples.data(), res.data());
+                samples[s % kChannels]++;
+            }
+            bench::doNotOptimize(res);
+        });
+        rep.add(std::string("hr_ema_batch/4096ch/") + names[i], nSteps * kChannels,
+                seconds);
+    }
+}
+
+} // namespace
\ No newline at end of file
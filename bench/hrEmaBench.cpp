@@ -0,0 +1,105 @@
+#include "bench.h"
+
+#include "hr_ema.h"
+#include "hr_gen.h"
+
+#include <vector>
+
+namespace
+{
+
+const uint64_t kWork = 20000000;
+
+// fills a ring buffer with the given window size with generated heart rates
+void fillWindow(ring_buffer_t* rb, std::vector<uint8_t>& buff, size_t window)
+{
+    buff.resize(window + 1);
+    rb_init(rb, buff.data(), buff.size(), sizeof(uint8_t));
+    for (size_t i = 0; i < window; ++i)
+    {
+        uint8_t val = hr_gen_random();
+        rb_add(rb, &val);
+    }
+}
+
+BENCH_CASE(hr_ema_window)
+{
+    for (size_t window = 10; window <= 1000000; window *= 10)
+    {
+        std::vector<uint8_t> buff;
+        ring_buffer_t        rb;
+        fillWindow(&rb, buff, window);
+
+        // the full recalculation visits the whole window per sample
+        const uint64_t nCalc   = (kWork / window > 10) ? (kWork / window) : 10;
+        double         seconds = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < nCalc; ++i)
+            {
+                uint8_t val = i;
+                rb_push_overwrite(&rb, &val, NULL, NULL);
+                sum += hr_ema_calc(&rb);
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add("hr_ema_calc/" + std::to_string(window), nCalc, seconds);
+
+        hr_ema_state_t state;
+        hr_ema_init(&state, &rb);
+        seconds = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < kWork / 4; ++i)
+            {
+                uint8_t val = i;
+                uint8_t old;
+                bool    evicted;
+                uint8_t ema;
+                rb_push_overwrite(&rb, &val, &old, &evicted);
+                hr_ema_push(&state, val, evicted ? &old : NULL, &ema);
+                sum += ema;
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add("hr_ema_push/" + std::to_string(window), kWork / 4, seconds);
+    }
+}
+
+// Full recalculation of the window in floating point and in fixed point.
+BENCH_CASE(hr_ema_fixed)
+{
+    const hr_ema_cfg_t cfg = {HR_EMA_ALPHA_Q15(HR_EMA_ALPHA)};
+
+    for (size_t window = 10; window <= 1000; window *= 10)
+    {
+        std::vector<uint8_t> buff;
+        ring_buffer_t        rb;
+        fillWindow(&rb, buff, window);
+
+        const uint64_t nCalc   = kWork / window;
+        double         seconds = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < nCalc; ++i)
+            {
+                uint8_t val = i;
+                rb_push_overwrite(&rb, &val, NULL, NULL);
+                sum += hr_ema_calc(&rb);
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add("hr_ema_fixed/float/" + std::to_string(window), nCalc, seconds);
+
+        seconds = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < nCalc; ++i)
+            {
+                uint8_t val = i;
+                rb_push_overwrite(&rb, &val, NULL, NULL);
+                sum += hr_ema_calc_fixed(&rb, &cfg);
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add("hr_ema_fixed/q15/" + std::to_string(window), nCalc, seconds);
+    }
+}
+
+} // namespace
\ No newline at end of file
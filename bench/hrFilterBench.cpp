@@ -0,0 +1,88 @@
+#include "bench.h"
+
+#include "hr_filter.h"
+#include "hr_gen.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const uint64_t kWork = 20000000;
+
+// Median -> EMA -> SMA over the same window length, once by rescanning the ring buffer
+// of every stage per sample and once by the incremental pipeline. One operation is one
+// sample through all three stages.
+BENCH_CASE(hr_filter_chain)
+{
+    for (size_t window = 10; window <= 1000; window *= 10)
+    {
+        std::vector<uint8_t> samples(4096);
+        for (uint8_t& val: samples)
+        {
+            val = hr_gen_random();
+        }
+
+        // the rescan visits every window per sample, the median sorts it
+        const uint64_t nRescan = kWork / window / 20;
+        double         seconds = bench::timeIt([&]() {
+            std::vector<uint8_t> buffs[3];
+            ring_buffer_t        rbs[3];
+            for (int s = 0; s < 3; ++s)
+            {
+                buffs[s].resize(window + 1);
+                rb_init(&rbs[s], buffs[s].data(), buffs[s].size(), sizeof(uint8_t));
+            }
+            std::vector<uint8_t> sorted(window);
+
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < nRescan; ++i)
+            {
+                rb_it_t it;
+                size_t  n;
+                rb_push_overwrite(&rbs[0], &samples[i % samples.size()], NULL, NULL);
+                rb_init_read_it(&rbs[0], &it);
+                rb_read_n(&it, sorted.data(), window, &n);
+                std::sort(sorted.begin(), sorted.begin() + n);
+                uint8_t val = sorted[n / 2];
+
+                rb_push_overwrite(&rbs[1], &val, NULL, NULL);
+                val = hr_ema_calc(&rbs[1]);
+
+                rb_push_overwrite(&rbs[2], &val, NULL, NULL);
+                rb_init_read_it(&rbs[2], &it);
+                uint64_t smaSum = 0;
+                while (rb_get_next_val(&it, &val) == RB_OK)
+                {
+                    smaSum += val;
+                }
+                sum += smaSum / rb_size(&rbs[2]);
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add("hr_filter_chain/rescan/" + std::to_string(window), nRescan, seconds);
+
+        const hr_filter_cfg_t cfg[] = {
+            {HR_FILTER_MEDIAN, window}, {HR_FILTER_EMA, window}, {HR_FILTER_SMA, window}};
+        std::vector<char> mem(hr_filter_mem_size(cfg, 3));
+        hr_filter_t       filter;
+        hr_filter_init(&filter, mem.data(), mem.size(), cfg, 3);
+
+        const uint64_t nPush = kWork / 4;
+        seconds              = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < nPush; ++i)
+            {
+                uint8_t out;
+                hr_filter_push(&filter, samples[i % samples.size()], &out);
+                sum += out;
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add("hr_filter_chain/pipeline/" + std::to_string(window), nPush, seconds);
+    }
+}
+
+} // namespace
\ No newline at end of file
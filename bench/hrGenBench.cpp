@@ -0,0 +1,104 @@
+#include "bench.h"
+
+#include "hr_gen.h"
+
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const uint64_t kSamples = 64000000;
+
+BENCH_CASE(hr_gen)
+{
+    // the former implementation, as a baseline
+    double seconds = bench::timeIt([&]() {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < kSamples / 4; ++i)
+        {
+            sum += (rand() % (HR_GEN_MAX_HR - HR_GEN_MIN_HR + 1)) + HR_GEN_MIN_HR;
+        }
+        bench::doNotOptimize(sum);
+    });
+    rep.add("hr_gen/rand_modulo", kSamples / 4, seconds);
+
+    seconds = bench::timeIt([&]() {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < kSamples / 4; ++i)
+        {
+            sum += hr_gen_random();
+        }
+        bench::doNotOptimize(sum);
+    });
+    rep.add("hr_gen/hr_gen_random", kSamples / 4, seconds);
+
+    hr_gen_t gen;
+    hr_gen_init(&gen, 1);
+    seconds = bench::timeIt([&]() {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < kSamples / 4; ++i)
+        {
+            sum += hr_gen_next(&gen);
+        }
+        bench::doNotOptimize(sum);
+    });
+    rep.add("hr_gen/hr_gen_next", kSamples / 4, seconds);
+
+    std::vector<uint8_t> buff(4096);
+    seconds = bench::timeIt([&]() {
+        for (uint64_t i = 0; i < kSamples; i += buff.size())
+        {
+            hr_gen_fill(&gen, buff.data(), buff.size());
+            bench::doNotOptimize(buff[0]);
+        }
+    });
+    rep.add("hr_gen/hr_gen_fill/4096", kSamples, seconds);
+}
+
+// every thread generates its share of the samples, ops/s is the total throughput
+template<typename Fn>
+double runThreads(size_t nThreads, uint64_t perThread, Fn fn)
+{
+    return bench::timeIt([&]() {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < nThreads; ++t)
+        {
+            threads.emplace_back([&]() {
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < perThread; ++i)
+                {
+                    sum += fn();
+                }
+                bench::doNotOptimize(sum);
+            });
+        }
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+    });
+}
+
+BENCH_CASE(hr_gen_threads)
+{
+    const size_t   hw        = std::thread::hardware_concurrency();
+    const size_t   maxT      = (hw > 2) ? hw : 2;
+    const uint64_t perThread = kSamples / 16;
+
+    for (size_t nThreads = 1; nThreads <= maxT; nThreads *= 2)
+    {
+        double seconds = runThreads(nThreads, perThread, []() {
+            return (rand() % (HR_GEN_MAX_HR - HR_GEN_MIN_HR + 1)) + HR_GEN_MIN_HR;
+        });
+        rep.add("hr_gen_threads/rand_modulo/" + std::to_string(nThreads),
+                nThreads * perThread, seconds);
+
+        seconds = runThreads(nThreads, perThread, []() { return hr_gen_random(); });
+        rep.add("hr_gen_threads/hr_gen_random/" + std::to_string(nThreads),
+                nThreads * perThread, seconds);
+    }
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "bench.h"
+
+#include "hr_hub.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const size_t   kStreams = 16384;
+const size_t   kWindow  = 10;
+const uint32_t kTicks   = 16;
+const int      kRounds  = 40;
+
+// one operation is one sample added to a stream and its EMA update
+BENCH_CASE(hr_hub_scaling)
+{
+    std::vector<size_t> threadCounts = {1, 2, 4};
+    if (std::thread::hardware_concurrency() > 4)
+    {
+        threadCounts.push_back(std::thread::hardware_concurrency());
+    }
+
+    for (size_t nThreads: threadCounts)
+    {
+        hr_hub_t          hub;
+        std::vector<char> mem(hr_hub_mem_size(kStreams, kWindow, nThreads));
+        if (hr_hub_init(&hub, mem.data(), mem.size(), kStreams, kWindow, nThreads, 1) !=
+            RB_OK)
+        {
+            continue;
+        }
+
+        uint64_t total   = 0;
+        double   seconds = bench::timeIt([&]() {
+            for (int r = 0; r < kRounds; ++r)
+            {
+                uint64_t samples;
+                hr_hub_run(&hub, kTicks, &samples);
+                total += samples;
+            }
+        });
+        hr_hub_destroy(&hub);
+        rep.add("hr_hub_scaling/" + std::to_string(kStreams) + "streams/" +
+                    std::to_string(nThreads) + "threads",
+                total, seconds);
+    }
+}
+
+// the first 16th of the streams produces all samples, so the other shards run dry
+BENCH_CASE(hr_hub_uneven_load)
+{
+    const size_t      nThreads = 4;
+    hr_hub_t          hub;
+    std::vector<char> mem(hr_hub_mem_size(kStreams, kWindow, nThreads));
+    if (hr_hub_init(&hub, mem.data(), mem.size(), kStreams, kWindow, nThreads, 1) !=
+        RB_OK)
+    {
+        return;
+    }
+    for (size_t s = 0; s < kStreams; ++s)
+    {
+        hr_hub_set_rate(&hub, s, (s < kStreams / 16) ? 32 : 0);
+    }
+
+    uint64_t total   = 0;
+    double   seconds = bench::timeIt([&]() {
+        for (int r = 0; r < kRounds; ++r)
+        {
+            uint64_t samples;
+            hr_hub_run(&hub, kTicks, &samples);
+            total += samples;
+        }
+    });
+    hr_hub_destroy(&hub);
+    rep.add("hr_hub_uneven_load/4threads", total, seconds);
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "bench.h"
+
+#include "hr_gen.h"
+#include "hr_rollup.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const uint64_t kDay     = 86400;
+const uint64_t kSamples = 4 * kDay;
+const uint64_t kQueries = 2000;
+
+// One day and one hour of seconds, a day of minutes and a month of hours. Samples are
+// pushed once per second, one operation is one sample.
+BENCH_CASE(hr_rollup_push)
+{
+    const hr_rollup_cfg_t cfg[] = {{60, 1500}, {60, 720}};
+    std::vector<uint8_t>  samples(kSamples);
+    hr_gen_t              gen;
+    hr_gen_init(&gen, 1);
+    hr_gen_fill(&gen, samples.data(), samples.size());
+
+    std::vector<uint8_t> buff(kDay + 3600 + 1);
+    ring_buffer_t        rb;
+    rb_init(&rb, buff.data(), buff.size(), sizeof(uint8_t));
+    double seconds = bench::timeIt([&]() {
+        for (uint64_t i = 0; i < kSamples; ++i)
+        {
+            rb_push_overwrite(&rb, &samples[i], NULL, NULL);
+        }
+    });
+    rep.add("hr_rollup_push/ring", kSamples, seconds);
+
+    std::vector<char> mem(hr_rollup_mem_size(kDay + 3600, cfg, 2));
+    hr_rollup_t       rollup;
+    hr_rollup_init(&rollup, mem.data(), mem.size(), kDay + 3600, cfg, 2);
+    seconds = bench::timeIt([&]() {
+        for (uint64_t i = 0; i < kSamples; ++i)
+        {
+            hr_rollup_push(&rollup, samples[i]);
+        }
+    });
+    rep.add("hr_rollup_push/rollup", kSamples, seconds);
+}
+
+// Min, max and average of the last hour and day, by iterating over the seconds of the
+// ring buffer from the newest one and by the rollups. A sample is pushed before every
+// query, so the partial buckets at both ends vary. One operation is one sample and one
+// query.
+BENCH_CASE(hr_rollup_query)
+{
+    const hr_rollup_cfg_t cfg[] = {{60, 1500}, {60, 720}};
+    std::vector<uint8_t>  buff(kDay + 3600 + 1);
+    ring_buffer_t         rb;
+    rb_init(&rb, buff.data(), buff.size(), sizeof(uint8_t));
+
+    std::vector<char> mem(hr_rollup_mem_size(kDay + 3600, cfg, 2));
+    hr_rollup_t       rollup;
+    hr_rollup_init(&rollup, mem.data(), mem.size(), kDay + 3600, cfg, 2);
+
+    std::vector<uint8_t> samples(2 * kDay + kQueries);
+    hr_gen_t             gen;
+    hr_gen_init(&gen, 1);
+    hr_gen_fill(&gen, samples.data(), samples.size());
+    for (uint64_t i = 0; i < 2 * kDay; ++i)
+    {
+        rb_push_overwrite(&rb, &samples[i], NULL, NULL);
+        hr_rollup_push(&rollup, samples[i]);
+    }
+
+    for (uint64_t window: {(uint64_t)3600, kDay})
+    {
+        const std::string name = (window == kDay) ? "day" : "hour";
+
+        double seconds = bench::timeIt([&]() {
+            for (uint64_t q = 0; q < kQueries; ++q)
+            {
+                rb_push_overwrite(&rb, &samples[(2 * kDay) + q], NULL, NULL);
+
+                rb_it_t  it;
+                uint64_t sum = 0;
+                uint8_t  min = UINT8_MAX;
+                uint8_t  max = 0;
+                uint8_t  val;
+                rb_init_reverse_it(&rb, &it);
+                for (uint64_t i = 0; i < window; ++i)
+                {
+                    rb_get_prev_val(&it, &val);
+                    sum += val;
+                    min = (val < min) ? val : min;
+                    max = (val > max) ? val : max;
+                }
+                bench::doNotOptimize(sum);
+                bench::doNotOptimize(min);
+                bench::doNotOptimize(max);
+            }
+        });
+        rep.add("hr_rollup_query/" + name + "/scan", kQueries, seconds);
+
+        seconds = bench::timeIt([&]() {
+            for (uint64_t q = 0; q < kQueries; ++q)
+            {
+                hr_rollup_push(&rollup, samples[(2 * kDay) + q]);
+
+                hr_rollup_agg_t agg;
+                hr_rollup_last(&rollup, window, &agg);
+                bench::doNotOptimize(agg);
+            }
+        });
+        rep.add("hr_rollup_query/" + name + "/rollup", kQueries, seconds);
+    }
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "bench.h"
+
+#include "hr_sink.h"
+
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+const uint64_t kRecords = 1000000;
+
+// Output of the EMA of every sample to /dev/null, by a stream flushed with std::endl per
+// record as main did, by the same stream without the flush, and by the sink in every
+// format. The sink is destroyed inside the timed part, so every record has been written.
+// One operation is one record.
+BENCH_CASE(hr_sink_write)
+{
+    double seconds = bench::timeIt([&]() {
+        std::ofstream out("/dev/null");
+        for (uint64_t i = 0; i < kRecords; ++i)
+        {
+            out << "EMA heart rate: " << std::to_string((uint8_t)i) << std::endl;
+        }
+    });
+    rep.add("hr_sink_write/endl", kRecords, seconds);
+
+    seconds = bench::timeIt([&]() {
+        std::ofstream out("/dev/null");
+        for (uint64_t i = 0; i < kRecords; ++i)
+        {
+            out << "EMA heart rate: " << std::to_string((uint8_t)i) << '\n';
+        }
+    });
+    rep.add("hr_sink_write/newline", kRecords, seconds);
+
+    const int fd = open("/dev/null", O_WRONLY);
+    for (hr_sink_format_t format : {HR_SINK_TEXT, HR_SINK_CSV, HR_SINK_BINARY})
+    {
+        const hr_sink_cfg_t cfg  = {fd, format, 4096, 64 * 1024, 100, -1};
+        const char*         name = (format == HR_SINK_TEXT)  ? "text"
+                                   : (format == HR_SINK_CSV) ? "csv"
+                                                             : "binary";
+
+        std::vector<char> mem(hr_sink_mem_size(cfg.depth, cfg.batch_size));
+        hr_sink_t         sink;
+        seconds = bench::timeIt([&]() {
+            hr_sink_init(&sink, mem.data(), mem.size(), &cfg);
+            for (uint64_t i = 0; i < kRecords; ++i)
+            {
+                hr_sink_rec_t rec = {i, 0, (uint8_t)i, (uint8_t)(i / 3)};
+                hr_sink_push(&sink, &rec);
+            }
+            hr_sink_destroy(&sink, NULL);
+        });
+        rep.add(std::string("hr_sink_write/sink/") + name, kRecords, seconds);
+    }
+    close(fd);
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "bench.h"
+
+#include "ring_buffer.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Writes every element of a freshly created 64 MiB ring once, so the page faults of the
+// first touch are part of the lazy cases. One operation is one 8-byte element.
+BENCH_CASE(rb_create_first_touch)
+{
+    const size_t cap = (64u << 20) / sizeof(uint64_t);
+
+    const struct
+    {
+        const char* name;
+        uint32_t    opts;
+    } cases[] = {
+        {"lazy", 0},
+        {"lazy_thp", RB_CREATE_THP},
+        {"prefault", RB_CREATE_PREFAULT},
+        {"prefault_thp", RB_CREATE_PREFAULT | RB_CREATE_THP},
+    };
+
+    for (const auto& c: cases)
+    {
+        ring_buffer_t rb;
+        if (rb_create(&rb, cap, sizeof(uint64_t), RB_CREATE_POW2 | c.opts) != RB_OK)
+        {
+            continue;
+        }
+
+        double seconds = bench::timeIt([&]() {
+            for (uint64_t i = 0; i < cap; ++i)
+            {
+                rb_push_overwrite(&rb, &i, NULL, NULL);
+            }
+        });
+        rep.add(std::string("rb_create_first_touch/") + c.name, cap, seconds);
+        rb_destroy(&rb);
+    }
+}
+
+// Streams batches of 100 elements through a ring with zero-copy reserve/peek. In the
+// plain ring a batch that wraps needs a second reserve and peek, in the mirrored one it
+// is always one region. One operation is one batch.
+BENCH_CASE(rb_create_mirror_batches)
+{
+    const size_t   batch    = 100;
+    const uint64_t nBatches = 2000000;
+
+    for (int mirror = 0; mirror <= 1; ++mirror)
+    {
+        const std::string name = mirror ? "mirrored" : "plain";
+        ring_buffer_t     rb;
+        if (rb_create(&rb, 1000, sizeof(uint32_t), mirror ? RB_CREATE_MIRROR : 0) !=
+            RB_OK)
+        {
+            continue;
+        }
+
+        double seconds = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            for (uint64_t b = 0; b < nBatches; ++b)
+            {
+                for (size_t done = 0; done < batch;)
+                {
+                    void*  ptr;
+                    size_t n;
+                    rb_reserve_write(&rb, batch - done, &ptr, &n);
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        ((uint32_t*)ptr)[i] = (uint32_t)(done + i);
+                    }
+                    rb_commit_write(&rb, n);
+                    done += n;
+                }
+                for (size_t done = 0; done < batch;)
+                {
+                    void*  ptr;
+                    size_t n;
+                    rb_peek_read(&rb, &ptr, &n);
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        sum += ((uint32_t*)ptr)[i];
+                    }
+                    rb_release_read(&rb, n);
+                    done += n;
+                }
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add("rb_create_mirror_batches/" + name, nBatches, seconds);
+        rb_destroy(&rb);
+    }
+}
+
+} // namespace
\ No newline at end of file
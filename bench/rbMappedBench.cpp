@@ -0,0 +1,74 @@
+#include "bench.h"
+
+#include "rb_mapped.h"
+
+#include <string>
+#include <unistd.h>
+
+namespace
+{
+
+const uint64_t kCommits = 2000000;
+
+std::string benchPath()
+{
+    return "/tmp/rbMappedBench_" + std::to_string(getpid()) + ".rb";
+}
+
+// one sample added and committed per operation, with and without batched msync
+BENCH_CASE(rb_mapped_commit)
+{
+    const std::string path = benchPath();
+    for (size_t syncEvery: {0, 100000})
+    {
+        unlink(path.c_str());
+        rb_mapped_t mrb;
+        rb_open_mapped(&mrb, path.c_str(), 4096, sizeof(uint8_t));
+        rb_mapped_set_sync(&mrb, syncEvery);
+
+        double seconds = bench::timeIt([&]() {
+            for (uint64_t i = 0; i < kCommits; ++i)
+            {
+                uint8_t val = i;
+                rb_push_overwrite(&mrb.rb, &val, NULL, NULL);
+                rb_mapped_commit(&mrb);
+            }
+        });
+        rep.add("rb_mapped_commit/sync_every/" + std::to_string(syncEvery), kCommits,
+                seconds);
+        rb_close_mapped(&mrb);
+    }
+    unlink(path.c_str());
+}
+
+// opening an existing file doesn't depend on the amount of history it holds
+BENCH_CASE(rb_mapped_open)
+{
+    const std::string path = benchPath();
+    const uint64_t    nOpens = 2000;
+    for (size_t cap = 1024; cap <= 16 * 1024 * 1024; cap *= 128)
+    {
+        unlink(path.c_str());
+        rb_mapped_t mrb;
+        rb_open_mapped(&mrb, path.c_str(), cap, sizeof(uint8_t));
+        for (size_t i = 0; i < cap; ++i)
+        {
+            uint8_t val = i;
+            rb_add(&mrb.rb, &val);
+        }
+        rb_close_mapped(&mrb);
+
+        double seconds = bench::timeIt([&]() {
+            for (uint64_t i = 0; i < nOpens; ++i)
+            {
+                rb_open_mapped(&mrb, path.c_str(), cap, sizeof(uint8_t));
+                bench::doNotOptimize(mrb.rb.head);
+                rb_close_mapped(&mrb);
+            }
+        });
+        rep.add("rb_mapped_open/" + std::to_string(cap), nOpens, seconds);
+    }
+    unlink(path.c_str());
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "bench.h"
+
+#include "rb_mpmc.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const uint64_t kTransfers = 4000000;
+const size_t   kCap       = 1024;
+
+// runs the given number of producers and consumers that move kTransfers values in total
+double runScaling(size_t nProducers, size_t nConsumers)
+{
+    static size_t buff[RB_MPMC_BUFF_SIZE(kCap, sizeof(uint64_t)) / sizeof(size_t)];
+    rb_mpmc_t     rb;
+    rb_mpmc_init(&rb, buff, sizeof(buff), sizeof(uint64_t));
+
+    std::atomic<uint64_t> consumed(0);
+    return bench::timeIt([&]() {
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < nProducers; ++p)
+        {
+            threads.emplace_back([&rb, p, nProducers]() {
+                for (uint64_t i = p; i < kTransfers; i += nProducers)
+                {
+                    while (rb_mpmc_try_push(&rb, &i) != RB_OK)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (size_t c = 0; c < nConsumers; ++c)
+        {
+            threads.emplace_back([&rb, &consumed]() {
+                uint64_t sum = 0;
+                while (consumed.load(std::memory_order_relaxed) < kTransfers)
+                {
+                    uint64_t val;
+                    if (rb_mpmc_try_pop(&rb, &val) == RB_OK)
+                    {
+                        sum += val;
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                bench::doNotOptimize(sum);
+            });
+        }
+        for (auto& thread: threads)
+        {
+            thread.join();
+        }
+    });
+}
+
+BENCH_CASE(rb_mpmc_scaling)
+{
+    const size_t maxThreads =
+        std::max<size_t>(std::thread::hardware_concurrency() / 2, 2);
+    for (size_t n = 1; n <= maxThreads; n *= 2)
+    {
+        double seconds = runScaling(n, n);
+        rep.add("rb_mpmc_scaling/" + std::to_string(n) + "p" + std::to_string(n) + "c",
+                kTransfers, seconds);
+    }
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "bench.h"
+
+#include "rb_shm.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+
+const uint64_t kTransfers = 5000000;
+
+// runs the given function in a child process that shares the anonymous rings
+template<typename Fn>
+pid_t forkChild(Fn fn)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        fn();
+        _exit(0);
+    }
+    return pid;
+}
+
+BENCH_CASE(rb_shm_two_process)
+{
+    rb_shm_t rb;
+    rb_shm_create(&rb, NULL, 1024, sizeof(uint64_t));
+
+    double seconds = bench::timeIt([&]() {
+        pid_t pid = forkChild([&]() {
+            uint64_t sum = 0;
+            for (uint64_t n = 0; n < kTransfers; ++n)
+            {
+                uint64_t val;
+                rb_shm_pop_wait(&rb, &val, -1);
+                sum += val;
+            }
+            bench::doNotOptimize(sum);
+        });
+
+        for (uint64_t i = 0; i < kTransfers; ++i)
+        {
+            rb_shm_push_wait(&rb, &i, -1);
+        }
+        waitpid(pid, NULL, 0);
+    });
+    rep.add("rb_shm_two_process/throughput", kTransfers, seconds);
+    rb_shm_close(&rb);
+}
+
+// one element bounces between the processes, an operation is one handoff
+BENCH_CASE(rb_shm_two_process_latency)
+{
+    const uint64_t nRoundTrips = kTransfers / 50;
+    rb_shm_t       ping;
+    rb_shm_t       pong;
+    rb_shm_create(&ping, NULL, 64, sizeof(uint64_t));
+    rb_shm_create(&pong, NULL, 64, sizeof(uint64_t));
+
+    double seconds = bench::timeIt([&]() {
+        pid_t pid = forkChild([&]() {
+            for (uint64_t n = 0; n < nRoundTrips; ++n)
+            {
+                uint64_t val;
+                rb_shm_pop_wait(&ping, &val, -1);
+                rb_shm_push_wait(&pong, &val, -1);
+            }
+        });
+
+        for (uint64_t i = 0; i < nRoundTrips; ++i)
+        {
+            uint64_t val;
+            rb_shm_push_wait(&ping, &i, -1);
+            rb_shm_pop_wait(&pong, &val, -1);
+        }
+        waitpid(pid, NULL, 0);
+    });
+    rep.add("rb_shm_two_process/handoff_latency", 2 * nRoundTrips, seconds);
+    rb_shm_close(&ping);
+    rb_shm_close(&pong);
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "bench.h"
+
+#include "ring_buffer.h"
+#include "rb_spsc.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+const uint64_t kTransfers = 10000000;
+const size_t   kCap       = 1024;
+
+// baseline: the plain ring buffer shared between two threads under one mutex
+BENCH_CASE(rb_add_mutex_cross_thread)
+{
+    static uint64_t buff[kCap + 1];
+    ring_buffer_t   rb;
+    rb_init(&rb, buff, sizeof(buff), sizeof(buff[0]));
+    std::mutex lock;
+
+    double seconds = bench::timeIt([&]() {
+        std::thread producer([&]() {
+            for (uint64_t i = 0; i < kTransfers;)
+            {
+                lock.lock();
+                rb_ret_t ret = rb_add(&rb, &i);
+                lock.unlock();
+                if (ret == RB_OK)
+                {
+                    i++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        uint64_t sum = 0;
+        for (uint64_t n = 0; n < kTransfers;)
+        {
+            rb_it_t  it;
+            uint64_t val;
+            lock.lock();
+            rb_init_read_it(&rb, &it);
+            rb_ret_t ret = rb_get_next_val(&it, &val);
+            if (ret == RB_OK)
+            {
+                rb_remove(&rb);
+            }
+            lock.unlock();
+
+            if (ret == RB_OK)
+            {
+                sum += val;
+                n++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        bench::doNotOptimize(sum);
+    });
+    rep.add("rb_add_mutex_cross_thread", kTransfers, seconds);
+}
+
+BENCH_CASE(rb_spsc_cross_thread)
+{
+    static uint64_t buff[kCap + 1];
+    rb_spsc_t       rb;
+    rb_spsc_init(&rb, buff, sizeof(buff), sizeof(buff[0]));
+
+    double seconds = bench::timeIt([&]() {
+        std::thread producer([&]() {
+            for (uint64_t i = 0; i < kTransfers;)
+            {
+                if (rb_spsc_push(&rb, &i) == RB_OK)
+                {
+                    i++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        uint64_t sum = 0;
+        for (uint64_t n = 0; n < kTransfers;)
+        {
+            uint64_t val;
+            if (rb_spsc_pop(&rb, &val) == RB_OK)
+            {
+                sum += val;
+                n++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        bench::doNotOptimize(sum);
+    });
+    rep.add("rb_spsc_cross_thread", kTransfers, seconds);
+}
+
+// two threads bounce one element through a pair of rings, an operation is one handoff
+BENCH_CASE(rb_spsc_handoff_latency)
+{
+    const uint64_t  nRoundTrips = kTransfers / 100;
+    static uint64_t pingBuff[kCap + 1];
+    static uint64_t pongBuff[kCap + 1];
+    rb_spsc_t       ping;
+    rb_spsc_t       pong;
+    rb_spsc_init(&ping, pingBuff, sizeof(pingBuff), sizeof(pingBuff[0]));
+    rb_spsc_init(&pong, pongBuff, sizeof(pongBuff), sizeof(pongBuff[0]));
+
+    double seconds = bench::timeIt([&]() {
+        std::thread echo([&]() {
+            for (uint64_t n = 0; n < nRoundTrips;)
+            {
+                uint64_t val;
+                if (rb_spsc_pop(&ping, &val) == RB_OK)
+                {
+                    while (rb_spsc_push(&pong, &val) != RB_OK)
+                    {
+                    }
+                    n++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        for (uint64_t i = 0; i < nRoundTrips; ++i)
+        {
+            uint64_t val;
+            rb_spsc_push(&ping, &i);
+            while (rb_spsc_pop(&pong, &val) != RB_OK)
+            {
+                std::this_thread::yield();
+            }
+        }
+        echo.join();
+    });
+    rep.add("rb_spsc_handoff_latency", 2 * nRoundTrips, seconds);
+}
+
+// the uncontended push pays only for a waiter flag check, compare with rb_spsc_push
+BENCH_CASE(rb_spsc_push_wait_uncontended)
+{
+    static uint64_t buff[kCap + 1];
+    rb_spsc_t       rb;
+    rb_spsc_init(&rb, buff, sizeof(buff), sizeof(buff[0]));
+
+    double seconds = bench::timeIt([&]() {
+        for (uint64_t i = 0; i < kTransfers; ++i)
+        {
+            uint64_t val;
+            rb_spsc_push_wait(&rb, &i, -1);
+            rb_spsc_pop(&rb, &val);
+            bench::doNotOptimize(val);
+        }
+    });
+    rep.add("rb_spsc_push_wait_uncontended", kTransfers, seconds);
+}
+
+// Time from a push to the return of the consumer's pop_wait. The producer pauses between
+// pushes, so the consumer spins out and parks, and the futex wake-up is measured.
+BENCH_CASE(rb_spsc_wake_latency)
+{
+    using clock = std::chrono::steady_clock;
+
+    const size_t    nSamples = 5000;
+    static uint64_t buff[kCap + 1];
+    rb_spsc_t       rb;
+    rb_spsc_init(&rb, buff, sizeof(buff), sizeof(buff[0]));
+
+    std::vector<double> samplesNs;
+    samplesNs.reserve(nSamples);
+    std::thread consumer([&]() {
+        for (size_t i = 0; i < nSamples; ++i)
+        {
+            uint64_t sent;
+            rb_spsc_pop_wait(&rb, &sent, -1);
+            const uint64_t now = clock::now().time_since_epoch().count();
+            samplesNs.push_back(
+                std::chrono::duration<double, std::nano>(clock::duration(now - sent))
+                    .count());
+        }
+    });
+
+    for (size_t i = 0; i < nSamples; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        const uint64_t sent = clock::now().time_since_epoch().count();
+        rb_spsc_push(&rb, &sent);
+    }
+    consumer.join();
+    rep.addPercentiles("rb_spsc_wake_latency", std::move(samplesNs));
+}
+
+} // namespace
\ No newline at end of file
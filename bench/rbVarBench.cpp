@@ -0,0 +1,81 @@
+#include "bench.h"
+
+#include "ring_buffer.h"
+#include "rb_var.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+const uint64_t kRecords  = 10000000;
+const size_t   kMaxLen   = 256;
+const size_t   kBuffSize = 64 * 1024;
+
+// mostly single heart rate samples, some ECG batches and a few long annotations
+std::vector<size_t> mixedLengths()
+{
+    std::vector<size_t> lens(1024);
+    for (size_t i = 0; i < lens.size(); ++i)
+    {
+        lens[i] = (i % 64 == 0) ? kMaxLen : ((i % 8 == 0) ? 64 : 1);
+    }
+    return lens;
+}
+
+// one operation is one record written and read back
+BENCH_CASE(rb_var_mixed_records)
+{
+    const std::vector<size_t> lens             = mixedLengths();
+    uint8_t                   payload[kMaxLen] = {};
+
+    // baseline: every record padded to the largest one in a fixed element ring
+    {
+        std::vector<char> buff(kBuffSize + kMaxLen);
+        ring_buffer_t     rb;
+        rb_init(&rb, buff.data(), buff.size(), kMaxLen);
+
+        uint8_t out[kMaxLen];
+        double  seconds = bench::timeIt([&]() {
+            for (uint64_t i = 0; i < kRecords; ++i)
+            {
+                payload[0] = (uint8_t)i;
+                rb_add(&rb, payload);
+                rb_it_t it;
+                rb_init_read_it(&rb, &it);
+                rb_get_next_val(&it, out);
+                rb_remove(&rb);
+                bench::doNotOptimize(out);
+            }
+        });
+        rep.add("rb_var_mixed_records/fixed_padded", kRecords, seconds);
+    }
+
+    {
+        std::vector<uint64_t> buff(kBuffSize / sizeof(uint64_t));
+        rb_var_t              rb;
+        rb_var_init(&rb, buff.data(), kBuffSize);
+
+        uint64_t sum     = 0;
+        double   seconds = bench::timeIt([&]() {
+            for (uint64_t i = 0; i < kRecords; ++i)
+            {
+                void* ptr;
+                rb_var_reserve(&rb, lens[i % lens.size()], &ptr);
+                memcpy(ptr, payload, lens[i % lens.size()]);
+                rb_var_commit(&rb, lens[i % lens.size()]);
+
+                const void* rec;
+                size_t      len;
+                rb_var_peek(&rb, &rec, &len);
+                sum += len + *(const uint8_t*)rec;
+                rb_var_release(&rb);
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add("rb_var_mixed_records/var", kRecords, seconds);
+    }
+}
+
+} // namespace
\ No newline at end of file
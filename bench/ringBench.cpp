@@ -0,0 +1,88 @@
+#include "bench.h"
+
+#include "ring_buffer.hpp"
+
+#include <cstring>
+
+namespace
+{
+
+const uint64_t kElements = 16000000;
+const size_t   kCap      = 1024;
+
+struct Sample
+{
+    uint32_t ts;
+    uint32_t hr;
+    uint64_t seq;
+};
+static_assert(sizeof(Sample) == 16, "");
+
+// runs the same workload through the generic C API and the typed ring: keeps a window
+// of elements, adds and removes one per step and walks the window every 64 steps
+template<typename T>
+void runCase(bench::Reporter& rep, const std::string& name)
+{
+    static rb::ring<T, kCap> ring;
+    ring_buffer_t*           rb = ring.c_handle();
+
+    auto make = [](uint64_t i) {
+        T val;
+        memset(&val, (int)i, sizeof(val));
+        return val;
+    };
+
+    ring.clear();
+    double seconds = bench::timeIt([&]() {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < kElements; ++i)
+        {
+            T val = make(i);
+            if (rb_is_full(rb))
+            {
+                rb_remove(rb);
+            }
+            rb_add(rb, &val);
+
+            if ((i & 63) == 0)
+            {
+                rb_it_t it;
+                T       out;
+                rb_init_read_it(rb, &it);
+                while (rb_get_next_val(&it, &out) == RB_OK)
+                {
+                    sum += *(const uint8_t*)&out;
+                }
+            }
+        }
+        bench::doNotOptimize(sum);
+    });
+    rep.add("ring/" + name + "/c_api", kElements, seconds);
+
+    ring.clear();
+    seconds = bench::timeIt([&]() {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < kElements; ++i)
+        {
+            ring.push_overwrite(make(i));
+
+            if ((i & 63) == 0)
+            {
+                for (const T& out: ring)
+                {
+                    sum += *(const uint8_t*)&out;
+                }
+            }
+        }
+        bench::doNotOptimize(sum);
+    });
+    rep.add("ring/" + name + "/template", kElements, seconds);
+}
+
+BENCH_CASE(ring)
+{
+    runCase<uint8_t>(rep, "u8");
+    runCase<Sample>(rep, "16B");
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include "bench.h"
+
+#include "ring_buffer.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const uint64_t kElements = 16000000;
+const size_t   kCap      = 8192;
+
+// moves kElements 1-byte samples through the given ring one call per element
+double runSingle(ring_buffer_t* rb)
+{
+    return bench::timeIt([&]() {
+        uint64_t sum = 0;
+        uint8_t  val = 0;
+        for (uint64_t i = 0; i < kElements; ++i)
+        {
+            rb_add(rb, &val);
+            val++;
+
+            rb_it_t it;
+            uint8_t out;
+            rb_init_read_it(rb, &it);
+            rb_get_next_val(&it, &out);
+            rb_remove(rb);
+            sum += out;
+        }
+        bench::doNotOptimize(sum);
+    });
+}
+
+BENCH_CASE(rb_add_single)
+{
+    static uint8_t buff[kCap + 1];
+    ring_buffer_t  rb;
+
+    rb_init(&rb, buff, sizeof(buff), sizeof(buff[0]));
+    rep.add("rb_add_single/u8", kElements, runSingle(&rb));
+
+    rb_init_pow2(&rb, buff, sizeof(buff), sizeof(buff[0]));
+    rep.add("rb_add_single/u8/pow2", kElements, runSingle(&rb));
+}
+
+// keeps the ring full and reads the whole window after each sample, like runGenerate
+BENCH_CASE(rb_window_walk)
+{
+    const uint64_t nSamples = kElements / 64;
+    const size_t   window   = 64;
+    static uint8_t buff[window + 1];
+    ring_buffer_t  rb;
+
+    for (int pow2 = 0; pow2 <= 1; ++pow2)
+    {
+        pow2 ? rb_init_pow2(&rb, buff, window * sizeof(buff[0]), sizeof(buff[0]))
+             : rb_init(&rb, buff, sizeof(buff), sizeof(buff[0]));
+
+        double seconds = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            uint8_t  val = 0;
+            for (uint64_t i = 0; i < nSamples; ++i)
+            {
+                if (rb_is_full(&rb))
+                {
+                    rb_remove(&rb);
+                }
+                rb_add(&rb, &val);
+                val++;
+
+                rb_it_t it;
+                uint8_t out;
+                rb_init_read_it(&rb, &it);
+                while (rb_get_next_val(&it, &out) == RB_OK)
+                {
+                    sum += out;
+                }
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add(pow2 ? "rb_window_walk/u8/pow2" : "rb_window_walk/u8", nSamples * window,
+                seconds);
+    }
+}
+
+// moves kElements 1-byte samples through the ring in batches of the given size
+BENCH_CASE(rb_add_n_batch)
+{
+    static uint8_t buff[kCap + 1];
+    ring_buffer_t  rb;
+    rb_init(&rb, buff, sizeof(buff), sizeof(buff[0]));
+
+    for (size_t batch = 1; batch <= 4096; batch *= 4)
+    {
+        std::vector<uint8_t> in(batch, 7);
+        std::vector<uint8_t> out(batch);
+
+        double seconds = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < kElements; i += batch)
+            {
+                rb_it_t it;
+                rb_add_n(&rb, in.data(), batch, NULL);
+                rb_init_read_it(&rb, &it);
+                rb_read_n(&it, out.data(), batch, NULL);
+                rb_remove_n(&rb, batch, NULL);
+                sum += out[0];
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add("rb_add_n_batch/u8/" + std::to_string(batch), kElements, seconds);
+    }
+}
+
+// Steady state of a full ring: every operation reads the oldest element, removes it and
+// adds a new one. The ring sizes are picked to fit in L1, in L2 and to only fit in DRAM.
+BENCH_CASE(rb_el_size)
+{
+    const size_t elSizes[] = {1, 8, 64, 256};
+    const struct
+    {
+        const char* name;
+        size_t      bytes;
+    } levels[] = {{"l1", 16 * 1024}, {"l2", 512 * 1024}, {"dram", 64 * 1024 * 1024}};
+
+    for (const auto& level: levels)
+    {
+        for (size_t elSize: elSizes)
+        {
+            const size_t      cap = level.bytes / elSize;
+            std::vector<char> buff((cap + 1) * elSize);
+            std::vector<char> val(elSize, 1);
+            std::vector<char> out(elSize);
+
+            ring_buffer_t rb;
+            rb_init(&rb, buff.data(), buff.size(), elSize);
+            while (rb_add(&rb, val.data()) == RB_OK)
+            {
+            }
+
+            // every element passes the ring at least twice
+            const uint64_t minOps  = kElements / 4;
+            const uint64_t nOps    = (2 * cap > minOps) ? (2 * cap) : minOps;
+            double         seconds = bench::timeIt([&]() {
+                uint64_t sum = 0;
+                for (uint64_t i = 0; i < nOps; ++i)
+                {
+                    rb_it_t it;
+                    rb_init_read_it(&rb, &it);
+                    rb_get_next_val(&it, out.data());
+                    rb_remove(&rb);
+                    val[0] = (char)i;
+                    rb_add(&rb, val.data());
+                    sum += out[0];
+                }
+                bench::doNotOptimize(sum);
+            });
+            rep.add("rb_el_size/" + std::string(level.name) + "/" +
+                        std::to_string(elSize) + "B",
+                    nOps, seconds);
+        }
+    }
+}
+
+// heart rate sample of a timestamped ring
+struct TsSample
+{
+    uint64_t ts;
+    uint8_t  hr;
+};
+
+// Averages the samples of the last window of a ring of one sample per millisecond, once
+// by walking the iterator from the tail and once by seeking the start of the window.
+BENCH_CASE(rb_time_window)
+{
+    const size_t   cap       = 1 << 20;
+    const uint64_t nQueries  = 2000;
+    const uint64_t windows[] = {30, 1000, 30000};
+
+    std::vector<TsSample> buff(cap + 1);
+    ring_buffer_t         rb;
+    rb_init_ts(&rb, buff.data(), buff.size() * sizeof(TsSample), sizeof(TsSample));
+    for (uint64_t t = 0; t < 2 * cap; ++t)
+    {
+        TsSample sample = {t, (uint8_t)t};
+        rb_push_overwrite(&rb, &sample, NULL, NULL);
+    }
+    const uint64_t now = 2 * cap;
+
+    for (uint64_t window: windows)
+    {
+        const std::string name = "rb_time_window/" + std::to_string(window) + "ms";
+
+        // the walk reads the whole ring, fewer queries keep the case short
+        double seconds = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            for (uint64_t q = 0; q < nQueries / 100; ++q)
+            {
+                rb_it_t  it;
+                TsSample sample;
+                rb_init_read_it(&rb, &it);
+                while (rb_get_next_val(&it, &sample) == RB_OK)
+                {
+                    sum += (sample.ts >= now - window) ? sample.hr : 0;
+                }
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add(name + "/walk", nQueries / 100, seconds);
+
+        seconds = bench::timeIt([&]() {
+            uint64_t sum = 0;
+            for (uint64_t q = 0; q < nQueries; ++q)
+            {
+                rb_range_t range;
+                TsSample   sample;
+                rb_seek_range(&rb, now - window, now, &range);
+                while (rb_range_next(&range, &sample) == RB_OK)
+                {
+                    sum += sample.hr;
+                }
+            }
+            bench::doNotOptimize(sum);
+        });
+        rep.add(name + "/seek", nQueries, seconds);
+    }
+}
+
+// Reads the newest and a middle element of a full ring of 1M samples, once by walking
+// the iterator from the tail and once by direct access.
+BENCH_CASE(rb_random_access)
+{
+    const size_t   cap      = 1 << 20;
+    const uint64_t nQueries = 1000000;
+
+    std::vector<uint32_t> buff(cap + 1);
+    ring_buffer_t         rb;
+    rb_init(&rb, buff.data(), buff.size() * sizeof(uint32_t), sizeof(uint32_t));
+    for (uint32_t i = 0; i < 2 * cap; ++i)
+    {
+        rb_push_overwrite(&rb, &i, NULL, NULL);
+    }
+
+    // the walk reads the whole ring, fewer queries keep the case short
+    double seconds = bench::timeIt([&]() {
+        uint64_t sum = 0;
+        for (uint64_t q = 0; q < nQueries / 10000; ++q)
+        {
+            rb_it_t  it;
+            uint32_t val  = 0;
+            uint32_t last = 0;
+            rb_init_read_it(&rb, &it);
+            while (rb_get_next_val(&it, &val) == RB_OK)
+            {
+                last = val;
+            }
+            sum += last;
+        }
+        bench::doNotOptimize(sum);
+    });
+    rep.add("rb_random_access/newest/walk", nQueries / 10000, seconds);
+
+    seconds = bench::timeIt([&]() {
+        uint64_t sum = 0;
+        for (uint64_t q = 0; q < nQueries; ++q)
+        {
+            void* ptr;
+            rb_peek_newest(&rb, &ptr);
+            sum += *(uint32_t*)ptr;
+        }
+        bench::doNotOptimize(sum);
+    });
+    rep.add("rb_random_access/newest/peek", nQueries, seconds);
+
+    seconds = bench::timeIt([&]() {
+        uint64_t sum = 0;
+        for (uint64_t q = 0; q < nQueries / 10000; ++q)
+        {
+            rb_it_t  it;
+            uint32_t val;
+            rb_init_read_it(&rb, &it);
+            for (size_t i = 0; i <= (q * 7919) % cap; ++i)
+            {
+                rb_get_next_val(&it, &val);
+            }
+            sum += val;
+        }
+        bench::doNotOptimize(sum);
+    });
+    rep.add("rb_random_access/at/walk", nQueries / 10000, seconds);
+
+    seconds = bench::timeIt([&]() {
+        uint64_t sum = 0;
+        for (uint64_t q = 0; q < nQueries; ++q)
+        {
+            void* ptr;
+            rb_at(&rb, (q * 7919) % cap, &ptr);
+            sum += *(uint32_t*)ptr;
+        }
+        bench::doNotOptimize(sum);
+    });
+    rep.add("rb_random_access/at/direct", nQueries, seconds);
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,149 @@
+#ifndef HR_ARCHIVE_H
+#define HR_ARCHIVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "rb_var.h"
+
+#include <stdint.h>
+
+/**
+ * @brief   Number of samples encoded in one block, a multiple of 8.
+ */
+#define HR_ARCHIVE_BLOCK_LEN 256u
+
+/**
+ * @brief   Encoding of the samples of a block.
+ */
+typedef enum hr_archive_mode
+{
+    HR_ARCHIVE_FOR = 0, // distance to the minimum of the block
+    HR_ARCHIVE_DELTA,   // zigzag encoded difference to the previous sample
+} hr_archive_mode_t;
+
+/**
+ * @brief   Header of an encoded block, followed by the samples packed with @p bits bits
+ *          each, 8 samples in @p bits bytes.
+ */
+typedef struct hr_archive_hdr
+{
+    uint8_t  first;
+    uint8_t  min;
+    uint8_t  max;
+    uint8_t  bits;
+    uint8_t  mode;
+    uint8_t  pad;
+    uint16_t count;
+} hr_archive_hdr_t;
+
+/**
+ * @brief   Archive of the heart rate history of one stream.
+ *
+ * @details Samples are collected in a block of HR_ARCHIVE_BLOCK_LEN raw samples. A full
+ *          block is encoded either frame-of-reference or as deltas, whichever needs
+ *          fewer bits, and stored as one record of a variable-length record ring
+ *          buffer. When the ring buffer is full, the oldest block is evicted as a whole
+ *          in O(1). Samples are addressed by their sequence number, the first sample
+ *          pushed has number 0.
+ * @note    Must be initialized first using @ref hr_archive_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct hr_archive
+{
+    rb_var_t blocks;
+    uint64_t first_seq;
+    uint64_t next_seq;
+    size_t   bytes;
+    size_t   pending_len;
+    uint8_t  pending[HR_ARCHIVE_BLOCK_LEN];
+} hr_archive_t;
+
+/**
+ * @brief   Returns the size of memory in bytes that should be passed to
+ *          @ref hr_archive_init() to keep at least the given number of samples, even if
+ *          they can't be compressed.
+ *
+ * @param samples   - Number of samples
+ * @return size_t   Required memory size in bytes
+ */
+size_t hr_archive_mem_size(size_t samples);
+
+/**
+ * @brief   Initializes an empty archive.
+ *
+ * @param ar        - Pointer to the archive structure
+ * @param mem       - Pointer to memory allocated by user
+ * @param mem_size  - Size of the given memory in bytes, see @ref hr_archive_mem_size()
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the memory can't hold a block
+ */
+rb_ret_t hr_archive_init(hr_archive_t* ar, void* mem, size_t mem_size);
+
+/**
+ * @brief   Appends samples to the archive, evicting the oldest blocks when it is full.
+ *
+ * @param ar        - Pointer to the archive structure
+ * @param samples   - Heart rates, oldest first
+ * @param n         - Number of heart rates
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Archive wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_archive_push(hr_archive_t* ar, const uint8_t* samples, size_t n);
+
+/**
+ * @brief   Decodes samples starting at the given sequence number. The blocks before it
+ *          are skipped by their headers only.
+ *
+ * @param ar        - Pointer to the archive structure
+ * @param from      - Sequence number of the first sample to read
+ * @param out       - Buffer by which the heart rates are written, oldest first
+ * @param n         - Maximal number of heart rates to read
+ * @param read      - Pointer by which the number of heart rates read is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Archive wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the sample was evicted
+ * @retval RB_EMPTY         - No samples from the given sequence number
+ */
+rb_ret_t hr_archive_read(const hr_archive_t* ar, uint64_t from, uint8_t* out, size_t n,
+                         size_t* read);
+
+/**
+ * @brief   Returns the sequence numbers of the oldest sample kept and of the next sample
+ *          to be pushed.
+ *
+ * @param ar        - Pointer to the archive structure
+ * @param oldest    - Pointer by which the sequence number of the oldest sample is written
+ * @param next      - Pointer by which the sequence number of the next sample is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Archive wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_archive_range(const hr_archive_t* ar, uint64_t* oldest, uint64_t* next);
+
+/**
+ * @brief   Returns the number of samples held in encoded blocks and the bytes of the ring
+ *          buffer they occupy, record headers included. Their ratio is the compression
+ *          ratio against raw samples.
+ *
+ * @param ar        - Pointer to the archive structure
+ * @param samples   - Pointer by which the number of encoded samples is written
+ * @param bytes     - Pointer by which the number of occupied bytes is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Archive wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_archive_usage(const hr_archive_t* ar, uint64_t* samples, size_t* bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -24,6 +24,100 @@ extern "C" {
  */
 uint8_t hr_ema_calc(ring_buffer_t* rb);
 
+/**
+ * @brief   One in the Q15 fixed-point format of @ref hr_ema_cfg_t.
+ */
+#define HR_EMA_Q15_ONE 32768u
+
+/**
+ * @brief   Converts the α coefficient to the Q15 fixed-point format, e.g. for a constant
+ *          initializer of @ref hr_ema_cfg_t.
+ */
+#define HR_EMA_ALPHA_Q15(alpha) ((uint16_t)((alpha) * HR_EMA_Q15_ONE + 0.5f))
+
+/**
+ * @brief   Configuration of the fixed-point EMA calculation.
+ *
+ * @details @p alpha is the α coefficient in Q15 format, i.e. α * 32768 in the range
+ *          0..@ref HR_EMA_Q15_ONE. Greater values are used as one.
+ */
+typedef struct hr_ema_cfg
+{
+    uint16_t alpha;
+} hr_ema_cfg_t;
+
+/**
+ * @brief   Calculates the simple exponential moving average (EMA) of heart rate like
+ *          @ref hr_ema_calc(), but with the α coefficient given at runtime and using
+ *          integer arithmetic only.
+ *
+ * @details The smoothed value is kept in Q16 format and every step is rounded to the
+ *          nearest Q16 value, the products are calculated in 64 bits. The result differs
+ *          from @ref hr_ema_calc() with the same α by at most 1.
+ *
+ * @param rb        Pointer to ring buffer with hear rate data
+ * @param cfg       Pointer to the configuration with the α coefficient
+ * @return uint8_t  Calculated average value, 0 if an argument is invalid
+ */
+uint8_t hr_ema_calc_fixed(ring_buffer_t* rb, const hr_ema_cfg_t* cfg);
+
+/**
+ * @brief   State of the incremental EMA calculation over the elements of a ring buffer.
+ *
+ * @details For the window x(0)..x(n-1), oldest first, the result of @ref hr_ema_calc()
+ *          can be written as:
+ *              s = sum + (1-α)^n * x(0),  sum = Σ α(1-α)^(n-1-k) * x(k)
+ *          The state keeps the sum and the weight of the oldest element, so that adding
+ *          a sample and removing the evicted one costs O(1). The sum is recalculated
+ *          from the ring buffer once per window length of pushes to bound floating point
+ *          drift.
+ * @note    Must be initialized first using @ref hr_ema_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct hr_ema_state
+{
+    ring_buffer_t* rb;
+    double         sum;
+    double         oldest_weight;
+    size_t         count;
+    size_t         pushes;
+} hr_ema_state_t;
+
+/**
+ * @brief   Initializes the incremental EMA calculation for the given ring buffer, the
+ *          elements already stored in the ring buffer are taken into account.
+ *
+ * @param state     - Pointer to the EMA state structure
+ * @param rb        - Pointer to ring buffer with hear rate data
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_ema_init(hr_ema_state_t* state, ring_buffer_t* rb);
+
+/**
+ * @brief   Updates the EMA after a new heart rate was added to the ring buffer and
+ *          returns the same value as @ref hr_ema_calc() would for the ring buffer.
+ *
+ * @details The sum is kept in double precision. When the result is close to a rounding
+ *          boundary, it is recalculated from the ring buffer in single precision like
+ *          @ref hr_ema_calc(), so both round the same way.
+ *
+ * @param state     - Pointer to the EMA state structure
+ * @param new_val   - Heart rate that was added to the ring buffer
+ * @param evicted   - Pointer to the heart rate that was removed from the ring buffer to
+ *                    make space for the new one, NULL if nothing was removed
+ * @param ema_out   - Pointer by which the calculated average value is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_EMPTY         - Ring buffer is empty, the new heart rate wasn't added
+ */
+rb_ret_t hr_ema_push(hr_ema_state_t* state, uint8_t new_val, const uint8_t* evicted,
+                     uint8_t* ema_out);
+
 #ifdef __cplusplus
 }
 #endif
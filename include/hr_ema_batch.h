@@ -0,0 +1,110 @@
+#ifndef HR_EMA_BATCH_H
+#define HR_EMA_BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hr_ema.h"
+
+/**
+ * @brief   Instruction set used by the batch EMA kernel.
+ */
+typedef enum hr_ema_isa
+{
+    HR_EMA_ISA_SCALAR = 0,
+    HR_EMA_ISA_SSE2,
+    HR_EMA_ISA_AVX2,
+} hr_ema_isa_t;
+
+/**
+ * @brief   Kernel that advances @p n channels of the batch EMA by one sample each.
+ */
+typedef void (*hr_ema_kernel_t)(float* sum, const uint8_t* samples,
+                                const uint8_t* evicted, const uint8_t* oldest,
+                                uint8_t* ema_out, size_t n, float evict_weight,
+                                float oldest_weight);
+
+/**
+ * @brief   Windowed EMA of heart rate for many channels at once.
+ *
+ * @details Every call of @ref hr_ema_batch_push() adds one sample to each channel, so all
+ *          channels share the position in the window. The history is kept time-major
+ *          (one row of all channels per sample) and the state in structure-of-arrays
+ *          form, so the kernel advances consecutive channels with SIMD instructions. The
+ *          calculation is the one of @ref hr_ema_push() in single precision, each step
+ *          scales the accumulated rounding error by (1-α) so it does not drift. Results
+ *          are identical for all instruction sets and may differ from
+ *          @ref hr_ema_calc() by at most 1 when the exact value is close to x.5.
+ * @note    Must be initialized first using @ref hr_ema_batch_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct hr_ema_batch
+{
+    uint8_t*        hist;
+    float*          sum;
+    size_t          channels;
+    size_t          stride;
+    size_t          window;
+    size_t          count;
+    size_t          head;
+    float           oldest_weight;
+    hr_ema_isa_t    isa;
+    hr_ema_kernel_t kernel;
+} hr_ema_batch_t;
+
+/**
+ * @brief   Returns the size of memory in bytes that should be passed to
+ *          @ref hr_ema_batch_init().
+ *
+ * @param channels  - Number of channels
+ * @param window    - Number of samples in the EMA window of each channel
+ * @return size_t   Required memory size in bytes
+ */
+size_t hr_ema_batch_mem_size(size_t channels, size_t window);
+
+/**
+ * @brief   Initializes the batch EMA calculation. The fastest instruction set supported
+ *          by the CPU is selected.
+ *
+ * @param batch     - Pointer to the batch EMA structure
+ * @param mem       - Pointer to memory allocated by user
+ * @param mem_size  - Size of the given memory in bytes, see @ref hr_ema_batch_mem_size()
+ * @param channels  - Number of channels
+ * @param window    - Number of samples in the EMA window of each channel
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_ema_batch_init(hr_ema_batch_t* batch, void* mem, size_t mem_size,
+                           size_t channels, size_t window);
+
+/**
+ * @brief   Selects the instruction set of the kernel.
+ *
+ * @param batch - Pointer to the batch EMA structure
+ * @param isa   - Instruction set to use
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Instruction set isn't supported by the CPU
+ */
+rb_ret_t hr_ema_batch_set_isa(hr_ema_batch_t* batch, hr_ema_isa_t isa);
+
+/**
+ * @brief   Adds one sample to every channel and calculates the EMA of each channel.
+ *
+ * @param batch     - Pointer to the batch EMA structure
+ * @param samples   - Array of one heart rate per channel
+ * @param ema_out   - Array by which one average value per channel is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Batch EMA structure wasn't initialized
+ */
+rb_ret_t hr_ema_batch_push(hr_ema_batch_t* batch, const uint8_t* samples,
+                           uint8_t* ema_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+#ifndef HR_FILTER_H
+#define HR_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hr_ema.h"
+
+/**
+ * @brief   Maximal number of stages of a filter pipeline.
+ */
+#define HR_FILTER_MAX_STAGES 8u
+
+/**
+ * @brief   Type of a filter stage.
+ */
+typedef enum hr_filter_type
+{
+    HR_FILTER_SMA = 0, // simple moving average, rounded to the nearest integer
+    HR_FILTER_EMA,     // windowed EMA of hr_ema_push()
+    HR_FILTER_MEDIAN,  // median, mean of the two middle values for even counts
+} hr_filter_type_t;
+
+/**
+ * @brief   Configuration of one filter stage.
+ */
+typedef struct hr_filter_cfg
+{
+    hr_filter_type_t type;
+    size_t           window;
+} hr_filter_cfg_t;
+
+/**
+ * @brief   Entry of the median heaps: the value and the slot of the sample in the
+ *          window.
+ */
+typedef struct hr_filter_node
+{
+    uint8_t  val;
+    uint32_t slot;
+} hr_filter_node_t;
+
+/**
+ * @brief   Sliding-window median of a filter stage.
+ *
+ * @details The lower half of the window is kept in a max-heap and the upper half in a
+ *          min-heap, the lower one has the same number of samples or one more. Every
+ *          sample occupies the slot of the sample it evicts, and @p pos maps the slots to
+ *          their position in the heaps, so the evicted sample is removed directly in
+ *          O(log w).
+ */
+typedef struct hr_filter_median
+{
+    hr_filter_node_t* lo;
+    hr_filter_node_t* hi;
+    uint32_t*         pos;
+    size_t            n_lo;
+    size_t            n_hi;
+    size_t            window;
+    size_t            next_slot;
+} hr_filter_median_t;
+
+/**
+ * @brief   Stage of a filter pipeline with the window of its input samples.
+ */
+typedef struct hr_filter_stage
+{
+    hr_filter_type_t   type;
+    ring_buffer_t      rb;
+    uint64_t           sum;
+    hr_ema_state_t     ema;
+    hr_filter_median_t median;
+    uint8_t            out;
+} hr_filter_stage_t;
+
+/**
+ * @brief   Pipeline of filter stages that smooths heart rate one sample at a time.
+ *
+ * @details Every stage keeps the window of its own input samples in a ring buffer and
+ *          is updated in constant (SMA, EMA) or logarithmic (median) time from the new
+ *          sample and the one evicted by @ref rb_push_overwrite(). The output of a stage
+ *          is passed on as the input sample of the next one, so the window is never
+ *          scanned again. The ring buffers and the median heaps are carved out of one
+ *          block of memory given by the user.
+ * @note    Must be initialized first using @ref hr_filter_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct hr_filter
+{
+    hr_filter_stage_t stages[HR_FILTER_MAX_STAGES];
+    size_t            n_stages;
+} hr_filter_t;
+
+/**
+ * @brief   Returns the size of memory in bytes that should be passed to
+ *          @ref hr_filter_init().
+ *
+ * @param cfg       - Configurations of the stages, first stage first
+ * @param n_stages  - Number of stages
+ * @return size_t   Required memory size in bytes
+ */
+size_t hr_filter_mem_size(const hr_filter_cfg_t* cfg, size_t n_stages);
+
+/**
+ * @brief   Initializes the filter pipeline with empty windows.
+ *
+ * @param filter    - Pointer to the filter structure
+ * @param mem       - Pointer to memory allocated by user
+ * @param mem_size  - Size of the given memory in bytes, see @ref hr_filter_mem_size()
+ * @param cfg       - Configurations of the stages, first stage first
+ * @param n_stages  - Number of stages, at most @ref HR_FILTER_MAX_STAGES
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_filter_init(hr_filter_t* filter, void* mem, size_t mem_size,
+                        const hr_filter_cfg_t* cfg, size_t n_stages);
+
+/**
+ * @brief   Passes a new heart rate through all stages of the pipeline.
+ *
+ * @param filter    - Pointer to the filter structure
+ * @param sample    - Heart rate
+ * @param out       - Pointer by which the output of the last stage is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Filter wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_filter_push(hr_filter_t* filter, uint8_t sample, uint8_t* out);
+
+/**
+ * @brief   Returns the output of the given stage after the last sample.
+ *
+ * @param filter    - Pointer to the filter structure
+ * @param stage     - Index of the stage
+ * @param out       - Pointer by which the output is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Filter wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_filter_stage_out(const hr_filter_t* filter, size_t stage, uint8_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
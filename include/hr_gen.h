@@ -5,16 +5,79 @@
 extern "C" {
 #endif
 
+#include "ring_buffer.h"
+
 #include <stdint.h>
 
 #define HR_GEN_MIN_HR 44u
 #define HR_GEN_MAX_HR 185u
 
+/**
+ * @brief   Number of independent xoshiro128** streams advanced side by side.
+ */
+#define HR_GEN_LANES 16u
+
+/**
+ * @brief   Heart rate generator.
+ *
+ * @details Every instance keeps its own state, so threads with their own generator don't
+ *          share anything. The state consists of HR_GEN_LANES xoshiro128** streams kept
+ *          in structure-of-arrays form, so one block of HR_GEN_LANES samples is generated
+ *          with vector instructions. Random numbers are mapped to the heart rate range
+ *          with Lemire's multiply-shift reduction, the rare biased results are rejected.
+ *          The sequence only depends on the seed, not on how it is read.
+ * @note    Must be initialized first using @ref hr_gen_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct hr_gen
+{
+    uint32_t s[4][HR_GEN_LANES];
+    uint8_t  block[HR_GEN_LANES];
+    size_t   left;
+} hr_gen_t;
+
+/**
+ * @brief   Initializes the generator. The same seed always produces the same sequence.
+ *
+ * @param gen   - Pointer to the generator
+ * @param seed  - Seed of the sequence
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_gen_init(hr_gen_t* gen, uint64_t seed);
+
 /**
  * @brief   Generates random heart rate within
  *          HR_GEN_MIN_HR <= res <= HR_GEN_MAX_HR
  *          diapason.
  *
+ * @param gen   - Pointer to the generator
+ * @return uint8_t Generated heart rate value.
+ */
+uint8_t hr_gen_next(hr_gen_t* gen);
+
+/**
+ * @brief   Fills the buffer with random heart rates, the same values are produced by
+ *          @p n calls of @ref hr_gen_next().
+ *
+ * @param gen   - Pointer to the generator
+ * @param out   - Buffer by which the heart rates are written
+ * @param n     - Number of heart rates to generate
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_gen_fill(hr_gen_t* gen, uint8_t* out, size_t n);
+
+/**
+ * @brief   Generates random heart rate within
+ *          HR_GEN_MIN_HR <= res <= HR_GEN_MAX_HR
+ *          diapason.
+ *
+ * @note    Uses a generator owned by the calling thread. Threads are seeded with
+ *          consecutive seeds in the order of their first call.
+ *
  * @return uint8_t Generated heart rate value.
  */
 uint8_t hr_gen_random();
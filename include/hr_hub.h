@@ -0,0 +1,162 @@
+#ifndef HR_HUB_H
+#define HR_HUB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hr_ema.h"
+#include "hr_gen.h"
+
+#include <pthread.h>
+
+/**
+ * @brief   Number of streams a worker claims at once.
+ */
+#define HR_HUB_CHUNK 64u
+
+/**
+ * @brief   Heart rate stream of the hub: samples of its own generator are added to its
+ *          ring buffer and the EMA is updated with each of them.
+ */
+typedef struct hr_hub_stream
+{
+    ring_buffer_t  rb;
+    hr_ema_state_t ema;
+    hr_gen_t       gen;
+    uint32_t       rate;
+    uint8_t        ema_val;
+} hr_hub_stream_t;
+
+/**
+ * @brief   Worker thread of the hub with its shard of streams.
+ */
+typedef struct hr_hub_worker
+{
+    // next unclaimed stream of the shard, claimed in chunks by the owner and thieves
+    struct
+    {
+        size_t next;
+        size_t end;
+    } RB_CACHE_ALIGNED shard;
+
+    struct hr_hub* hub;
+    pthread_t      thread;
+    uint64_t       samples;
+} hr_hub_worker_t;
+
+/**
+ * @brief   Engine that simulates and ingests many heart rate streams on a fixed pool of
+ *          worker threads.
+ *
+ * @details Streams, workers and the storage of all ring buffers are carved out of one
+ *          contiguous block of memory given by the user. The streams are split into one
+ *          contiguous shard per worker. In every round each worker claims chunks of
+ *          HR_HUB_CHUNK streams from the front of its own shard and, once it is done,
+ *          steals chunks from the shards of the other workers, so streams with higher
+ *          rates or a descheduled thread don't hold the round back. The thread calling
+ *          @ref hr_hub_run() works as the first worker.
+ * @note    Must be initialized first using @ref hr_hub_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct hr_hub
+{
+    hr_hub_stream_t* streams;
+    hr_hub_worker_t* workers;
+    size_t           n_streams;
+    size_t           n_threads;
+    uint32_t         ticks;
+    uint64_t         round;
+    size_t           busy;
+    bool             stop;
+    pthread_mutex_t  lock;
+    pthread_cond_t   start_cv;
+    pthread_cond_t   done_cv;
+} hr_hub_t;
+
+/**
+ * @brief   Returns the size of memory in bytes that should be passed to
+ *          @ref hr_hub_init().
+ *
+ * @param n_streams - Number of streams
+ * @param window    - Number of samples kept in the ring buffer of each stream
+ * @param n_threads - Number of worker threads
+ * @return size_t   Required memory size in bytes
+ */
+size_t hr_hub_mem_size(size_t n_streams, size_t window, size_t n_threads);
+
+/**
+ * @brief   Initializes the streams and starts the worker threads. Every stream adds one
+ *          sample per tick until changed by @ref hr_hub_set_rate().
+ *
+ * @param hub       - Pointer to the hub structure
+ * @param mem       - Pointer to memory allocated by user
+ * @param mem_size  - Size of the given memory in bytes, see @ref hr_hub_mem_size()
+ * @param n_streams - Number of streams
+ * @param window    - Number of samples kept in the ring buffer of each stream
+ * @param n_threads - Number of worker threads, including the calling one
+ * @param seed      - Seed of the generators, stream i uses seed + i
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_IO_ERROR      - Worker threads couldn't be started, see errno
+ */
+rb_ret_t hr_hub_init(hr_hub_t* hub, void* mem, size_t mem_size, size_t n_streams,
+                     size_t window, size_t n_threads, uint64_t seed);
+
+/**
+ * @brief   Sets the number of samples the stream adds per tick. Must not be called
+ *          while @ref hr_hub_run() is in progress.
+ *
+ * @param hub       - Pointer to the hub structure
+ * @param stream    - Index of the stream
+ * @param rate      - Number of samples per tick
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Hub wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_hub_set_rate(hr_hub_t* hub, size_t stream, uint32_t rate);
+
+/**
+ * @brief   Advances all streams by the given number of ticks using all worker threads
+ *          and returns when every stream is done.
+ *
+ * @param hub           - Pointer to the hub structure
+ * @param ticks         - Number of ticks
+ * @param samples_out   - Pointer by which the number of processed samples is written,
+ *                        may be NULL
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Hub wasn't initialized
+ */
+rb_ret_t hr_hub_run(hr_hub_t* hub, uint32_t ticks, uint64_t* samples_out);
+
+/**
+ * @brief   Returns the EMA of the stream after its last sample.
+ *
+ * @param hub       - Pointer to the hub structure
+ * @param stream    - Index of the stream
+ * @param ema_out   - Pointer by which the average value is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Hub wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_hub_ema(const hr_hub_t* hub, size_t stream, uint8_t* ema_out);
+
+/**
+ * @brief   Stops and joins the worker threads. The memory may be freed afterwards.
+ *
+ * @param hub   - Pointer to the hub structure
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Hub wasn't initialized
+ */
+rb_ret_t hr_hub_destroy(hr_hub_t* hub);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,146 @@
+#ifndef HR_ROLLUP_H
+#define HR_ROLLUP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buffer.h"
+
+#include <stdint.h>
+
+/**
+ * @brief   Maximal number of aggregate levels above the samples.
+ */
+#define HR_ROLLUP_MAX_LEVELS 4u
+
+/**
+ * @brief   Aggregate of consecutive heart rate samples.
+ */
+typedef struct hr_rollup_agg
+{
+    uint64_t sum;
+    uint32_t count;
+    uint8_t  min;
+    uint8_t  max;
+} hr_rollup_agg_t;
+
+/**
+ * @brief   Configuration of one aggregate level, e.g. {60, 1440} for the minutes of a day
+ *          above samples taken every second.
+ */
+typedef struct hr_rollup_cfg
+{
+    size_t span;  // buckets of the level below, or samples, aggregated into one bucket
+    size_t depth; // number of completed buckets kept
+} hr_rollup_cfg_t;
+
+/**
+ * @brief   Aggregate level with its completed buckets, oldest first.
+ */
+typedef struct hr_rollup_level
+{
+    ring_buffer_t   rb;
+    hr_rollup_agg_t cur;
+    uint64_t        width;
+} hr_rollup_level_t;
+
+/**
+ * @brief   Rollups of a heart rate stream at multiple resolutions, e.g. seconds, minutes
+ *          and hours.
+ *
+ * @details The samples are kept in a ring buffer and every level keeps a ring buffer of
+ *          aggregates of the level below. A bucket is completed from the buckets below
+ *          one at a time, so a sample costs O(1) amortized. A query over a range of
+ *          samples reads the completed buckets of the coarsest level that fall into it
+ *          and the partial ranges at both ends from the levels below. The ring buffers
+ *          are carved out of one block of memory given by the user.
+ * @note    Must be initialized first using @ref hr_rollup_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct hr_rollup
+{
+    ring_buffer_t     raw;
+    hr_rollup_level_t levels[HR_ROLLUP_MAX_LEVELS];
+    size_t            n_levels;
+    uint64_t          total;
+} hr_rollup_t;
+
+/**
+ * @brief   Returns the size of memory in bytes that should be passed to
+ *          @ref hr_rollup_init().
+ *
+ * @param raw_depth - Number of samples kept
+ * @param cfg       - Configurations of the levels, finest first
+ * @param n_levels  - Number of levels
+ * @return size_t   Required memory size in bytes
+ */
+size_t hr_rollup_mem_size(size_t raw_depth, const hr_rollup_cfg_t* cfg, size_t n_levels);
+
+/**
+ * @brief   Initializes empty rollups. The samples and every level must keep at least as
+ *          many entries as the span of the level above, so the bucket in progress is
+ *          always covered by the level below.
+ *
+ * @param rollup    - Pointer to the rollup structure
+ * @param mem       - Pointer to memory allocated by user
+ * @param mem_size  - Size of the given memory in bytes, see @ref hr_rollup_mem_size()
+ * @param raw_depth - Number of samples kept
+ * @param cfg       - Configurations of the levels, finest first, spans of at least 2
+ * @param n_levels  - Number of levels, at most @ref HR_ROLLUP_MAX_LEVELS
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_rollup_init(hr_rollup_t* rollup, void* mem, size_t mem_size, size_t raw_depth,
+                        const hr_rollup_cfg_t* cfg, size_t n_levels);
+
+/**
+ * @brief   Adds a new heart rate and completes the buckets it closes.
+ *
+ * @param rollup    - Pointer to the rollup structure
+ * @param sample    - Heart rate
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Rollups weren't initialized
+ */
+rb_ret_t hr_rollup_push(hr_rollup_t* rollup, uint8_t sample);
+
+/**
+ * @brief   Aggregates the samples in the range [@p from, @p to), the first sample pushed
+ *          has number 0.
+ *
+ * @details The bounds must still be kept at their resolution: either the samples around
+ *          them are still kept, or they fall on the bucket boundaries of a level that
+ *          still keeps the buckets around them.
+ *
+ * @param rollup    - Pointer to the rollup structure
+ * @param from      - Number of the first sample
+ * @param to        - Number of the sample after the last one
+ * @param agg       - Pointer by which the aggregate is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Rollups weren't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the range is no longer kept
+ */
+rb_ret_t hr_rollup_query(hr_rollup_t* rollup, uint64_t from, uint64_t to,
+                         hr_rollup_agg_t* agg);
+
+/**
+ * @brief   Aggregates the last @p n samples, see @ref hr_rollup_query().
+ *
+ * @param rollup    - Pointer to the rollup structure
+ * @param n         - Number of samples
+ * @param agg       - Pointer by which the aggregate is written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Rollups weren't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the range is no longer kept
+ */
+rb_ret_t hr_rollup_last(hr_rollup_t* rollup, uint64_t n, hr_rollup_agg_t* agg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,188 @@
+#ifndef HR_SINK_H
+#define HR_SINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "rb_spsc.h"
+
+#include <pthread.h>
+#include <stdint.h>
+
+/**
+ * @brief   Size of a record in the binary format: the sequence number, the stream, the
+ *          heart rate and the EMA, little-endian without padding.
+ */
+#define HR_SINK_BIN_REC_SIZE 14u
+
+/**
+ * @brief   Longest record in any format, the output buffer holds at least one.
+ */
+#define HR_SINK_MAX_REC_LEN 96u
+
+/**
+ * @brief   Output format of the records.
+ */
+typedef enum hr_sink_format
+{
+    HR_SINK_TEXT = 0, // "sample 12, stream 0: heart rate 75, EMA 73"
+    HR_SINK_CSV,      // "12,0,75,73" after the header line "seq,stream,hr,ema"
+    HR_SINK_BINARY,   // records of HR_SINK_BIN_REC_SIZE bytes
+} hr_sink_format_t;
+
+/**
+ * @brief   Result of one heart rate sample passed to the sink.
+ */
+typedef struct hr_sink_rec
+{
+    uint64_t seq;
+    uint32_t stream;
+    uint8_t  hr;
+    uint8_t  ema;
+} hr_sink_rec_t;
+
+/**
+ * @brief   Configuration of the sink.
+ */
+typedef struct hr_sink_cfg
+{
+    int              fd;         // file descriptor the records are written to
+    hr_sink_format_t format;     // output format
+    size_t           depth;      // number of records queued for the sink thread
+    size_t           batch_size; // size of the output buffer in bytes, written at once
+    uint32_t         flush_ms;   // longest time a record waits in the output buffer
+    int              wait_ms;    // time a push waits while the queue is full, -1 forever
+} hr_sink_cfg_t;
+
+/**
+ * @brief   Counters of the sink, see @ref hr_sink_stats().
+ */
+typedef struct hr_sink_stats
+{
+    uint64_t pushed;       // records queued
+    uint64_t full_waits;   // pushes that found the queue full and waited for space
+    uint64_t dropped;      // records dropped because the queue stayed full
+    uint64_t written;      // records written to the file descriptor
+    uint64_t writes;       // write system calls
+    uint64_t bytes;        // bytes written
+    uint64_t write_errors; // failed writes, the records of their batch are lost
+} hr_sink_stats_t;
+
+/**
+ * @brief   Output stage that formats heart rate records and writes them on its own
+ *          thread.
+ *
+ * @details The producer queues records in a single-producer/single-consumer ring buffer
+ *          and returns without a system call. The sink thread takes them in chunks with
+ *          @ref rb_spsc_pop_n(), formats them into the output buffer and writes the
+ *          buffer with one write() when it is full or when its oldest record has waited
+ *          for the flush interval. It parks in @ref rb_spsc_pop_wait() only while idle,
+ *          otherwise it sleeps between rounds so that a push doesn't have to wake it up.
+ *          When the sink falls behind, the producer waits for space up to the configured
+ *          time and then drops the record, both are counted. The queue and the output
+ *          buffer are carved out of one block of memory given by the user.
+ * @note    Must be initialized first using @ref hr_sink_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct hr_sink
+{
+    rb_spsc_t     rb;
+    hr_sink_cfg_t cfg;
+    char*         out;
+    size_t        out_len;
+    size_t        out_recs;
+    pthread_t     thread;
+    bool          stop;
+
+    // written by the producer only
+    struct
+    {
+        uint64_t pushed;
+        uint64_t full_waits;
+        uint64_t dropped;
+    } RB_CACHE_ALIGNED prod;
+
+    // written by the sink thread only
+    struct
+    {
+        uint64_t written;
+        uint64_t writes;
+        uint64_t bytes;
+        uint64_t write_errors;
+        uint64_t taken;
+    } RB_CACHE_ALIGNED cons;
+} hr_sink_t;
+
+/**
+ * @brief   Returns the size of memory in bytes that should be passed to
+ *          @ref hr_sink_init().
+ *
+ * @param depth         - Number of records queued for the sink thread
+ * @param batch_size    - Size of the output buffer in bytes
+ * @return size_t   Required memory size in bytes
+ */
+size_t hr_sink_mem_size(size_t depth, size_t batch_size);
+
+/**
+ * @brief   Initializes the sink and starts its thread. The CSV header is written first.
+ *
+ * @param sink      - Pointer to the sink structure
+ * @param mem       - Pointer to memory allocated by user
+ * @param mem_size  - Size of the given memory in bytes, see @ref hr_sink_mem_size()
+ * @param cfg       - Configuration, the output buffer must hold HR_SINK_MAX_REC_LEN bytes
+ *                    and the flush interval must not be 0
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_IO_ERROR      - Sink thread couldn't be started, see errno
+ */
+rb_ret_t hr_sink_init(hr_sink_t* sink, void* mem, size_t mem_size,
+                      const hr_sink_cfg_t* cfg);
+
+/**
+ * @brief   Queues a record for the sink thread. Must be called from one producer thread
+ *          only.
+ *
+ * @param sink  - Pointer to the sink structure
+ * @param rec   - Pointer to the record
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Sink wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_FULL          - Queue stayed full for the configured time, record dropped
+ */
+rb_ret_t hr_sink_push(hr_sink_t* sink, const hr_sink_rec_t* rec);
+
+/**
+ * @brief   Copies the counters of the sink. May be called from any thread, every counter
+ *          is read atomically but not all of them together.
+ *
+ * @param sink  - Pointer to the sink structure
+ * @param out   - Pointer by which the counters are written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Sink wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t hr_sink_stats(hr_sink_t* sink, hr_sink_stats_t* out);
+
+/**
+ * @brief   Writes all queued records, stops and joins the sink thread. Must be called
+ *          from the producer thread. A sink thread parked while idle is woken up at
+ *          once, a busy one notices the stop after its current sleep. The file
+ *          descriptor is not closed.
+ *
+ * @param sink  - Pointer to the sink structure
+ * @param stats - Pointer by which the final counters are written, may be NULL
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Sink wasn't initialized
+ */
+rb_ret_t hr_sink_destroy(hr_sink_t* sink, hr_sink_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,139 @@
+#ifndef RB_MAPPED_H
+#define RB_MAPPED_H
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RB_MAPPED_MAGIC   0x48524246U // "HRBF"
+#define RB_MAPPED_VERSION 1U
+
+/**
+ * @brief   Committed state of the ring buffer indices, protected by a checksum.
+ */
+typedef struct rb_mapped_slot
+{
+    uint64_t seq;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t checksum;
+} rb_mapped_slot_t;
+
+/**
+ * @brief   Header at the beginning of the file of a memory-mapped ring buffer.
+ *
+ * @details The layout fields are written once when the file is created and protected by
+ *          their own checksum. Head and tail are written alternately to one of the two
+ *          slots, the valid slot with the higher sequence number is the committed state,
+ *          so a commit interrupted by a crash leaves the previous one intact. The
+ *          elements follow the header at @p data_offset in the layout of
+ *          @ref rb_init().
+ */
+typedef struct rb_mapped_hdr
+{
+    uint32_t         magic;
+    uint32_t         version;
+    uint64_t         el_size;
+    uint64_t         cap;
+    uint64_t         data_offset;
+    uint64_t         checksum;
+    rb_mapped_slot_t slots[2];
+} rb_mapped_hdr_t;
+
+/**
+ * @brief   Ring buffer stored in a memory-mapped file that survives process restarts.
+ *
+ * @details @p rb is a regular ring buffer whose elements live in the file, so the whole
+ *          ring buffer API can be used on it. Changes of head and tail are only made
+ *          persistent by @ref rb_mapped_commit(). Written data is kept by the page cache
+ *          when the process crashes, with @ref rb_mapped_set_sync() it is also flushed
+ *          to the disk to survive a system crash.
+ * @note    Must be initialized first using @ref rb_open_mapped() fuction.
+ * @note    This structure should not be changed externally, except for the ring buffer
+ *          through the ring buffer API.
+ */
+typedef struct rb_mapped
+{
+    ring_buffer_t rb;
+    void*         map;
+    size_t        map_size;
+    int           fd;
+    uint64_t      seq;
+    size_t        sync_every;
+    size_t        unsynced;
+} rb_mapped_t;
+
+/**
+ * @brief   Creates the file of a memory-mapped ring buffer or attaches to an existing
+ *          one, restoring the last committed state. Takes constant time regardless of
+ *          the number of stored elements.
+ *
+ * @param mrb       - Pointer to the memory-mapped ring buffer structure
+ * @param path      - Path of the file
+ * @param cap       - Maximal number of elements, must match an existing file
+ * @param el_size   - Size of the single element in bytes, must match an existing file
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the existing file has another
+ *                            layout or isn't a ring buffer file
+ * @retval RB_IO_ERROR      - File couldn't be opened or mapped, see errno
+ */
+rb_ret_t rb_open_mapped(rb_mapped_t* mrb, const char* path, size_t cap, size_t el_size);
+
+/**
+ * @brief   Makes the current head and tail persistent. Elements written after the
+ *          previous commit are part of the ring after a restart only if they are
+ *          committed.
+ *
+ * @note    When more than one element is evicted between two commits, a crash may
+ *          restore newer elements in the slots of the overwritten ones.
+ *
+ * @param mrb   - Pointer to the memory-mapped ring buffer structure
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer wasn't opened
+ * @retval RB_IO_ERROR      - Flushing to the disk failed, see errno
+ */
+rb_ret_t rb_mapped_commit(rb_mapped_t* mrb);
+
+/**
+ * @brief   Sets how often committed data is flushed to the disk with msync.
+ *
+ * @param mrb           - Pointer to the memory-mapped ring buffer structure
+ * @param sync_every    - Number of commits between flushes, 0 leaves flushing to the
+ *                        system (the default)
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer wasn't opened
+ */
+rb_ret_t rb_mapped_set_sync(rb_mapped_t* mrb, size_t sync_every);
+
+/**
+ * @brief   Flushes committed data to the disk and waits for its completion.
+ *
+ * @param mrb   - Pointer to the memory-mapped ring buffer structure
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer wasn't opened
+ * @retval RB_IO_ERROR      - Flushing failed, see errno
+ */
+rb_ret_t rb_mapped_sync(rb_mapped_t* mrb);
+
+/**
+ * @brief   Commits the current state, unmaps and closes the file.
+ *
+ * @param mrb   - Pointer to the memory-mapped ring buffer structure
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer wasn't opened
+ * @retval RB_IO_ERROR      - Flushing failed, see errno. The file is closed anyway.
+ */
+rb_ret_t rb_close_mapped(rb_mapped_t* mrb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+#ifndef RB_MPMC_H
+#define RB_MPMC_H
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size in bytes of a single cell of the MPMC ring buffer: a sequence counter
+ *          followed by the element, padded to the alignment of the counter.
+ */
+#define RB_MPMC_CELL_SIZE(el_size)                                                       \
+    (sizeof(size_t) +                                                                    \
+     ((((el_size) + sizeof(size_t) - 1) / sizeof(size_t)) * sizeof(size_t)))
+
+/**
+ * @brief   Size in bytes of the buffer that should be passed to @ref rb_mpmc_init() to
+ *          hold @p cap elements of @p el_size bytes. The @p cap must be a power of two.
+ */
+#define RB_MPMC_BUFF_SIZE(cap, el_size) ((cap) * RB_MPMC_CELL_SIZE(el_size))
+
+/**
+ * @brief   Lock-free multi-producer/multi-consumer ring buffer.
+ *
+ * @details Every cell of the buffer carries a sequence number that tells whether the cell
+ *          is ready to be written or read for a given position. Producers only contend
+ *          on a compare-and-swap of the enqueue position and consumers only on the
+ *          dequeue position, the positions are kept on separate cache lines.
+ * @note    Must be initialized first using @ref rb_mpmc_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct rb_mpmc
+{
+    struct
+    {
+        size_t pos;
+    } RB_CACHE_ALIGNED enq;
+
+    struct
+    {
+        size_t pos;
+    } RB_CACHE_ALIGNED deq;
+
+    // read-only after initialization
+    struct
+    {
+        void*  buff;
+        size_t mask;
+        size_t el_size;
+        size_t cell_size;
+    } RB_CACHE_ALIGNED cfg;
+} rb_mpmc_t;
+
+/**
+ * @brief   Initializes a multi-producer/multi-consumer ring buffer.
+ *
+ * @note    Unlike @ref rb_init() all cells are usable, but the capacity is rounded down
+ *          to a power of two number of cells, see @ref RB_MPMC_BUFF_SIZE.
+ * @note    Must not be called while other threads access the ring buffer.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param buff      - Pointer to a buffer allocated by user, aligned to sizeof(size_t)
+ * @param buff_size - Size of the given buffer in bytes
+ * @param el_size   - Size of the single element in bytes
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t rb_mpmc_init(rb_mpmc_t* rb, void* buff, size_t buff_size, size_t el_size);
+
+/**
+ * @brief   Tries to add a new element to the buffer. Can be called from any thread.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param data  - Pointer to the data of the new item to be written
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ * @retval RB_FULL      - No free space to add a new element
+ */
+rb_ret_t rb_mpmc_try_push(rb_mpmc_t* rb, const void* data);
+
+/**
+ * @brief   Tries to read and remove the oldest element from the buffer. Can be called
+ *          from any thread.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param data_out  - Pointer by which the data should be written
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ * @retval RB_EMPTY     - No elements to read
+ */
+rb_ret_t rb_mpmc_try_pop(rb_mpmc_t* rb, void* data_out);
+
+/**
+ * @brief   Returns the number of elements the buffer can hold.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ *
+ * @return size_t Capacity of the buffer, 0 if not initialized
+ */
+size_t rb_mpmc_capacity(rb_mpmc_t* rb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,205 @@
+#ifndef RB_SHM_H
+#define RB_SHM_H
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RB_SHM_MAGIC   0x48525348U // "HRSH"
+#define RB_SHM_VERSION 1U
+
+/**
+ * @brief   Header at the beginning of the shared memory of an inter-process ring buffer.
+ *
+ * @details The header contains no pointers, the elements are found at @p data_offset
+ *          from its start, so processes may map the memory at different addresses. All
+ *          fields have fixed sizes. Head and tail are free-running counters masked with
+ *          the power of two capacity. The wait part is only written when a side goes to
+ *          sleep or wakes the other one up.
+ */
+typedef struct rb_shm_hdr
+{
+    struct
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t el_size;
+        uint64_t cap;
+        uint64_t data_offset;
+    } RB_CACHE_ALIGNED cfg;
+
+    // written by the producer only
+    struct
+    {
+        uint64_t head;
+    } RB_CACHE_ALIGNED prod;
+
+    // written by the consumer only
+    struct
+    {
+        uint64_t tail;
+    } RB_CACHE_ALIGNED cons;
+
+    struct
+    {
+        uint32_t data_seq;
+        uint32_t space_seq;
+        uint32_t cons_waiting;
+        uint32_t prod_waiting;
+    } RB_CACHE_ALIGNED wait;
+} rb_shm_hdr_t;
+
+/**
+ * @brief   Single-producer/single-consumer ring buffer in shared memory, used by one
+ *          producer and one consumer process (or thread).
+ *
+ * @details The structure is the process-local handle of the shared memory. Each side
+ *          keeps its cached copy of the other side's index in its own handle, so the
+ *          producer and the consumer must use different handles.
+ *          @ref rb_shm_pop_wait() and @ref rb_shm_push_wait() spin briefly and then
+ *          sleep on a futex in the shared memory, the other side only issues a wake-up
+ *          when a waiter has registered.
+ * @note    Must be initialized first using @ref rb_shm_create(), @ref rb_shm_attach()
+ *          or @ref rb_shm_attach_fd() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct rb_shm
+{
+    rb_shm_hdr_t* hdr;
+    char*         data;
+    size_t        map_size;
+    size_t        el_size;
+    size_t        mask;
+    uint64_t      head_cache;
+    uint64_t      tail_cache;
+    uint32_t      spin_limit;
+    int           fd;
+} rb_shm_t;
+
+/**
+ * @brief   Creates the shared memory of a ring buffer and maps it.
+ *
+ * @param rb        - Pointer to the ring buffer handle
+ * @param name      - POSIX shared memory name ("/name"), must not exist yet. If NULL an
+ *                    anonymous memfd is created, it is shared with child processes or
+ *                    by passing @ref rb_shm_fd() to another process.
+ * @param cap       - Capacity, rounded down to a power of two
+ * @param el_size   - Size of the single element in bytes
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_IO_ERROR      - Shared memory couldn't be created or mapped, see errno
+ */
+rb_ret_t rb_shm_create(rb_shm_t* rb, const char* name, size_t cap, size_t el_size);
+
+/**
+ * @brief   Maps the shared memory of an existing ring buffer by its name.
+ *
+ * @param rb    - Pointer to the ring buffer handle
+ * @param name  - POSIX shared memory name given to @ref rb_shm_create()
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the memory isn't a ring buffer
+ * @retval RB_IO_ERROR      - Shared memory couldn't be opened or mapped, see errno
+ */
+rb_ret_t rb_shm_attach(rb_shm_t* rb, const char* name);
+
+/**
+ * @brief   Maps the shared memory of an existing ring buffer by a file descriptor. The
+ *          descriptor is duplicated, the caller keeps the ownership of @p fd.
+ *
+ * @param rb    - Pointer to the ring buffer handle
+ * @param fd    - File descriptor of the shared memory
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the memory isn't a ring buffer
+ * @retval RB_IO_ERROR      - Shared memory couldn't be mapped, see errno
+ */
+rb_ret_t rb_shm_attach_fd(rb_shm_t* rb, int fd);
+
+/**
+ * @brief   Returns the file descriptor of the shared memory, -1 if not initialized.
+ */
+int rb_shm_fd(const rb_shm_t* rb);
+
+/**
+ * @brief   Unmaps the shared memory. The memory itself lives on while other processes
+ *          map it or, for named memory, until @ref rb_shm_unlink() is called.
+ *
+ * @param rb    - Pointer to the ring buffer handle
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer handle wasn't initialized
+ */
+rb_ret_t rb_shm_close(rb_shm_t* rb);
+
+/**
+ * @brief   Removes the name of the shared memory of a ring buffer.
+ *
+ * @param name  - POSIX shared memory name given to @ref rb_shm_create()
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_IO_ERROR      - Name couldn't be removed, see errno
+ */
+rb_ret_t rb_shm_unlink(const char* name);
+
+/**
+ * @brief   Adds a new element to the buffer. Must be called by the producer only.
+ *
+ * @param rb    - Pointer to the ring buffer handle
+ * @param data  - Pointer to the data of the new item to be written
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer handle wasn't initialized
+ * @retval RB_FULL      - No free space to add a new element
+ */
+rb_ret_t rb_shm_push(rb_shm_t* rb, const void* data);
+
+/**
+ * @brief   Reads and removes the oldest element from the buffer. Must be called by the
+ *          consumer only.
+ *
+ * @param rb        - Pointer to the ring buffer handle
+ * @param data_out  - Pointer by which the data should be written
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer handle wasn't initialized
+ * @retval RB_EMPTY     - No elements to read
+ */
+rb_ret_t rb_shm_pop(rb_shm_t* rb, void* data_out);
+
+/**
+ * @brief   Adds a new element to the buffer, sleeping while the buffer is full. Must be
+ *          called by the producer only.
+ *
+ * @param rb            - Pointer to the ring buffer handle
+ * @param data          - Pointer to the data of the new item to be written
+ * @param timeout_ms    - Maximal time to wait in milliseconds, -1 waits forever
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer handle wasn't initialized
+ * @retval RB_FULL      - Buffer stayed full until the timeout
+ */
+rb_ret_t rb_shm_push_wait(rb_shm_t* rb, const void* data, int timeout_ms);
+
+/**
+ * @brief   Reads and removes the oldest element from the buffer, sleeping while the
+ *          buffer is empty. Must be called by the consumer only.
+ *
+ * @param rb            - Pointer to the ring buffer handle
+ * @param data_out      - Pointer by which the data should be written
+ * @param timeout_ms    - Maximal time to wait in milliseconds, -1 waits forever
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer handle wasn't initialized
+ * @retval RB_EMPTY     - Buffer stayed empty until the timeout
+ */
+rb_ret_t rb_shm_pop_wait(rb_shm_t* rb, void* data_out, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,245 @@
+#ifndef RB_SPSC_H
+#define RB_SPSC_H
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Lock-free single-producer/single-consumer ring buffer.
+ *
+ * @details Exactly one thread may add elements and exactly one (possibly other) thread
+ *          may remove them. The producer owns the head index and the consumer owns the
+ *          tail index, both are published with release and observed with acquire
+ *          ordering. Each side keeps a cached copy of the other side's index and only
+ *          reloads it from the shared cache line when the cached value says that the
+ *          buffer is full (or empty). Statistics are kept in the part of the side that
+ *          updates them, so they add no shared cache line writes.
+ *          @ref rb_spsc_pop_wait() and @ref rb_spsc_push_wait() spin briefly and then
+ *          sleep on a futex. The other side only reads the waiter flag after publishing
+ *          its index and makes the wake-up system call when the flag is set.
+ * @note    Must be initialized first using @ref rb_spsc_init() or
+ *          @ref rb_spsc_init_overwrite() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct rb_spsc
+{
+    // written by the producer only
+    struct
+    {
+        size_t   head;
+        size_t   tail_cache;
+        uint32_t spin_limit;
+#ifdef RB_ENABLE_STATS
+        uint64_t pushes;
+        uint64_t full_rejects;
+        uint64_t overwrites;
+        size_t   high_water;
+#endif
+    } RB_CACHE_ALIGNED prod;
+
+    // written by the consumer only
+    struct
+    {
+        size_t   tail;
+        size_t   head_cache;
+        uint32_t spin_limit;
+#ifdef RB_ENABLE_STATS
+        uint64_t pops;
+        uint64_t empty_rejects;
+#endif
+    } RB_CACHE_ALIGNED cons;
+
+    // only written when a side goes to sleep or wakes the other one up
+    struct
+    {
+        uint32_t data_seq;
+        uint32_t space_seq;
+        uint32_t cons_waiting;
+        uint32_t prod_waiting;
+    } RB_CACHE_ALIGNED wait;
+
+    // read-only after initialization
+    struct
+    {
+        void*  buff;
+        size_t cap;
+        size_t el_size;
+        size_t mask;
+        bool   overwrite;
+    } RB_CACHE_ALIGNED cfg;
+} rb_spsc_t;
+
+/**
+ * @brief   Initializes a single-producer/single-consumer ring buffer.
+ *
+ * @note    As for @ref rb_init() the capacity of the ring buffer will always be one less
+ *          element than can fit in a given buffer.
+ * @note    Must not be called while other threads access the ring buffer.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param buff      - Pointer to a buffer allocated by user
+ * @param buff_size - Size of the given buffer in bytes
+ * @param el_size   - Size of the single element in bytes
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t rb_spsc_init(rb_spsc_t* rb, void* buff, size_t buff_size, size_t el_size);
+
+/**
+ * @brief   Initializes a single-producer/single-consumer ring buffer that allows the
+ *          producer to overwrite the oldest element with @ref rb_spsc_push_overwrite().
+ *
+ * @details The capacity is rounded down to a power of two number of elements and all of
+ *          them are used. Head and tail are free-running counters, and in this mode the
+ *          consumer takes an element with a compare-and-swap of the tail, so a pop that
+ *          races with an eviction retries with the next element instead of returning
+ *          overwritten data.
+ * @note    Must not be called while other threads access the ring buffer.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param buff      - Pointer to a buffer allocated by user
+ * @param buff_size - Size of the given buffer in bytes
+ * @param el_size   - Size of the single element in bytes
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t rb_spsc_init_overwrite(rb_spsc_t* rb, void* buff, size_t buff_size,
+                                size_t el_size);
+
+/**
+ * @brief   Adds a new element to the buffer. Must be called from the producer thread
+ *          only.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param data  - Pointer to the data of the new item to be written
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ * @retval RB_FULL      - No free space to add a new element
+ */
+rb_ret_t rb_spsc_push(rb_spsc_t* rb, const void* data);
+
+/**
+ * @brief   Adds a new element to the buffer, if the buffer is full the oldest element is
+ *          removed first. Must be called from the producer thread only.
+ *
+ * @note    Ring buffer must be initialized using @ref rb_spsc_init_overwrite().
+ *
+ * @param rb            - Pointer to the ring buffer structure
+ * @param data          - Pointer to the data of the new item to be written
+ * @param evicted_out   - Pointer by which the removed element is written, may be NULL.
+ *                        The content is only valid if an element was removed.
+ * @param evicted       - Pointer by which it is stored whether an element was removed,
+ *                        may be NULL
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Ring buffer wasn't initialized for overwriting
+ */
+rb_ret_t rb_spsc_push_overwrite(rb_spsc_t* rb, const void* data, void* evicted_out,
+                                bool* evicted);
+
+/**
+ * @brief   Reads and removes the oldest element from the buffer. Must be called from
+ *          the consumer thread only.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param data_out  - Pointer by which the data should be written
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ * @retval RB_EMPTY     - No elements to read
+ */
+rb_ret_t rb_spsc_pop(rb_spsc_t* rb, void* data_out);
+
+/**
+ * @brief   Reads and removes up to @p n oldest elements from the buffer. The elements are
+ *          copied with at most two memcpy calls and released to the producer at once.
+ *          Must be called from the consumer thread only.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param data_out  - Pointer to the array of at least @p n elements to be written
+ * @param n         - Number of elements to read
+ * @param popped    - Pointer by which the number of read elements is stored, may be NULL
+ *
+ * @retval RB_OK        - Operation success, at least one element was read or n is 0
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ * @retval RB_EMPTY     - No elements to read
+ */
+rb_ret_t rb_spsc_pop_n(rb_spsc_t* rb, void* data_out, size_t n, size_t* popped);
+
+/**
+ * @brief   Adds a new element to the buffer, waiting while the buffer is full. Must be
+ *          called from the producer thread only.
+ *
+ * @param rb            - Pointer to the ring buffer structure
+ * @param data          - Pointer to the data of the new item to be written
+ * @param timeout_ms    - Maximal time to wait in milliseconds, -1 waits forever and 0
+ *                        tries once
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ * @retval RB_FULL      - Buffer stayed full until the timeout
+ */
+rb_ret_t rb_spsc_push_wait(rb_spsc_t* rb, const void* data, int timeout_ms);
+
+/**
+ * @brief   Reads and removes the oldest element from the buffer, waiting while the
+ *          buffer is empty. Must be called from the consumer thread only.
+ *
+ * @param rb            - Pointer to the ring buffer structure
+ * @param data_out      - Pointer by which the data should be written
+ * @param timeout_ms    - Maximal time to wait in milliseconds, -1 waits forever and 0
+ *                        tries once
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ * @retval RB_EMPTY     - Buffer stayed empty until the timeout
+ */
+rb_ret_t rb_spsc_pop_wait(rb_spsc_t* rb, void* data_out, int timeout_ms);
+
+/**
+ * @brief   Checks if ring buffer is empty. The result is only a snapshot when called
+ *          from the producer thread.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ *
+ * @return true - Buffer is empty
+ * @return false - Buffer is not empty
+ */
+bool rb_spsc_is_empty(rb_spsc_t* rb);
+
+/**
+ * @brief   Checks if ring buffer is full. The result is only a snapshot when called
+ *          from the consumer thread.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ *
+ * @return true - Buffer is full
+ * @return false - Buffer is not full
+ */
+bool rb_spsc_is_full(rb_spsc_t* rb);
+
+/**
+ * @brief   Copies the usage statistics of the ring buffer. May be called from any
+ *          thread, the counters of each side are read atomically but not together.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param out   - Pointer by which the statistics are written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_UNSUPPORTED   - Library was built without RB_ENABLE_STATS
+ */
+rb_ret_t rb_spsc_stats_snapshot(rb_spsc_t* rb, rb_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
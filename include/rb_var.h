@@ -0,0 +1,185 @@
+#ifndef RB_VAR_H
+#define RB_VAR_H
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Alignment of the records, every payload starts at a multiple of it.
+ */
+#define RB_VAR_ALIGN 8U
+
+/**
+ * @brief   Size of the header stored in front of every record.
+ */
+#define RB_VAR_HDR_SIZE RB_VAR_ALIGN
+
+/**
+ * @brief   Ring buffer of variable-length records.
+ *
+ * @details Every record is a length header followed by the payload, padded to
+ *          RB_VAR_ALIGN. A record is never split at the end of the buffer: when it
+ *          doesn't fit into the space up to the end, a wrap marker is written there and
+ *          the record is placed at the start of the buffer, as in a bip-buffer. So each
+ *          record can be written and read in place with a single pointer and length.
+ * @note    Must be initialized first using @ref rb_var_init() fuction.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct rb_var
+{
+    char*  buff;
+    size_t size;
+    size_t head;
+    size_t tail;
+    size_t count;
+    size_t res_off;
+    size_t res_len;
+    bool   res_wrap;
+} rb_var_t;
+
+/**
+ * @brief   Iterator over the records of a variable-length record ring buffer, from the
+ *          oldest to the newest one.
+ * @note    This structure must be initialized first using @ref rb_var_init_read_it()
+ *          function. Records must not be removed while it is used.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct rb_var_it
+{
+    const rb_var_t* rb;
+    size_t          off;
+} rb_var_it_t;
+
+/**
+ * @brief   Initializes a variable-length record ring buffer.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param buff      - Pointer to a buffer allocated by user
+ * @param buff_size - Size of the given buffer in bytes, the part that is aligned to
+ *                    RB_VAR_ALIGN is used
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the buffer can't hold a record
+ */
+rb_ret_t rb_var_init(rb_var_t* rb, void* buff, size_t buff_size);
+
+/**
+ * @brief   Returns the largest payload size that a record of the ring buffer can have.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @return size_t   Largest payload size in bytes, 0 if not initialized
+ */
+size_t rb_var_max_len(const rb_var_t* rb);
+
+/**
+ * @brief   Reserves a contiguous region for a record of @p len bytes inside the buffer,
+ *          so that it can be written in place. A pending reservation is replaced.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param len   - Size of the payload in bytes
+ * @param ptr   - Pointer by which the address of the payload is stored
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the record is larger than
+ *                            @ref rb_var_max_len()
+ * @retval RB_FULL          - No contiguous free space for the record
+ */
+rb_ret_t rb_var_reserve(rb_var_t* rb, size_t len, void** ptr);
+
+/**
+ * @brief   Makes the record written to the region returned by @ref rb_var_reserve() part
+ *          of the buffer.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param len   - Size of the written payload, must not exceed the reserved size. 0
+ *                cancels the reservation.
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Nothing is reserved or the size exceeds the reservation
+ */
+rb_ret_t rb_var_commit(rb_var_t* rb, size_t len);
+
+/**
+ * @brief   Copies a record of @p len bytes into the buffer.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param data  - Pointer to the payload
+ * @param len   - Size of the payload in bytes
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided or the record is larger than
+ *                            @ref rb_var_max_len()
+ * @retval RB_FULL          - No contiguous free space for the record
+ */
+rb_ret_t rb_var_push(rb_var_t* rb, const void* data, size_t len);
+
+/**
+ * @brief   Returns the oldest record in place, without copying it.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param ptr   - Pointer by which the address of the payload is stored
+ * @param len   - Pointer by which the size of the payload is stored
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_EMPTY         - No records to read
+ */
+rb_ret_t rb_var_peek(rb_var_t* rb, const void** ptr, size_t* len);
+
+/**
+ * @brief   Removes the oldest record after it was processed in place.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_EMPTY         - No records to remove
+ */
+rb_ret_t rb_var_release(rb_var_t* rb);
+
+/**
+ * @brief   Initializes an iterator at the oldest record.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param it    - Pointer to the iterator structure
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t rb_var_init_read_it(const rb_var_t* rb, rb_var_it_t* it);
+
+/**
+ * @brief   Returns the next record of the iterator in place, without copying it.
+ *
+ * @param it    - Pointer to the iterator structure
+ * @param ptr   - Pointer by which the address of the payload is stored
+ * @param len   - Pointer by which the size of the payload is stored
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Iterator wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_EMPTY         - No more records to read
+ */
+rb_ret_t rb_var_next(rb_var_it_t* it, const void** ptr, size_t* len);
+
+/**
+ * @brief   Returns the number of records in the buffer.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @return size_t   Number of records
+ */
+size_t rb_var_count(const rb_var_t* rb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
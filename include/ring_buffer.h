@@ -16,22 +16,90 @@ extern "C" {
 #define RB_NOT_INIT    (RB_CODE_BASE + 2U)
 #define RB_FULL        (RB_CODE_BASE + 3U)
 #define RB_EMPTY       (RB_CODE_BASE + 4U)
+#define RB_UNSUPPORTED (RB_CODE_BASE + 5U)
+#define RB_IO_ERROR    (RB_CODE_BASE + 6U)
 
 typedef uint32_t rb_ret_t;
 
+/**
+ * @brief   Size of the cache line that is used to separate data written by different
+ *          threads in the concurrent ring buffer variants.
+ */
+#define RB_CACHE_LINE_SIZE 64
+
+#define RB_CACHE_ALIGNED __attribute__((aligned(RB_CACHE_LINE_SIZE)))
+
+/**
+ * @brief   Ring buffer flag: the capacity is a power of two and head/tail are
+ *          free-running counters, see @ref rb_init_pow2().
+ */
+#define RB_FLAG_POW2 (1U << 0)
+
+/**
+ * @brief   Ring buffer flag: every element starts with a timestamp and the elements are
+ *          sorted by it, see @ref rb_init_ts().
+ */
+#define RB_FLAG_TIMESTAMPED (1U << 1)
+
+/**
+ * @brief   Ring buffer flag: the memory of the elements is mapped twice back to back,
+ *          so every run of up to the capacity elements is contiguous, see
+ *          @ref RB_CREATE_MIRROR.
+ */
+#define RB_FLAG_MIRRORED (1U << 2)
+
+/**
+ * @brief   Options of @ref rb_create().
+ */
+#define RB_CREATE_POW2     (1U << 0) // power of two capacity, see rb_init_pow2()
+#define RB_CREATE_THP      (1U << 1) // align to huge pages and ask for transparent ones
+#define RB_CREATE_HUGETLB  (1U << 2) // explicit huge pages, they must be reserved
+#define RB_CREATE_PREFAULT (1U << 3) // touch all pages before returning
+#define RB_CREATE_MLOCK    (1U << 4) // lock the pages in memory
+#define RB_CREATE_MIRROR   (1U << 5) // map the memory twice, see RB_FLAG_MIRRORED
+
+/**
+ * @brief   Size of the huge pages used by @ref RB_CREATE_THP and @ref RB_CREATE_HUGETLB.
+ */
+#define RB_HUGE_PAGE_SIZE (2U << 20)
+
+/**
+ * @brief   Usage statistics of a ring buffer, see @ref rb_stats_snapshot().
+ *
+ * @details Statistics are only collected when the library is built with RB_ENABLE_STATS
+ *          defined (make STATS=1). The definition changes the layout of the ring buffer
+ *          structures, so it must be the same for the library and all its users.
+ */
+typedef struct rb_stats
+{
+    uint64_t pushes;        // elements added
+    uint64_t pops;          // elements removed by the reader
+    uint64_t full_rejects;  // add calls that couldn't store all elements
+    uint64_t empty_rejects; // remove calls that couldn't remove all requested elements
+    uint64_t overwrites;    // elements removed to make space for a new one
+    size_t   high_water;    // largest number of elements held at once
+} rb_stats_t;
+
 /**
  * @brief   Main ring buffer structure is used for for performing all kind of operations
  *          on buffer.
- * @note    Must be initialized first using @ref rb_init() fuction.
+ * @note    Must be initialized first using @ref rb_init() or @ref rb_init_pow2()
+ *          fuction.
  * @note    This structure should not be changed externally.
  */
 typedef struct ring_buffer
 {
-    void*  buff;
-    size_t cap;
-    size_t el_size;
-    size_t head;
-    size_t tail;
+    void*    buff;
+    size_t   cap;
+    size_t   el_size;
+    size_t   head;
+    size_t   tail;
+    size_t   mask;
+    size_t   map_size;
+    uint32_t flags;
+#ifdef RB_ENABLE_STATS
+    rb_stats_t stats;
+#endif
 } ring_buffer_t;
 
 /**
@@ -47,6 +115,18 @@ typedef struct rb_it
     size_t         idx;
 } rb_it_t;
 
+/**
+ * @brief   Iterator over the elements of a timestamped ring buffer within a time range.
+ * @note    This structure must be initialized first using @ref rb_seek_range()
+ *          function.
+ * @note    This structure should not be changed externally.
+ */
+typedef struct rb_range
+{
+    rb_it_t it;
+    size_t  left;
+} rb_range_t;
+
 /**
  * @brief   Initializes a ring buffer.
  *
@@ -63,6 +143,76 @@ typedef struct rb_it
  */
 rb_ret_t rb_init(ring_buffer_t* rb, void* buff, size_t buff_size, size_t el_size);
 
+/**
+ * @brief   Initializes a ring buffer with a power of two capacity.
+ *
+ * @details The capacity is the largest power of two number of elements that fits in the
+ *          given buffer, and all of them can be used. The head and tail are kept as
+ *          free-running counters that are only masked when the buffer is accessed, so
+ *          moving them never branches on the wrap and @ref rb_size() is a subtraction.
+ *          All other functions keep their semantics.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param buff      - Pointer to a buffer allocated by user
+ * @param buff_size - Size of the given buffer in bytes
+ * @param el_size   - Size of the single element in bytes
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t rb_init_pow2(ring_buffer_t* rb, void* buff, size_t buff_size, size_t el_size);
+
+/**
+ * @brief   Initializes a timestamped ring buffer as @ref rb_init() does.
+ *
+ * @details Every element starts with a uint64_t timestamp of a monotonic clock, the rest
+ *          of the element is the payload. The elements must be added in non-decreasing
+ *          timestamp order, so the buffer stays sorted from the oldest to the newest
+ *          element and @ref rb_seek_time() finds a time with a binary search.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param buff      - Pointer to a buffer allocated by user
+ * @param buff_size - Size of the given buffer in bytes
+ * @param el_size   - Size of the single element in bytes, including the timestamp
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t rb_init_ts(ring_buffer_t* rb, void* buff, size_t buff_size, size_t el_size);
+
+/**
+ * @brief   Allocates the memory of a ring buffer and initializes it.
+ *
+ * @details The memory is mapped from the system, so the elements start at a page (and
+ *          cache line) boundary. With @ref RB_CREATE_MIRROR the memory is a memfd mapped
+ *          twice back to back: the bulk functions, @ref rb_reserve_write() and
+ *          @ref rb_peek_read() then never split a run of elements at the end of the
+ *          buffer. The capacity is rounded up so that the end of the buffer falls on a
+ *          page boundary. @ref RB_CREATE_THP is only a hint, the buffer is created when
+ *          transparent huge pages aren't available.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param cap       - Minimal number of elements the buffer can hold
+ * @param el_size   - Size of the single element in bytes
+ * @param opts      - Combination of the RB_CREATE_* options, 0 for none
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_IO_ERROR      - Memory couldn't be mapped or locked, see errno
+ */
+rb_ret_t rb_create(ring_buffer_t* rb, size_t cap, size_t el_size, uint32_t opts);
+
+/**
+ * @brief   Unmaps the memory of a ring buffer created by @ref rb_create().
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Ring buffer wasn't created by @ref rb_create()
+ */
+rb_ret_t rb_destroy(ring_buffer_t* rb);
+
 /**
  * @brief   Adds a new element to the buffer.
  *
@@ -75,6 +225,23 @@ rb_ret_t rb_init(ring_buffer_t* rb, void* buff, size_t buff_size, size_t el_size
  */
 rb_ret_t rb_add(ring_buffer_t* rb, void* data);
 
+/**
+ * @brief   Adds a new element to the buffer, if the buffer is full the oldest element is
+ *          removed first. This replaces the @ref rb_is_full(), @ref rb_remove() and
+ *          @ref rb_add() sequence needed for sliding window behavior with one call.
+ *
+ * @param rb            - Pointer to the ring buffer structure
+ * @param data          - Pointer to the data of the new item to be written
+ * @param evicted_out   - Pointer by which the removed element is written, may be NULL
+ * @param evicted       - Pointer by which it is stored whether an element was removed,
+ *                        may be NULL
+ *
+ * @retval RB_OK        - Operation success
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ */
+rb_ret_t rb_push_overwrite(ring_buffer_t* rb, const void* data, void* evicted_out,
+                           bool* evicted);
+
 /**
  * @brief   Removes oldest element from the ring buffer.
  *
@@ -86,6 +253,100 @@ rb_ret_t rb_add(ring_buffer_t* rb, void* data);
  */
 rb_ret_t rb_remove(ring_buffer_t* rb);
 
+/**
+ * @brief   Adds up to @p n new elements to the buffer. The elements are copied with at
+ *          most two memcpy calls, before and after the end of the buffer.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param data  - Pointer to the array of @p n elements to be written
+ * @param n     - Number of elements to write
+ * @param added - Pointer by which the number of written elements is stored, may be NULL
+ *
+ * @retval RB_OK        - Operation success, at least one element was written or n is 0
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ * @retval RB_FULL      - No free space to add a new element
+ */
+rb_ret_t rb_add_n(ring_buffer_t* rb, const void* data, size_t n, size_t* added);
+
+/**
+ * @brief   Removes up to @p n oldest elements from the ring buffer in constant time.
+ *
+ * @param rb        - Pointer to the ring buffer structure
+ * @param n         - Number of elements to remove
+ * @param removed   - Pointer by which the number of removed elements is stored, may be
+ *                    NULL
+ *
+ * @retval RB_OK        - Operation success, at least one element was removed or n is 0
+ * @retval RB_NOT_INIT  - Ring buffer structure wasn't initialized
+ * @retval RB_EMPTY     - No elements to remove
+ */
+rb_ret_t rb_remove_n(ring_buffer_t* rb, size_t n, size_t* removed);
+
+/**
+ * @brief   Reserves space for up to @p n new elements directly inside the buffer, so that
+ *          they can be written in place without an intermediate copy.
+ *
+ * @details Only one contiguous region is returned at a time, so fewer than @p n elements
+ *          may be reserved when the free space wraps around the end of the buffer,
+ *          unless the buffer is mirrored. The elements become visible only after
+ *          @ref rb_commit_write() is called.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param n     - Number of elements to reserve
+ * @param ptr   - Pointer by which the address of the first reserved element is stored
+ * @param count - Pointer by which the number of reserved elements is stored
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_FULL          - No free space to add a new element
+ */
+rb_ret_t rb_reserve_write(ring_buffer_t* rb, size_t n, void** ptr, size_t* count);
+
+/**
+ * @brief   Makes @p count elements written to the region returned by
+ *          @ref rb_reserve_write() part of the buffer.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param count - Number of written elements, must not exceed the reserved count
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - More elements than can fit in the region are committed
+ */
+rb_ret_t rb_commit_write(ring_buffer_t* rb, size_t count);
+
+/**
+ * @brief   Returns the oldest elements as one contiguous region inside the buffer, so
+ *          that they can be processed in place without an intermediate copy.
+ *
+ * @details When the stored elements wrap around the end of the buffer only the part up to
+ *          the end is returned, the rest is returned after @ref rb_release_read(). A
+ *          mirrored buffer returns all elements.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param ptr   - Pointer by which the address of the oldest element is stored
+ * @param count - Pointer by which the number of elements in the region is stored
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_EMPTY         - No elements to read
+ */
+rb_ret_t rb_peek_read(ring_buffer_t* rb, void** ptr, size_t* count);
+
+/**
+ * @brief   Removes @p count oldest elements after they were processed in place.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param count - Number of processed elements, must not exceed the number of elements
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - More elements than stored are released
+ */
+rb_ret_t rb_release_read(ring_buffer_t* rb, size_t count);
+
 /**
  * @brief   Checks if ring buffer is full.
  *
@@ -96,6 +357,15 @@ rb_ret_t rb_remove(ring_buffer_t* rb);
  */
 bool rb_is_full(ring_buffer_t* rb);
 
+/**
+ * @brief   Returns the number of elements stored in the ring buffer.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ *
+ * @return size_t Number of stored elements
+ */
+size_t rb_size(ring_buffer_t* rb);
+
 /**
  * @brief   Checks if ring buffer is empty.
  *
@@ -106,6 +376,47 @@ bool rb_is_full(ring_buffer_t* rb);
  */
 bool rb_is_empty(ring_buffer_t* rb);
 
+/**
+ * @brief   Returns the element at the given position from the oldest one in place,
+ *          without copying it. Takes constant time.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param i     - Position of the element, 0 is the oldest one
+ * @param ptr   - Pointer by which the address of the element is stored
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided or @p i is not less than
+ *                            @ref rb_size()
+ */
+rb_ret_t rb_at(ring_buffer_t* rb, size_t i, void** ptr);
+
+/**
+ * @brief   Returns the oldest element in place, without copying it.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param ptr   - Pointer by which the address of the element is stored
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_EMPTY         - No elements to read
+ */
+rb_ret_t rb_peek_oldest(ring_buffer_t* rb, void** ptr);
+
+/**
+ * @brief   Returns the newest element in place, without copying it.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param ptr   - Pointer by which the address of the element is stored
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_EMPTY         - No elements to read
+ */
+rb_ret_t rb_peek_newest(ring_buffer_t* rb, void** ptr);
+
 /**
  * @brief   Initialize an iterator for reading values from oldest to newest.
  *
@@ -135,6 +446,121 @@ rb_ret_t rb_init_read_it(ring_buffer_t* rb, rb_it_t* it);
  */
 rb_ret_t rb_get_next_val(rb_it_t* it, void* data_out);
 
+/**
+ * @brief   Read up to @p n next values using read iterator. The elements are copied with
+ *          at most two memcpy calls, before and after the end of the buffer.
+ *
+ * @note    Iterator must be initialized using @ref rb_init_read_it() function.
+ *
+ * @param it        - Pointer to the iterator structure
+ * @param data_out  - Pointer to the array of at least @p n elements to be written
+ * @param n         - Number of elements to read
+ * @param read      - Pointer by which the number of read elements is stored, may be NULL
+ *
+ * @retval RB_OK            - Operation success, at least one element was read or n is 0
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_EMPTY         - No more values to read
+ */
+rb_ret_t rb_read_n(rb_it_t* it, void* data_out, size_t n, size_t* read);
+
+/**
+ * @brief   Initialize an iterator for reading values from newest to oldest.
+ *
+ * @details The initialized iterator will point to the head of the buffer, and it will be
+ *          decremented with each read operation using @ref rb_get_prev_val().
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param it    - Pointer to iterator structure
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ */
+rb_ret_t rb_init_reverse_it(ring_buffer_t* rb, rb_it_t* it);
+
+/**
+ * @brief   Read previous value using reverse iterator.
+ *
+ * @note    Iterator must be initialized using @ref rb_init_reverse_it() function.
+ *
+ * @param it        - Pointer to the iterator structure
+ * @param data_out  - Pointer by which the data should be written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_EMPTY         - No more values to read
+ */
+rb_ret_t rb_get_prev_val(rb_it_t* it, void* data_out);
+
+/**
+ * @brief   Initializes an iterator at the oldest element whose timestamp is not less than
+ *          @p t, so that reading from it returns the elements from that time on. Takes
+ *          O(log n) time.
+ *
+ * @note    Ring buffer must be initialized using @ref rb_init_ts().
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param t     - Timestamp to seek
+ * @param it    - Pointer to iterator structure
+ *
+ * @retval RB_OK            - Operation success, the iterator is at the head if all
+ *                            elements are older than @p t
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_UNSUPPORTED   - Ring buffer isn't timestamped
+ */
+rb_ret_t rb_seek_time(ring_buffer_t* rb, uint64_t t, rb_it_t* it);
+
+/**
+ * @brief   Initializes an iterator over the elements with timestamps within [t0, t1).
+ *          Takes O(log n) time, reading the k elements of the range O(k).
+ *
+ * @note    Ring buffer must be initialized using @ref rb_init_ts().
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param t0    - Timestamp of the range start, inclusive
+ * @param t1    - Timestamp of the range end, exclusive
+ * @param range - Pointer to range iterator structure
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_UNSUPPORTED   - Ring buffer isn't timestamped
+ */
+rb_ret_t rb_seek_range(ring_buffer_t* rb, uint64_t t0, uint64_t t1, rb_range_t* range);
+
+/**
+ * @brief   Reads the next element of the time range.
+ *
+ * @param range     - Pointer to the range iterator structure
+ * @param data_out  - Pointer by which the data should be written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_NOT_INIT      - Ring buffer structure wasn't initialized
+ * @retval RB_EMPTY         - No more elements in the range
+ */
+rb_ret_t rb_range_next(rb_range_t* range, void* data_out);
+
+/**
+ * @brief   Returns the number of elements of the time range that weren't read yet.
+ *
+ * @param range     - Pointer to the range iterator structure
+ * @return size_t   Number of elements
+ */
+size_t rb_range_left(const rb_range_t* range);
+
+/**
+ * @brief   Copies the usage statistics of the ring buffer.
+ *
+ * @param rb    - Pointer to the ring buffer structure
+ * @param out   - Pointer by which the statistics are written
+ *
+ * @retval RB_OK            - Operation success
+ * @retval RB_INVALID_ARG   - Invalid argument provided
+ * @retval RB_UNSUPPORTED   - Library was built without RB_ENABLE_STATS
+ */
+rb_ret_t rb_stats_snapshot(ring_buffer_t* rb, rb_stats_t* out);
+
 #ifdef __cplusplus
 }
 #endif
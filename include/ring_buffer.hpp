@@ -0,0 +1,336 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include "ring_buffer.h"
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rb
+{
+
+/**
+ * @brief   Ring buffer of @p N elements of type @p T with the storage embedded in the
+ *          object.
+ *
+ * @details The capacity is known at compile time, so every element access is a typed load
+ *          or store and the index wrap is a mask when @p N is a power of two or a compare
+ *          otherwise. Head and tail are kept in a @ref ring_buffer_t laid out the way
+ *          @ref rb_init() or @ref rb_init_pow2() does it, so for trivially copyable
+ *          elements @ref c_handle() gives the C API a view of the same ring.
+ *          Elements that aren't trivially copyable are constructed in place and moved
+ *          out, move-only types are supported.
+ * @note    The ring neither can be copied nor moved, the C view points into the object.
+ * @note    Statistics only count the operations done through the C API.
+ */
+template<typename T, size_t N>
+class ring
+{
+    static_assert(N > 0, "ring capacity must not be zero");
+
+public:
+
+    static constexpr bool   is_pow2 = (N & (N - 1)) == 0;
+    static constexpr size_t slots   = is_pow2 ? N : (N + 1);
+
+    class const_iterator;
+
+    ring()
+    {
+        m_rb.buff     = m_storage;
+        m_rb.cap      = slots;
+        m_rb.el_size  = sizeof(T);
+        m_rb.head     = 0;
+        m_rb.tail     = 0;
+        m_rb.mask     = is_pow2 ? (N - 1) : 0;
+        m_rb.map_size = 0;
+        m_rb.flags    = is_pow2 ? RB_FLAG_POW2 : 0;
+#ifdef RB_ENABLE_STATS
+        m_rb.stats = rb_stats_t();
+#endif
+    }
+
+    ~ring()
+    {
+        clear();
+    }
+
+    ring(const ring&)            = delete;
+    ring& operator=(const ring&) = delete;
+
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
+    size_t size() const
+    {
+        if (is_pow2 || (m_rb.head >= m_rb.tail))
+        {
+            return m_rb.head - m_rb.tail;
+        }
+        return slots - m_rb.tail + m_rb.head;
+    }
+
+    bool empty() const
+    {
+        return m_rb.head == m_rb.tail;
+    }
+
+    bool full() const
+    {
+        return size() == N;
+    }
+
+    /**
+     * @brief   Constructs an element at the head of the ring.
+     *
+     * @return  false if the ring is full, nothing is constructed in this case.
+     */
+    template<typename... Args>
+    bool emplace(Args&&... args)
+    {
+        if (full())
+        {
+            return false;
+        }
+
+        new (slot(m_rb.head)) T(std::forward<Args>(args)...);
+        m_rb.head = next(m_rb.head);
+        return true;
+    }
+
+    bool push(const T& val)
+    {
+        return emplace(val);
+    }
+
+    bool push(T&& val)
+    {
+        return emplace(std::move(val));
+    }
+
+    /**
+     * @brief   Adds an element, removing the oldest one when the ring is full.
+     *
+     * @return  true if the oldest element was removed.
+     */
+    bool push_overwrite(T val)
+    {
+        const bool evict = full();
+        if (evict)
+        {
+            pop();
+        }
+        emplace(std::move(val));
+        return evict;
+    }
+
+    /**
+     * @brief   Moves the oldest element out of the ring.
+     *
+     * @return  false if the ring is empty.
+     */
+    bool pop(T& out)
+    {
+        if (empty())
+        {
+            return false;
+        }
+
+        out = std::move(*slot(m_rb.tail));
+        return pop();
+    }
+
+    /**
+     * @brief   Removes the oldest element.
+     *
+     * @return  false if the ring is empty.
+     */
+    bool pop()
+    {
+        if (empty())
+        {
+            return false;
+        }
+
+        slot(m_rb.tail)->~T();
+        m_rb.tail = next(m_rb.tail);
+        return true;
+    }
+
+    void clear()
+    {
+        if (std::is_trivially_destructible<T>::value)
+        {
+            m_rb.tail = m_rb.head;
+            return;
+        }
+        while (pop())
+        {
+        }
+    }
+
+    /**
+     * @brief   Returns the oldest element, the ring must not be empty.
+     */
+    T& front()
+    {
+        return *slot(m_rb.tail);
+    }
+
+    const T& front() const
+    {
+        return *slot(m_rb.tail);
+    }
+
+    /**
+     * @brief   Returns the newest element, the ring must not be empty.
+     */
+    T& back()
+    {
+        return (*this)[size() - 1];
+    }
+
+    const T& back() const
+    {
+        return (*this)[size() - 1];
+    }
+
+    /**
+     * @brief   Returns the element at the given position from the oldest one.
+     */
+    T& operator[](size_t pos)
+    {
+        return *slot(offset(m_rb.tail, pos));
+    }
+
+    const T& operator[](size_t pos) const
+    {
+        return *slot(offset(m_rb.tail, pos));
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, size());
+    }
+
+    /**
+     * @brief   Returns the C view of the ring, any change done through it is seen by
+     *          the ring and vice versa.
+     */
+    ring_buffer_t* c_handle()
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "the C API copies elements with memcpy");
+        return &m_rb;
+    }
+
+    /**
+     * @brief   Forward iterator from the oldest to the newest element.
+     */
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const T*;
+        using reference         = const T&;
+
+        const_iterator() = default;
+
+        reference operator*() const
+        {
+            return (*m_ring)[m_pos];
+        }
+
+        pointer operator->() const
+        {
+            return &(*m_ring)[m_pos];
+        }
+
+        const_iterator& operator++()
+        {
+            m_pos++;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator prev = *this;
+            m_pos++;
+            return prev;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            return m_pos == other.m_pos;
+        }
+
+        bool operator!=(const const_iterator& other) const
+        {
+            return m_pos != other.m_pos;
+        }
+
+    private:
+
+        friend class ring;
+
+        const_iterator(const ring* r, size_t pos) : m_ring(r), m_pos(pos) {}
+
+        const ring* m_ring = nullptr;
+        size_t      m_pos  = 0;
+    };
+
+private:
+
+    // returns the index following the given one
+    static size_t next(size_t idx)
+    {
+        return offset(idx, 1);
+    }
+
+    // returns the index that is the given count of elements after the given one
+    static size_t offset(size_t idx, size_t count)
+    {
+        idx += count;
+        if (!is_pow2 && (idx >= slots))
+        {
+            idx -= slots;
+        }
+        return idx;
+    }
+
+    T* slot(size_t idx)
+    {
+        return std::launder(reinterpret_cast<T*>(m_storage) + (idx & mask()));
+    }
+
+    const T* slot(size_t idx) const
+    {
+        return std::launder(reinterpret_cast<const T*>(m_storage) + (idx & mask()));
+    }
+
+    // wrapped indices are always below the slot count, the mask is a no-op for them
+    static constexpr size_t mask()
+    {
+        return is_pow2 ? (N - 1) : ~size_t(0);
+    }
+
+    ring_buffer_t m_rb;
+    alignas(T) unsigned char m_storage[slots * sizeof(T)];
+};
+
+} // namespace rb
+
+#endif
\ No newline at end of file
@@ -1,12 +1,20 @@
 #include "ring_buffer.h"
 #include "hr_ema.h"
 #include "hr_gen.h"
+#include "hr_hub.h"
+#include "hr_sink.h"
+#include "rb_mapped.h"
 
+#include <chrono>
+#include <ctime>
 #include <iostream>
+#include <string>
 #include <thread>
+#include <vector>
 #include <exception>
 #include <stddef.h>
 #include <stdint.h>
+#include <unistd.h>
 
 namespace
 {
@@ -19,22 +27,91 @@ void handleRetCode(rb_ret_t code)
     }
 }
 
-int runGenerate(ring_buffer_t* rb)
+// The statistics go to stderr, stdout belongs to the sink.
+void printStats(ring_buffer_t* rb, hr_sink_t* sink)
 {
-    while (1)
+    rb_stats_t stats;
+    handleRetCode(rb_stats_snapshot(rb, &stats));
+
+    std::cerr << "Buffer stats: pushes " << stats.pushes << ", pops " << stats.pops
+              << ", full " << stats.full_rejects << ", empty " << stats.empty_rejects
+              << ", overwrites " << stats.overwrites << ", size " << rb_size(rb)
+              << ", high-water " << stats.high_water << std::endl;
+
+    hr_sink_stats_t sinkStats;
+    handleRetCode(hr_sink_stats(sink, &sinkStats));
+    std::cerr << "Sink stats: pushed " << sinkStats.pushed << ", full waits "
+              << sinkStats.full_waits << ", dropped " << sinkStats.dropped << ", written "
+              << sinkStats.written << ", writes " << sinkStats.writes << ", bytes "
+              << sinkStats.bytes << ", write errors " << sinkStats.write_errors
+              << std::endl;
+}
+
+int runGenerate(ring_buffer_t* rb, rb_mapped_t* history, hr_sink_t* sink,
+                size_t statsPeriod, size_t intervalMs)
+{
+    hr_ema_state_t emaState;
+    handleRetCode(hr_ema_init(&emaState, rb));
+
+    for (size_t n = 1;; ++n)
     {
         uint8_t val = hr_gen_random();
-        if (rb_is_full(rb) == true)
+        uint8_t oldVal;
+        bool    evicted;
+
+        // Add new value to buffer, replacing the oldest one, and update EMA
+        handleRetCode(rb_push_overwrite(rb, &val, &oldVal, &evicted));
+        if (history != NULL)
         {
-            handleRetCode(rb_remove(rb));
+            handleRetCode(rb_mapped_commit(history));
         }
+        uint8_t ema;
+        handleRetCode(hr_ema_push(&emaState, val, evicted ? &oldVal : NULL, &ema));
 
-        // Add new value to buffer and recalculate EMA
-        handleRetCode(rb_add(rb, &val));
-        uint8_t ema = hr_ema_calc(rb);
+        // Written in batches by the sink thread, see --format and --flush-ms
+        hr_sink_rec_t rec = {n - 1, 0, val, ema};
+        handleRetCode(hr_sink_push(sink, &rec));
+        if ((statsPeriod > 0) && (n % statsPeriod == 0))
+        {
+            printStats(rb, sink);
+        }
+        if (intervalMs > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        }
+    }
+}
+
+// Runs the streams of the hub as fast as possible and prints the aggregate rate once
+// per second.
+int runHub(size_t nStreams, size_t nThreads, size_t window)
+{
+    const uint32_t    ticksPerRun = 16;
+    hr_hub_t          hub;
+    std::vector<char> mem(hr_hub_mem_size(nStreams, window, nThreads));
+    handleRetCode(hr_hub_init(&hub, mem.data(), mem.size(), nStreams, window, nThreads,
+                              (uint64_t)time(NULL)));
 
-        std::cout << "EMA heart rate: " << std::to_string(ema) << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    uint64_t samples = 0;
+    auto     start   = std::chrono::steady_clock::now();
+    while (1)
+    {
+        uint64_t runSamples;
+        handleRetCode(hr_hub_run(&hub, ticksPerRun, &runSamples));
+        samples += runSamples;
+
+        const auto                          now     = std::chrono::steady_clock::now();
+        const std::chrono::duration<double> elapsed = now - start;
+        if (elapsed.count() >= 1.0)
+        {
+            uint8_t ema;
+            handleRetCode(hr_hub_ema(&hub, 0, &ema));
+            std::cout << "Hub: " << nStreams << " streams, " << nThreads << " threads, "
+                      << (uint64_t)(samples / elapsed.count()) << " samples/s, EMA of "
+                      << "stream 0: " << std::to_string(ema) << std::endl;
+            samples = 0;
+            start   = now;
+        }
     }
 }
 
@@ -42,32 +119,137 @@ int runGenerate(ring_buffer_t* rb)
 
 int main(int argc, char* argv[])
 {
-    size_t bufferCapacity = 10;
-    if (argc > 1)
+    size_t        bufferCapacity = 10;
+    size_t        statsPeriod    = 0;
+    const char*   historyPath    = NULL;
+    size_t        nStreams       = 0;
+    size_t        nThreads       = std::thread::hardware_concurrency();
+    size_t        intervalMs     = 1000;
+    hr_sink_cfg_t sinkCfg = {STDOUT_FILENO, HR_SINK_TEXT, 4096, 64 * 1024, 1000, -1};
+    for (int i = 1; i < argc; ++i)
     {
-        bufferCapacity = std::stoul(argv[1]);
+        if ((std::string(argv[i]) == "--stats") && (i + 1 < argc))
+        {
+            statsPeriod = std::stoul(argv[++i]);
+        }
+        else if ((std::string(argv[i]) == "--history") && (i + 1 < argc))
+        {
+            historyPath = argv[++i];
+        }
+        else if ((std::string(argv[i]) == "--streams") && (i + 1 < argc))
+        {
+            nStreams = std::stoul(argv[++i]);
+        }
+        else if ((std::string(argv[i]) == "--threads") && (i + 1 < argc))
+        {
+            nThreads = std::stoul(argv[++i]);
+        }
+        else if ((std::string(argv[i]) == "--interval") && (i + 1 < argc))
+        {
+            intervalMs = std::stoul(argv[++i]);
+        }
+        else if ((std::string(argv[i]) == "--flush-ms") && (i + 1 < argc))
+        {
+            sinkCfg.flush_ms = (uint32_t)std::stoul(argv[++i]);
+        }
+        else if ((std::string(argv[i]) == "--format") && (i + 1 < argc))
+        {
+            const std::string format = argv[++i];
+            if (format == "text")
+            {
+                sinkCfg.format = HR_SINK_TEXT;
+            }
+            else if (format == "csv")
+            {
+                sinkCfg.format = HR_SINK_CSV;
+            }
+            else if (format == "binary")
+            {
+                sinkCfg.format = HR_SINK_BINARY;
+            }
+            else
+            {
+                std::cerr << "Unknown format " << format
+                          << ", expected text, csv or binary" << std::endl;
+                return -1;
+            }
+        }
+        else
+        {
+            bufferCapacity = std::stoul(argv[i]);
+        }
     }
 
-    const size_t elSize     = sizeof(uint8_t);
-    const size_t bufferSize = (bufferCapacity + 1) * elSize;
-    char         buff[bufferSize];
+    // many streams, each with the buffer capacity as its window
+    if (nStreams > 0)
+    {
+        try
+        {
+            return runHub(nStreams, (nThreads > 0) ? nThreads : 1, bufferCapacity);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Exception thrown: " << e.what();
+            return -1;
+        }
+    }
 
-    ring_buffer_t rb;
-    rb_ret_t      ret = rb_init(&rb, buff, bufferSize, elSize);
+    const size_t elSize = sizeof(uint8_t);
+
+    // with a history file the samples of the previous runs are kept
+    ring_buffer_t  rb;
+    rb_mapped_t    history;
+    ring_buffer_t* pRb = &rb;
+    rb_ret_t       ret;
+    if (historyPath != NULL)
+    {
+        ret = rb_open_mapped(&history, historyPath, bufferCapacity, elSize);
+        pRb = &history.rb;
+    }
+    else
+    {
+        ret = rb_create(&rb, bufferCapacity, elSize, RB_CREATE_PREFAULT);
+    }
     if (ret != RB_OK)
     {
-        std::cout << "Failed to initialize ring buffer: " << ret << std::endl;
+        std::cerr << "Failed to initialize ring buffer: " << ret << std::endl;
+        return -1;
+    }
+
+    rb_stats_t stats;
+    if ((statsPeriod > 0) && (rb_stats_snapshot(pRb, &stats) == RB_UNSUPPORTED))
+    {
+        std::cerr << "Statistics are disabled, rebuild with make STATS=1" << std::endl;
         return -1;
     }
 
+    hr_sink_t         sink;
+    std::vector<char> sinkMem(hr_sink_mem_size(sinkCfg.depth, sinkCfg.batch_size));
+    if (hr_sink_init(&sink, sinkMem.data(), sinkMem.size(), &sinkCfg) != RB_OK)
+    {
+        std::cerr << "Failed to initialize output sink" << std::endl;
+        return -1;
+    }
+
+    int res = 0;
     try
     {
-        runGenerate(&rb);
+        runGenerate(pRb, (historyPath != NULL) ? &history : NULL, &sink, statsPeriod,
+                    intervalMs);
     }
     catch (const std::exception& e)
     {
-        std::cout << "Exception thrown: " << e.what();
-        return -1;
+        std::cerr << "Exception thrown: " << e.what();
+        res = -1;
+    }
+    hr_sink_destroy(&sink, NULL);
+    if (historyPath == NULL)
+    {
+        rb_destroy(&rb);
+    }
+    else
+    {
+        rb_close_mapped(&history);
     }
-    return 0;
+    return res;
 }
\ No newline at end of file
@@ -0,0 +1,390 @@
+#include "hr_archive.h"
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#define HR_ARCHIVE_SSE2
+#endif
+
+#define CHECK_IF_INIT(ar)                                                                \
+    if ((ar == NULL) || (ar->blocks.buff == NULL))                                       \
+    return RB_NOT_INIT
+
+// samples packed into one group of bits bytes
+#define GROUP_LEN 8u
+
+// lowest bit of every byte of a 64-bit word
+#define LANES_LO 0x0101010101010101ull
+
+// encoded size of a block with 8 bits per sample
+#define BLOCK_MAX_SIZE (sizeof(hr_archive_hdr_t) + HR_ARCHIVE_BLOCK_LEN)
+
+static_assert(HR_ARCHIVE_BLOCK_LEN % GROUP_LEN == 0, "blocks must hold whole groups");
+
+static inline size_t align_up(size_t val, size_t align)
+{
+    return (val + align - 1) / align * align;
+}
+
+// size of the record of the given length in the ring buffer
+static inline size_t rec_size(size_t len)
+{
+    return RB_VAR_HDR_SIZE + align_up(len, RB_VAR_ALIGN);
+}
+
+static inline size_t block_size(const hr_archive_hdr_t* hdr)
+{
+    return sizeof(hr_archive_hdr_t) + (hdr->count / GROUP_LEN * hdr->bits);
+}
+
+static inline uint8_t bit_width(uint8_t val)
+{
+    return (val == 0) ? 0 : (uint8_t)(32 - __builtin_clz(val));
+}
+
+// differences wrap around modulo 256, so a delta always fits into 8 bits
+static inline uint8_t zigzag(uint8_t cur, uint8_t prev)
+{
+    const int8_t delta = (int8_t)(uint8_t)(cur - prev);
+    return (uint8_t)((uint8_t)(delta * 2) ^ (uint8_t)(delta >> 7));
+}
+
+static inline uint8_t unzigzag(uint8_t val)
+{
+    return (uint8_t)((val >> 1) ^ (uint8_t)(-(val & 1)));
+}
+
+// chooses the encoding with fewer bits per sample, frame-of-reference on a tie
+static void analyze(const uint8_t* samples, size_t n, hr_archive_hdr_t* hdr)
+{
+    uint8_t min    = samples[0];
+    uint8_t max    = samples[0];
+    uint8_t deltas = 0;
+    for (size_t i = 1; i < n; ++i)
+    {
+        min = (samples[i] < min) ? samples[i] : min;
+        max = (samples[i] > max) ? samples[i] : max;
+        deltas |= zigzag(samples[i], samples[i - 1]);
+    }
+
+    const uint8_t forBits   = bit_width((uint8_t)(max - min));
+    const uint8_t deltaBits = bit_width(deltas);
+
+    hr_archive_hdr_t res = {};
+    res.first            = samples[0];
+    res.min              = min;
+    res.max              = max;
+    res.mode             = (deltaBits < forBits) ? HR_ARCHIVE_DELTA : HR_ARCHIVE_FOR;
+    res.bits             = (res.mode == HR_ARCHIVE_DELTA) ? deltaBits : forBits;
+    res.count            = (uint16_t)n;
+    (*hdr)               = res;
+}
+
+// packs the values of 8 samples into one little-endian word of bits bytes
+static void pack(const hr_archive_hdr_t* hdr, const uint8_t* samples, uint8_t* out)
+{
+    const unsigned bits = hdr->bits;
+    if (bits == 0)
+    {
+        return;
+    }
+
+    const bool delta = hdr->mode == HR_ARCHIVE_DELTA;
+    uint8_t    prev  = hdr->first;
+    for (size_t g = 0; g < hdr->count; g += GROUP_LEN)
+    {
+        uint64_t word = 0;
+        for (unsigned j = 0; j < GROUP_LEN; ++j)
+        {
+            const uint8_t cur = samples[g + j];
+            const uint8_t val = delta ? zigzag(cur, prev) : (uint8_t)(cur - hdr->min);
+            word |= (uint64_t)val << (j * bits);
+            prev = cur;
+        }
+        for (unsigned k = 0; k < bits; ++k)
+        {
+            (*out++) = (uint8_t)(word >> (8 * k));
+        }
+    }
+}
+
+// Unpacks the groups of 8 values at once: the values are spread from one 64-bit word
+// into the 8 bytes of another one, the base is added to all bytes and the word is stored
+// at once. It is inlined with a constant width for every case of decode(), so the shifts
+// and masks are constants and the loops over the bytes of a group are unrolled.
+static inline __attribute__((always_inline)) void
+unpack_groups(const uint8_t* in, uint8_t* out, size_t count, uint8_t base,
+              const unsigned bits)
+{
+    const uint64_t mask  = (1u << bits) - 1;
+    const uint64_t bases = base * LANES_LO;
+    for (size_t g = 0; g < count; g += GROUP_LEN)
+    {
+        // combined into wide loads, a copy to a local word would stall store forwarding
+        uint64_t word = 0;
+#pragma GCC unroll 8
+        for (unsigned k = 0; k < bits; ++k)
+        {
+            word |= (uint64_t)in[k] << (8 * k);
+        }
+        in += bits;
+
+        uint64_t vals = 0;
+#pragma GCC unroll 8
+        for (unsigned j = 0; j < GROUP_LEN; ++j)
+        {
+            vals |= ((word >> (j * bits)) & mask) << (8 * j);
+        }
+
+        // the values and the base don't overflow the bytes
+        vals += bases;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        vals = __builtin_bswap64(vals);
+#endif
+        memcpy(out + g, &vals, sizeof(vals));
+    }
+}
+
+static void unpack(const uint8_t* in, uint8_t* out, size_t count, uint8_t base,
+                   unsigned bits)
+{
+    switch (bits)
+    {
+        case 0: memset(out, base, count); break;
+        case 1: unpack_groups(in, out, count, base, 1); break;
+        case 2: unpack_groups(in, out, count, base, 2); break;
+        case 3: unpack_groups(in, out, count, base, 3); break;
+        case 4: unpack_groups(in, out, count, base, 4); break;
+        case 5: unpack_groups(in, out, count, base, 5); break;
+        case 6: unpack_groups(in, out, count, base, 6); break;
+        case 7: unpack_groups(in, out, count, base, 7); break;
+        default: unpack_groups(in, out, count, base, 8); break;
+    }
+}
+
+// Turns zigzag encoded deltas into samples in place, starting from the given one. The
+// vector version computes the prefix sum of 16 bytes in four shifted additions.
+static void prefix_sum(uint8_t* vals, size_t count, uint8_t first)
+{
+    uint8_t prev = first;
+    size_t  i    = 0;
+#ifdef HR_ARCHIVE_SSE2
+    const __m128i one  = _mm_set1_epi8(1);
+    const __m128i low7 = _mm_set1_epi8(0x7F);
+    __m128i       base = _mm_set1_epi8((char)first);
+    for (; i + 16 <= count; i += 16)
+    {
+        // zigzag decoded as (v >> 1) ^ -(v & 1), the shift by 16 bits is masked to bytes
+        const __m128i zz   = _mm_loadu_si128((const __m128i*)(vals + i));
+        const __m128i half = _mm_and_si128(_mm_srli_epi16(zz, 1), low7);
+        const __m128i sign = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(zz, one));
+        __m128i       v    = _mm_xor_si128(half, sign);
+        v                  = _mm_add_epi8(v, _mm_slli_si128(v, 1));
+        v                  = _mm_add_epi8(v, _mm_slli_si128(v, 2));
+        v                  = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+        v                  = _mm_add_epi8(v, _mm_slli_si128(v, 8));
+        v                  = _mm_add_epi8(v, base);
+        _mm_storeu_si128((__m128i*)(vals + i), v);
+
+        // the last sample is broadcast as the base of the next vector
+        const __m128i hi = _mm_shufflehi_epi16(_mm_unpackhi_epi8(v, v), 0xFF);
+        base             = _mm_unpackhi_epi64(hi, hi);
+    }
+    prev = (i > 0) ? vals[i - 1] : first;
+#endif
+    for (; i < count; ++i)
+    {
+        prev    = (uint8_t)(prev + unzigzag(vals[i]));
+        vals[i] = prev;
+    }
+}
+
+// decodes all samples of the block
+static void decode(const hr_archive_hdr_t* hdr, uint8_t* out)
+{
+    const bool delta = hdr->mode == HR_ARCHIVE_DELTA;
+    unpack((const uint8_t*)(hdr + 1), out, hdr->count, delta ? 0 : hdr->min, hdr->bits);
+    if (delta)
+    {
+        prefix_sum(out, hdr->count, hdr->first);
+    }
+}
+
+// removes the oldest block in O(1), the number of samples is taken from its header
+static void evict(hr_archive_t* ar)
+{
+    const void* ptr;
+    size_t      len;
+    rb_var_peek(&ar->blocks, &ptr, &len);
+    ar->first_seq += ((const hr_archive_hdr_t*)ptr)->count;
+    ar->bytes -= rec_size(len);
+    rb_var_release(&ar->blocks);
+}
+
+// encodes the pending samples as a new block in place
+static void flush(hr_archive_t* ar)
+{
+    hr_archive_hdr_t hdr;
+    analyze(ar->pending, ar->pending_len, &hdr);
+
+    const size_t len = block_size(&hdr);
+    void*        ptr;
+    while (rb_var_reserve(&ar->blocks, len, &ptr) == RB_FULL)
+    {
+        evict(ar);
+    }
+    memcpy(ptr, &hdr, sizeof(hdr));
+    pack(&hdr, ar->pending, (uint8_t*)ptr + sizeof(hdr));
+    rb_var_commit(&ar->blocks, len);
+
+    ar->bytes += rec_size(len);
+    ar->pending_len = 0;
+}
+
+size_t hr_archive_mem_size(size_t samples)
+{
+    // The blocks are never split, so up to one block is lost at the end of the ring
+    // buffer and one record alignment separates the newest block from the oldest one.
+    const size_t nBlocks = (samples + HR_ARCHIVE_BLOCK_LEN - 1) / HR_ARCHIVE_BLOCK_LEN;
+    return ((nBlocks + 1) * rec_size(BLOCK_MAX_SIZE)) + (2 * RB_VAR_ALIGN);
+}
+
+rb_ret_t hr_archive_init(hr_archive_t* ar, void* mem, size_t mem_size)
+{
+    if ((ar == NULL) || (mem == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    rb_ret_t ret = rb_var_init(&ar->blocks, mem, mem_size);
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+    if (rb_var_max_len(&ar->blocks) < BLOCK_MAX_SIZE)
+    {
+        ar->blocks.buff = NULL;
+        return RB_INVALID_ARG;
+    }
+
+    ar->first_seq   = 0;
+    ar->next_seq    = 0;
+    ar->bytes       = 0;
+    ar->pending_len = 0;
+    return RB_OK;
+}
+
+rb_ret_t hr_archive_push(hr_archive_t* ar, const uint8_t* samples, size_t n)
+{
+    CHECK_IF_INIT(ar);
+
+    if ((samples == NULL) && (n > 0))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    while (n > 0)
+    {
+        const size_t space = HR_ARCHIVE_BLOCK_LEN - ar->pending_len;
+        const size_t cnt   = (n < space) ? n : space;
+        memcpy(ar->pending + ar->pending_len, samples, cnt);
+        ar->pending_len += cnt;
+        ar->next_seq += cnt;
+        samples += cnt;
+        n -= cnt;
+
+        if (ar->pending_len == HR_ARCHIVE_BLOCK_LEN)
+        {
+            flush(ar);
+        }
+    }
+    return RB_OK;
+}
+
+rb_ret_t hr_archive_read(const hr_archive_t* ar, uint64_t from, uint8_t* out, size_t n,
+                         size_t* read)
+{
+    CHECK_IF_INIT(ar);
+
+    if ((out == NULL) || (read == NULL) || (from < ar->first_seq))
+    {
+        return RB_INVALID_ARG;
+    }
+    if (from >= ar->next_seq)
+    {
+        return RB_EMPTY;
+    }
+
+    rb_var_it_t it;
+    const void* ptr;
+    size_t      len;
+    size_t      done = 0;
+    uint64_t    seq  = ar->first_seq;
+    rb_var_init_read_it(&ar->blocks, &it);
+    while ((done < n) && (rb_var_next(&it, &ptr, &len) == RB_OK))
+    {
+        const hr_archive_hdr_t* hdr = (const hr_archive_hdr_t*)ptr;
+        if (from >= seq + hdr->count)
+        {
+            seq += hdr->count;
+            continue;
+        }
+
+        // whole blocks are decoded in place, partial ones through a local buffer
+        const size_t skip = (size_t)(from - seq);
+        const size_t cnt  = (hdr->count - skip < n - done) ? hdr->count - skip : n - done;
+        if ((skip == 0) && (cnt == hdr->count))
+        {
+            decode(hdr, out + done);
+        }
+        else
+        {
+            uint8_t tmp[HR_ARCHIVE_BLOCK_LEN];
+            decode(hdr, tmp);
+            memcpy(out + done, tmp + skip, cnt);
+        }
+        done += cnt;
+        from += cnt;
+        seq += hdr->count;
+    }
+
+    // the samples of the block that is not full yet are kept raw
+    const uint64_t pendingSeq = ar->next_seq - ar->pending_len;
+    if ((done < n) && (from >= pendingSeq))
+    {
+        const size_t skip = (size_t)(from - pendingSeq);
+        const size_t left = ar->pending_len - skip;
+        const size_t cnt  = (left < n - done) ? left : n - done;
+        memcpy(out + done, ar->pending + skip, cnt);
+        done += cnt;
+    }
+    (*read) = done;
+    return RB_OK;
+}
+
+rb_ret_t hr_archive_range(const hr_archive_t* ar, uint64_t* oldest, uint64_t* next)
+{
+    CHECK_IF_INIT(ar);
+
+    if ((oldest == NULL) || (next == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+    (*oldest) = ar->first_seq;
+    (*next)   = ar->next_seq;
+    return RB_OK;
+}
+
+rb_ret_t hr_archive_usage(const hr_archive_t* ar, uint64_t* samples, size_t* bytes)
+{
+    CHECK_IF_INIT(ar);
+
+    if ((samples == NULL) || (bytes == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+    (*samples) = ar->next_seq - ar->pending_len - ar->first_seq;
+    (*bytes)   = ar->bytes;
+    return RB_OK;
+}
\ No newline at end of file
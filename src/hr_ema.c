@@ -2,6 +2,12 @@
 
 #include <math.h>
 
+// Distance from a rounding boundary below which the incremental result is recalculated
+// like hr_ema_calc(). The float accumulation of hr_ema_calc() is off by less than 2.5e-5
+// for heart rates up to 255: every step rounds by at most 2e-5 and the error of the
+// previous steps shrinks by 1-α. Everywhere else both results round the same way.
+#define ROUND_EPS 1e-4
+
 uint8_t hr_ema_calc(ring_buffer_t* rb)
 {
     rb_it_t it;
@@ -25,4 +31,126 @@ uint8_t hr_ema_calc(ring_buffer_t* rb)
         res = HR_EMA_ALPHA * val + (1 - HR_EMA_ALPHA) * res;
     }
     return (uint8_t)round(res);
+}
+
+uint8_t hr_ema_calc_fixed(ring_buffer_t* rb, const hr_ema_cfg_t* cfg)
+{
+    rb_it_t it;
+    if ((cfg == NULL) || (rb_init_read_it(rb, &it) != RB_OK))
+    {
+        return 0;
+    }
+
+    const int64_t alpha = (cfg->alpha < HR_EMA_Q15_ONE) ? cfg->alpha : HR_EMA_Q15_ONE;
+    const int64_t beta  = HR_EMA_Q15_ONE - alpha;
+
+    uint8_t val;
+    int64_t res = 0; // Q16
+    // initialize first value
+    if (rb_get_next_val(&it, &val) == RB_OK)
+    {
+        res = (int64_t)val << 16;
+    }
+
+    // s(t) = αx(t) + (1-α)st-1, the Q15 * Q16 products are rounded back to Q16
+    while (rb_get_next_val(&it, &val) == RB_OK)
+    {
+        res = ((alpha * ((int64_t)val << 16)) + (beta * res) + (1 << 14)) >> 15;
+    }
+    return (uint8_t)((res + (1 << 15)) >> 16);
+}
+
+// recalculates the state from all elements of the ring buffer
+static rb_ret_t anchor(hr_ema_state_t* state)
+{
+    rb_it_t  it;
+    rb_ret_t ret = rb_init_read_it(state->rb, &it);
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+
+    const double beta = 1.0 - HR_EMA_ALPHA;
+    uint8_t      val;
+
+    state->sum           = 0;
+    state->oldest_weight = 1;
+    state->count         = 0;
+    state->pushes        = 0;
+    while (rb_get_next_val(&it, &val) == RB_OK)
+    {
+        state->sum = HR_EMA_ALPHA * val + beta * state->sum;
+        if (state->count > 0)
+        {
+            state->oldest_weight *= beta;
+        }
+        state->count++;
+    }
+    return RB_OK;
+}
+
+rb_ret_t hr_ema_init(hr_ema_state_t* state, ring_buffer_t* rb)
+{
+    if (state == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    state->rb = rb;
+    return anchor(state);
+}
+
+rb_ret_t hr_ema_push(hr_ema_state_t* state, uint8_t new_val, const uint8_t* evicted,
+                     uint8_t* ema_out)
+{
+    if ((state == NULL) || (ema_out == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    const double beta = 1.0 - HR_EMA_ALPHA;
+
+    if (evicted != NULL)
+    {
+        // the window keeps its length, only the oldest term leaves the sum
+        state->sum -= HR_EMA_ALPHA * state->oldest_weight * (*evicted);
+    }
+    else
+    {
+        if (state->count > 0)
+        {
+            state->oldest_weight *= beta;
+        }
+        state->count++;
+    }
+    state->sum = HR_EMA_ALPHA * new_val + beta * state->sum;
+
+    // the recalculation costs one element per push on average
+    state->pushes++;
+    rb_ret_t ret = (state->pushes >= state->count) ? anchor(state) : RB_OK;
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+
+    // the oldest element is the seed of the smoothing, add the rest of its weight
+    void*  oldest;
+    size_t count;
+    ret = rb_peek_read(state->rb, &oldest, &count);
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+    const double res = state->sum + beta * state->oldest_weight * (*(uint8_t*)oldest);
+
+    // near .5 the float rounding of hr_ema_calc() decides, which happens rarely
+    if (fabs(res - floor(res) - 0.5) < ROUND_EPS)
+    {
+        (*ema_out) = hr_ema_calc(state->rb);
+    }
+    else
+    {
+        (*ema_out) = (uint8_t)round(res);
+    }
+    return RB_OK;
 }
\ No newline at end of file
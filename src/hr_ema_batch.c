@@ -0,0 +1,265 @@
+#include "hr_ema_batch.h"
+
+#include <float.h>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HR_EMA_X86
+#endif
+
+// channels are padded to a multiple of this count, it is one cache line of history
+#define CHANNEL_ALIGN 64
+
+static inline size_t align_up(size_t val, size_t align)
+{
+    return (val + align - 1) / align * align;
+}
+
+// advances one channel, shared by all kernels for the channels that don't fill a vector
+static inline void step_channel(float* sum, const uint8_t* samples,
+                                const uint8_t* evicted, const uint8_t* oldest,
+                                uint8_t* ema_out, size_t c, float evict_weight,
+                                float oldest_weight)
+{
+    const float alpha = HR_EMA_ALPHA;
+    const float beta  = 1.0f - HR_EMA_ALPHA;
+
+    float s = sum[c];
+    if (evicted != NULL)
+    {
+        s = s - evict_weight * (float)evicted[c];
+    }
+    s      = alpha * (float)samples[c] + beta * s;
+    sum[c] = s;
+
+    const float res = s + oldest_weight * (float)oldest[c];
+    ema_out[c]      = (uint8_t)(int)(res + 0.5f);
+}
+
+static void kernel_scalar(float* sum, const uint8_t* samples, const uint8_t* evicted,
+                          const uint8_t* oldest, uint8_t* ema_out, size_t n,
+                          float evict_weight, float oldest_weight)
+{
+    for (size_t c = 0; c < n; ++c)
+    {
+        step_channel(sum, samples, evicted, oldest, ema_out, c, evict_weight,
+                     oldest_weight);
+    }
+}
+
+#ifdef HR_EMA_X86
+
+// converts 4 heart rates to floats
+static inline __m128 load_u8x4(const uint8_t* src)
+{
+    int32_t word;
+    memcpy(&word, src, sizeof(word));
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i bytes = _mm_cvtsi32_si128(word);
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+}
+
+__attribute__((target("sse2"))) static void
+    kernel_sse2(float* sum, const uint8_t* samples, const uint8_t* evicted,
+                const uint8_t* oldest, uint8_t* ema_out, size_t n, float evict_weight,
+                float oldest_weight)
+{
+    const __m128 alpha = _mm_set1_ps(HR_EMA_ALPHA);
+    const __m128 beta  = _mm_set1_ps(1.0f - HR_EMA_ALPHA);
+    const __m128 ew    = _mm_set1_ps(evict_weight);
+    const __m128 ow    = _mm_set1_ps(oldest_weight);
+    const __m128 half  = _mm_set1_ps(0.5f);
+
+    size_t c = 0;
+    for (; c + 4 <= n; c += 4)
+    {
+        __m128 s = _mm_loadu_ps(sum + c);
+        if (evicted != NULL)
+        {
+            s = _mm_sub_ps(s, _mm_mul_ps(ew, load_u8x4(evicted + c)));
+        }
+        s = _mm_add_ps(_mm_mul_ps(alpha, load_u8x4(samples + c)), _mm_mul_ps(beta, s));
+        _mm_storeu_ps(sum + c, s);
+
+        const __m128  res  = _mm_add_ps(s, _mm_mul_ps(ow, load_u8x4(oldest + c)));
+        const __m128i i32  = _mm_cvttps_epi32(_mm_add_ps(res, half));
+        const __m128i i16  = _mm_packs_epi32(i32, i32);
+        const int32_t word = _mm_cvtsi128_si32(_mm_packus_epi16(i16, i16));
+        memcpy(ema_out + c, &word, sizeof(word));
+    }
+    for (; c < n; ++c)
+    {
+        step_channel(sum, samples, evicted, oldest, ema_out, c, evict_weight,
+                     oldest_weight);
+    }
+}
+
+// converts 8 heart rates to floats
+__attribute__((target("avx2"))) static inline __m256 load_u8x8(const uint8_t* src)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src)));
+}
+
+__attribute__((target("avx2"))) static void
+    kernel_avx2(float* sum, const uint8_t* samples, const uint8_t* evicted,
+                const uint8_t* oldest, uint8_t* ema_out, size_t n, float evict_weight,
+                float oldest_weight)
+{
+    const __m256 alpha = _mm256_set1_ps(HR_EMA_ALPHA);
+    const __m256 beta  = _mm256_set1_ps(1.0f - HR_EMA_ALPHA);
+    const __m256 ew    = _mm256_set1_ps(evict_weight);
+    const __m256 ow    = _mm256_set1_ps(oldest_weight);
+    const __m256 half  = _mm256_set1_ps(0.5f);
+
+    size_t c = 0;
+    for (; c + 8 <= n; c += 8)
+    {
+        __m256 s = _mm256_loadu_ps(sum + c);
+        if (evicted != NULL)
+        {
+            s = _mm256_sub_ps(s, _mm256_mul_ps(ew, load_u8x8(evicted + c)));
+        }
+        s = _mm256_add_ps(_mm256_mul_ps(alpha, load_u8x8(samples + c)),
+                          _mm256_mul_ps(beta, s));
+        _mm256_storeu_ps(sum + c, s);
+
+        const __m256  res = _mm256_add_ps(s, _mm256_mul_ps(ow, load_u8x8(oldest + c)));
+        const __m256i i32 = _mm256_cvttps_epi32(_mm256_add_ps(res, half));
+        const __m128i i16 = _mm_packs_epi32(_mm256_castsi256_si128(i32),
+                                            _mm256_extracti128_si256(i32, 1));
+        _mm_storel_epi64((__m128i*)(ema_out + c), _mm_packus_epi16(i16, i16));
+    }
+    for (; c < n; ++c)
+    {
+        step_channel(sum, samples, evicted, oldest, ema_out, c, evict_weight,
+                     oldest_weight);
+    }
+}
+
+#endif
+
+// returns the kernel for the given instruction set, NULL if the CPU doesn't support it
+static hr_ema_kernel_t select_kernel(hr_ema_isa_t isa)
+{
+    switch (isa)
+    {
+        case HR_EMA_ISA_SCALAR:
+            return kernel_scalar;
+#ifdef HR_EMA_X86
+        case HR_EMA_ISA_SSE2:
+            return __builtin_cpu_supports("sse2") ? kernel_sse2 : NULL;
+        case HR_EMA_ISA_AVX2:
+            return __builtin_cpu_supports("avx2") ? kernel_avx2 : NULL;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+// weights below the smallest normal float are flushed to zero, they don't change the
+// result and denormal arithmetic is slow
+static inline float flush_weight(float weight)
+{
+    return (weight < FLT_MIN) ? 0.0f : weight;
+}
+
+size_t hr_ema_batch_mem_size(size_t channels, size_t window)
+{
+    const size_t stride = align_up(channels, CHANNEL_ALIGN);
+    return CHANNEL_ALIGN + (stride * window) + (stride * sizeof(float));
+}
+
+rb_ret_t hr_ema_batch_init(hr_ema_batch_t* batch, void* mem, size_t mem_size,
+                           size_t channels, size_t window)
+{
+    if ((batch == NULL) || (mem == NULL) || (channels == 0) || (window == 0) ||
+        (mem_size < hr_ema_batch_mem_size(channels, window)))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    const size_t stride = align_up(channels, CHANNEL_ALIGN);
+    char*        base   = (char*)align_up((uintptr_t)mem, CHANNEL_ALIGN);
+    memset(base, 0, (stride * window) + (stride * sizeof(float)));
+
+    batch->sum           = (float*)base;
+    batch->hist          = (uint8_t*)(base + (stride * sizeof(float)));
+    batch->channels      = channels;
+    batch->stride        = stride;
+    batch->window        = window;
+    batch->count         = 0;
+    batch->head          = 0;
+    batch->oldest_weight = 0;
+
+    // prefer the widest vectors, the scalar kernel is always available
+    const hr_ema_isa_t isas[] = {HR_EMA_ISA_AVX2, HR_EMA_ISA_SSE2, HR_EMA_ISA_SCALAR};
+    for (size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); ++i)
+    {
+        if (hr_ema_batch_set_isa(batch, isas[i]) == RB_OK)
+        {
+            break;
+        }
+    }
+    return RB_OK;
+}
+
+rb_ret_t hr_ema_batch_set_isa(hr_ema_batch_t* batch, hr_ema_isa_t isa)
+{
+    hr_ema_kernel_t kernel = select_kernel(isa);
+    if (kernel == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    batch->isa    = isa;
+    batch->kernel = kernel;
+    return RB_OK;
+}
+
+rb_ret_t hr_ema_batch_push(hr_ema_batch_t* batch, const uint8_t* samples,
+                           uint8_t* ema_out)
+{
+    if ((batch->hist == NULL) || (batch->kernel == NULL))
+    {
+        return RB_NOT_INIT;
+    }
+
+    const float    alpha   = HR_EMA_ALPHA;
+    const float    beta    = 1.0f - HR_EMA_ALPHA;
+    const bool     isFull  = (batch->count == batch->window);
+    uint8_t*       row     = batch->hist + (batch->head * batch->stride);
+    const uint8_t* evicted = isFull ? row : NULL;
+
+    // the weight of the oldest sample grows until the window is full
+    float weight = batch->oldest_weight;
+    if (!isFull)
+    {
+        weight = (batch->count == 0) ? 1.0f : flush_weight(weight * beta);
+        batch->count++;
+    }
+    batch->head++;
+    if (batch->head == batch->window)
+    {
+        batch->head = 0;
+    }
+
+    // the oldest row after the push, it is the new samples for a window of one
+    const uint8_t* oldest = (batch->count == batch->window)
+                                ? batch->hist + (batch->head * batch->stride)
+                                : batch->hist;
+    if (oldest == row)
+    {
+        oldest = samples;
+    }
+
+    // the evicted sample leaves with the weight it had as the oldest non-seed term
+    const float evictWeight  = flush_weight(alpha * batch->oldest_weight);
+    const float oldestWeight = flush_weight(beta * weight);
+    batch->kernel(batch->sum, samples, evicted, oldest, ema_out, batch->channels,
+                  evictWeight, oldestWeight);
+    memcpy(row, samples, batch->channels);
+
+    batch->oldest_weight = weight;
+    return RB_OK;
+}
\ No newline at end of file
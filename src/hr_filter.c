@@ -0,0 +1,293 @@
+#include "hr_filter.h"
+
+#define CHECK_IF_INIT(filter)                                                            \
+    if ((filter == NULL) || (filter->n_stages == 0))                                     \
+    return RB_NOT_INIT
+
+// alignment of the arrays carved out of the user memory
+#define MEM_ALIGN 8u
+
+// marks a position in the upper heap, the rest of the bits is the index
+#define POS_HI   0x80000000u
+#define POS_MASK (POS_HI - 1)
+
+static inline size_t align_up(size_t val, size_t align)
+{
+    return (val + align - 1) / align * align;
+}
+
+static size_t stage_mem_size(const hr_filter_cfg_t* cfg)
+{
+    size_t size = align_up(cfg->window + 1, MEM_ALIGN);
+    if (cfg->type == HR_FILTER_MEDIAN)
+    {
+        size += (2 * cfg->window * sizeof(hr_filter_node_t)) +
+                align_up(cfg->window * sizeof(uint32_t), MEM_ALIGN);
+    }
+    return size;
+}
+
+// the lower heap is a max-heap, the upper one a min-heap
+static inline bool before(hr_filter_node_t a, hr_filter_node_t b, bool hi)
+{
+    return hi ? (a.val < b.val) : (a.val > b.val);
+}
+
+static inline void heap_set(hr_filter_median_t* m, bool hi, size_t i,
+                            hr_filter_node_t node)
+{
+    (hi ? m->hi : m->lo)[i] = node;
+    m->pos[node.slot]       = (uint32_t)i | (hi ? POS_HI : 0);
+}
+
+static void sift_up(hr_filter_median_t* m, bool hi, size_t i)
+{
+    hr_filter_node_t*      heap = hi ? m->hi : m->lo;
+    const hr_filter_node_t node = heap[i];
+    while (i > 0)
+    {
+        const size_t parent = (i - 1) / 2;
+        if (!before(node, heap[parent], hi))
+        {
+            break;
+        }
+        heap_set(m, hi, i, heap[parent]);
+        i = parent;
+    }
+    heap_set(m, hi, i, node);
+}
+
+static void sift_down(hr_filter_median_t* m, bool hi, size_t i)
+{
+    hr_filter_node_t*      heap = hi ? m->hi : m->lo;
+    const size_t           n    = hi ? m->n_hi : m->n_lo;
+    const hr_filter_node_t node = heap[i];
+    while (1)
+    {
+        size_t child = (2 * i) + 1;
+        if (child >= n)
+        {
+            break;
+        }
+        if ((child + 1 < n) && before(heap[child + 1], heap[child], hi))
+        {
+            child++;
+        }
+        if (!before(heap[child], node, hi))
+        {
+            break;
+        }
+        heap_set(m, hi, i, heap[child]);
+        i = child;
+    }
+    heap_set(m, hi, i, node);
+}
+
+static void heap_push(hr_filter_median_t* m, bool hi, hr_filter_node_t node)
+{
+    size_t* n = hi ? &m->n_hi : &m->n_lo;
+    heap_set(m, hi, *n, node);
+    (*n)++;
+    sift_up(m, hi, (*n) - 1);
+}
+
+static hr_filter_node_t heap_pop(hr_filter_median_t* m, bool hi)
+{
+    hr_filter_node_t* heap = hi ? m->hi : m->lo;
+    size_t*           n    = hi ? &m->n_hi : &m->n_lo;
+    hr_filter_node_t  top  = heap[0];
+
+    (*n)--;
+    if (*n > 0)
+    {
+        heap_set(m, hi, 0, heap[*n]);
+        sift_down(m, hi, 0);
+    }
+    return top;
+}
+
+// removes the sample of the given slot from whichever heap holds it
+static void heap_remove(hr_filter_median_t* m, uint32_t slot)
+{
+    const bool        hi   = (m->pos[slot] & POS_HI) != 0;
+    const size_t      i    = m->pos[slot] & POS_MASK;
+    hr_filter_node_t* heap = hi ? m->hi : m->lo;
+    size_t*           n    = hi ? &m->n_hi : &m->n_lo;
+
+    (*n)--;
+    if (i == *n)
+    {
+        return;
+    }
+
+    // the last entry takes the place of the removed one and moves up or down from there
+    heap_set(m, hi, i, heap[*n]);
+    if ((i > 0) && before(heap[i], heap[(i - 1) / 2], hi))
+    {
+        sift_up(m, hi, i);
+    }
+    else
+    {
+        sift_down(m, hi, i);
+    }
+}
+
+static uint8_t median_push(hr_filter_median_t* m, uint8_t val, bool evicted)
+{
+    // the slots are reused in order, so the evicted sample is in the slot of the new one
+    const uint32_t slot = (uint32_t)m->next_slot;
+    m->next_slot        = (m->next_slot + 1 == m->window) ? 0 : m->next_slot + 1;
+    if (evicted)
+    {
+        heap_remove(m, slot);
+    }
+
+    const hr_filter_node_t node = {val, slot};
+    heap_push(m, (m->n_lo > 0) && (val > m->lo[0].val), node);
+
+    // the lower heap keeps the same number of samples as the upper one or one more
+    while (m->n_lo > m->n_hi + 1)
+    {
+        heap_push(m, true, heap_pop(m, false));
+    }
+    while (m->n_hi > m->n_lo)
+    {
+        heap_push(m, false, heap_pop(m, true));
+    }
+
+    if (m->n_lo > m->n_hi)
+    {
+        return m->lo[0].val;
+    }
+    return (uint8_t)((m->lo[0].val + m->hi[0].val + 1) / 2);
+}
+
+// adds the input sample to the window of the stage and returns the output of the stage
+static uint8_t stage_push(hr_filter_stage_t* stage, uint8_t val)
+{
+    uint8_t old;
+    bool    evicted;
+    rb_push_overwrite(&stage->rb, &val, &old, &evicted);
+
+    switch (stage->type)
+    {
+        case HR_FILTER_SMA:
+        {
+            stage->sum += val;
+            stage->sum -= evicted ? old : 0;
+
+            // rounded half up like the EMA
+            const uint64_t count = rb_size(&stage->rb);
+            stage->out           = (uint8_t)(((2 * stage->sum) + count) / (2 * count));
+            break;
+        }
+        case HR_FILTER_EMA:
+            hr_ema_push(&stage->ema, val, evicted ? &old : NULL, &stage->out);
+            break;
+        case HR_FILTER_MEDIAN:
+            stage->out = median_push(&stage->median, val, evicted);
+            break;
+    }
+    return stage->out;
+}
+
+size_t hr_filter_mem_size(const hr_filter_cfg_t* cfg, size_t n_stages)
+{
+    if (cfg == NULL)
+    {
+        return 0;
+    }
+
+    size_t size = MEM_ALIGN;
+    for (size_t i = 0; i < n_stages; ++i)
+    {
+        size += stage_mem_size(&cfg[i]);
+    }
+    return size;
+}
+
+rb_ret_t hr_filter_init(hr_filter_t* filter, void* mem, size_t mem_size,
+                        const hr_filter_cfg_t* cfg, size_t n_stages)
+{
+    if ((filter == NULL) || (mem == NULL) || (cfg == NULL) || (n_stages == 0) ||
+        (n_stages > HR_FILTER_MAX_STAGES))
+    {
+        return RB_INVALID_ARG;
+    }
+    for (size_t i = 0; i < n_stages; ++i)
+    {
+        if ((cfg[i].window == 0) || (cfg[i].type > HR_FILTER_MEDIAN) ||
+            ((cfg[i].type == HR_FILTER_MEDIAN) && (cfg[i].window > POS_MASK)))
+        {
+            return RB_INVALID_ARG;
+        }
+    }
+    if (mem_size < hr_filter_mem_size(cfg, n_stages))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    char* base = (char*)align_up((uintptr_t)mem, MEM_ALIGN);
+    for (size_t i = 0; i < n_stages; ++i)
+    {
+        hr_filter_stage_t* stage  = &filter->stages[i];
+        const size_t       window = cfg[i].window;
+
+        stage->type = cfg[i].type;
+        stage->sum  = 0;
+        stage->out  = 0;
+        if (stage->type == HR_FILTER_MEDIAN)
+        {
+            hr_filter_median_t* m = &stage->median;
+            m->lo                 = (hr_filter_node_t*)base;
+            m->hi                 = m->lo + window;
+            m->pos                = (uint32_t*)(m->hi + window);
+            m->n_lo               = 0;
+            m->n_hi               = 0;
+            m->window             = window;
+            m->next_slot          = 0;
+            base += (2 * window * sizeof(hr_filter_node_t)) +
+                    align_up(window * sizeof(uint32_t), MEM_ALIGN);
+        }
+
+        rb_init(&stage->rb, base, window + 1, sizeof(uint8_t));
+        base += align_up(window + 1, MEM_ALIGN);
+        if (stage->type == HR_FILTER_EMA)
+        {
+            hr_ema_init(&stage->ema, &stage->rb);
+        }
+    }
+    filter->n_stages = n_stages;
+    return RB_OK;
+}
+
+rb_ret_t hr_filter_push(hr_filter_t* filter, uint8_t sample, uint8_t* out)
+{
+    CHECK_IF_INIT(filter);
+
+    if (out == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    // the output of each stage is the input of the next one
+    uint8_t val = sample;
+    for (size_t i = 0; i < filter->n_stages; ++i)
+    {
+        val = stage_push(&filter->stages[i], val);
+    }
+    (*out) = val;
+    return RB_OK;
+}
+
+rb_ret_t hr_filter_stage_out(const hr_filter_t* filter, size_t stage, uint8_t* out)
+{
+    CHECK_IF_INIT(filter);
+
+    if ((stage >= filter->n_stages) || (out == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+    (*out) = filter->stages[stage].out;
+    return RB_OK;
+}
\ No newline at end of file
@@ -1,8 +1,158 @@
 #include "hr_gen.h"
 
-#include <stdlib.h>
+#include <cstring>
+
+#define HR_GEN_RANGE        (HR_GEN_MAX_HR - HR_GEN_MIN_HR + 1)
+#define HR_GEN_DEFAULT_SEED 0x6872u
+
+static inline uint32_t rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint64_t splitmix64(uint64_t* x)
+{
+    uint64_t z = ((*x) += 0x9e3779b97f4a7c15ull);
+    z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z          = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// advances one lane and returns its next 32-bit number
+static inline uint32_t next_u32(hr_gen_t* gen, size_t lane)
+{
+    uint32_t* s0 = &gen->s[0][lane];
+    uint32_t* s1 = &gen->s[1][lane];
+    uint32_t* s2 = &gen->s[2][lane];
+    uint32_t* s3 = &gen->s[3][lane];
+
+    const uint32_t res = rotl((*s1) * 5, 7) * 9;
+    const uint32_t t   = (*s1) << 9;
+    (*s2) ^= (*s0);
+    (*s3) ^= (*s1);
+    (*s1) ^= (*s2);
+    (*s0) ^= (*s3);
+    (*s2) ^= t;
+    (*s3) = rotl(*s3, 11);
+    return res;
+}
+
+// Lemire's reduction of x to [0, HR_GEN_RANGE) rejecting the biased results, the lane
+// is advanced until an unbiased number is drawn
+static uint8_t reduce_slow(hr_gen_t* gen, size_t lane, uint32_t x)
+{
+    const uint32_t threshold = (0u - HR_GEN_RANGE) % HR_GEN_RANGE;
+
+    uint64_t m = (uint64_t)x * HR_GEN_RANGE;
+    while ((uint32_t)m < threshold)
+    {
+        m = (uint64_t)next_u32(gen, lane) * HR_GEN_RANGE;
+    }
+    return (uint8_t)((m >> 32) + HR_GEN_MIN_HR);
+}
+
+// generates one sample per lane, the loops have no dependencies between the lanes
+static void gen_block(hr_gen_t* gen, uint8_t* out)
+{
+    uint32_t x[HR_GEN_LANES];
+    uint32_t low[HR_GEN_LANES];
+    for (size_t lane = 0; lane < HR_GEN_LANES; ++lane)
+    {
+        x[lane] = next_u32(gen, lane);
+    }
+
+    // x * HR_GEN_RANGE is split into 16-bit halves so that the 64-bit product is
+    // calculated with 32-bit vector multiplications
+    uint32_t suspect = 0;
+    for (size_t lane = 0; lane < HR_GEN_LANES; ++lane)
+    {
+        const uint32_t lo = (x[lane] & 0xffffu) * HR_GEN_RANGE;
+        const uint32_t hi = (x[lane] >> 16) * HR_GEN_RANGE + (lo >> 16);
+        out[lane]         = (uint8_t)((hi >> 16) + HR_GEN_MIN_HR);
+        low[lane]         = (hi << 16) | (lo & 0xffffu);
+
+        // a low part below the range may be biased, it's rare so it's checked at once
+        suspect |= (low[lane] < HR_GEN_RANGE);
+    }
+
+    if (suspect)
+    {
+        for (size_t lane = 0; lane < HR_GEN_LANES; ++lane)
+        {
+            if (low[lane] < HR_GEN_RANGE)
+            {
+                out[lane] = reduce_slow(gen, lane, x[lane]);
+            }
+        }
+    }
+}
+
+rb_ret_t hr_gen_init(hr_gen_t* gen, uint64_t seed)
+{
+    if (gen == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    // splitmix64 expands the seed, the set low bit rules out an all-zero lane state
+    for (size_t lane = 0; lane < HR_GEN_LANES; ++lane)
+    {
+        const uint64_t a = splitmix64(&seed);
+        const uint64_t b = splitmix64(&seed);
+        gen->s[0][lane]  = (uint32_t)a;
+        gen->s[1][lane]  = (uint32_t)(a >> 32);
+        gen->s[2][lane]  = (uint32_t)b;
+        gen->s[3][lane]  = (uint32_t)(b >> 32) | 1u;
+    }
+    gen->left = 0;
+    return RB_OK;
+}
+
+uint8_t hr_gen_next(hr_gen_t* gen)
+{
+    if (gen->left == 0)
+    {
+        gen_block(gen, gen->block);
+        gen->left = HR_GEN_LANES;
+    }
+    return gen->block[HR_GEN_LANES - (gen->left--)];
+}
+
+rb_ret_t hr_gen_fill(hr_gen_t* gen, uint8_t* out, size_t n)
+{
+    if ((gen == NULL) || ((out == NULL) && (n > 0)))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    // the rest of the current block goes first to keep the sequence
+    while ((gen->left > 0) && (n > 0))
+    {
+        (*out++) = hr_gen_next(gen);
+        n--;
+    }
+    for (; n >= HR_GEN_LANES; n -= HR_GEN_LANES, out += HR_GEN_LANES)
+    {
+        gen_block(gen, out);
+    }
+    while (n > 0)
+    {
+        (*out++) = hr_gen_next(gen);
+        n--;
+    }
+    return RB_OK;
+}
 
 uint8_t hr_gen_random()
 {
-    return (rand() % (HR_GEN_MAX_HR - HR_GEN_MIN_HR + 1)) + HR_GEN_MIN_HR;
+    static uint64_t          nextSeed = HR_GEN_DEFAULT_SEED;
+    static __thread bool     isSeeded = false;
+    static __thread hr_gen_t gen;
+
+    if (!isSeeded)
+    {
+        hr_gen_init(&gen, __atomic_fetch_add(&nextSeed, 1, __ATOMIC_RELAXED));
+        isSeeded = true;
+    }
+    return hr_gen_next(&gen);
 }
\ No newline at end of file
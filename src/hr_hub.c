@@ -0,0 +1,259 @@
+#include "hr_hub.h"
+
+#include <cerrno>
+#include <cstring>
+
+#define CHECK_IF_INIT(hub)                                                               \
+    if ((hub == NULL) || (hub->streams == NULL))                                         \
+    return RB_NOT_INIT
+
+// samples generated at once into a local buffer
+#define GEN_BLOCK 64u
+
+static inline size_t align_up(size_t val, size_t align)
+{
+    return (val + align - 1) / align * align;
+}
+
+// adds the samples of the given number of ticks to the stream, returns their count
+static uint64_t run_stream(hr_hub_stream_t* stream, uint32_t ticks)
+{
+    const uint64_t total = (uint64_t)ticks * stream->rate;
+    uint8_t        block[GEN_BLOCK];
+    uint8_t        ema = stream->ema_val;
+
+    for (uint64_t done = 0; done < total;)
+    {
+        const size_t n = (total - done < GEN_BLOCK) ? (size_t)(total - done) : GEN_BLOCK;
+        hr_gen_fill(&stream->gen, block, n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint8_t old;
+            bool    evicted;
+            rb_push_overwrite(&stream->rb, &block[i], &old, &evicted);
+            hr_ema_push(&stream->ema, block[i], evicted ? &old : NULL, &ema);
+        }
+        done += n;
+    }
+    stream->ema_val = ema;
+    return total;
+}
+
+// Runs one round on the given worker: chunks of its own shard first, then chunks stolen
+// from the other shards, starting with the next worker. Each chunk is claimed by one
+// fetch-and-add, the ordering between rounds is given by the hub lock.
+static void run_round(hr_hub_t* hub, hr_hub_worker_t* worker)
+{
+    const size_t id      = (size_t)(worker - hub->workers);
+    uint64_t     samples = 0;
+
+    for (size_t k = 0; k < hub->n_threads; ++k)
+    {
+        hr_hub_worker_t* victim = &hub->workers[(id + k) % hub->n_threads];
+        while (1)
+        {
+            const size_t begin =
+                __atomic_fetch_add(&victim->shard.next, HR_HUB_CHUNK, __ATOMIC_RELAXED);
+            if (begin >= victim->shard.end)
+            {
+                break;
+            }
+
+            const size_t end = (victim->shard.end - begin < HR_HUB_CHUNK)
+                                   ? victim->shard.end
+                                   : begin + HR_HUB_CHUNK;
+            for (size_t s = begin; s < end; ++s)
+            {
+                samples += run_stream(&hub->streams[s], hub->ticks);
+            }
+        }
+    }
+    worker->samples = samples;
+}
+
+static void* worker_main(void* arg)
+{
+    hr_hub_worker_t* worker = (hr_hub_worker_t*)arg;
+    hr_hub_t*        hub    = worker->hub;
+    uint64_t         seen   = 0;
+
+    pthread_mutex_lock(&hub->lock);
+    while (1)
+    {
+        while (!hub->stop && (hub->round == seen))
+        {
+            pthread_cond_wait(&hub->start_cv, &hub->lock);
+        }
+        if (hub->stop)
+        {
+            break;
+        }
+        seen = hub->round;
+        pthread_mutex_unlock(&hub->lock);
+
+        run_round(hub, worker);
+
+        pthread_mutex_lock(&hub->lock);
+        hub->busy--;
+        if (hub->busy == 0)
+        {
+            pthread_cond_signal(&hub->done_cv);
+        }
+    }
+    pthread_mutex_unlock(&hub->lock);
+    return NULL;
+}
+
+// stops and joins the started worker threads, the first worker is the calling thread
+static void stop_workers(hr_hub_t* hub, size_t n_started)
+{
+    pthread_mutex_lock(&hub->lock);
+    hub->stop = true;
+    pthread_cond_broadcast(&hub->start_cv);
+    pthread_mutex_unlock(&hub->lock);
+
+    for (size_t i = 1; i < n_started; ++i)
+    {
+        pthread_join(hub->workers[i].thread, NULL);
+    }
+    pthread_cond_destroy(&hub->done_cv);
+    pthread_cond_destroy(&hub->start_cv);
+    pthread_mutex_destroy(&hub->lock);
+}
+
+size_t hr_hub_mem_size(size_t n_streams, size_t window, size_t n_threads)
+{
+    return RB_CACHE_LINE_SIZE + (n_threads * sizeof(hr_hub_worker_t)) +
+           align_up(n_streams * sizeof(hr_hub_stream_t), RB_CACHE_LINE_SIZE) +
+           (n_streams * (window + 1));
+}
+
+rb_ret_t hr_hub_init(hr_hub_t* hub, void* mem, size_t mem_size, size_t n_streams,
+                     size_t window, size_t n_threads, uint64_t seed)
+{
+    if ((hub == NULL) || (mem == NULL) || (n_streams == 0) || (window == 0) ||
+        (n_threads == 0) || (mem_size < hr_hub_mem_size(n_streams, window, n_threads)))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    char* base   = (char*)align_up((uintptr_t)mem, RB_CACHE_LINE_SIZE);
+    hub->workers = (hr_hub_worker_t*)base;
+    hub->streams = (hr_hub_stream_t*)(base + (n_threads * sizeof(hr_hub_worker_t)));
+    char* rings  = (char*)hub->streams +
+                  align_up(n_streams * sizeof(hr_hub_stream_t), RB_CACHE_LINE_SIZE);
+
+    for (size_t i = 0; i < n_streams; ++i)
+    {
+        hr_hub_stream_t* stream = &hub->streams[i];
+        rb_init(&stream->rb, rings + (i * (window + 1)), window + 1, sizeof(uint8_t));
+        hr_ema_init(&stream->ema, &stream->rb);
+        hr_gen_init(&stream->gen, seed + i);
+        stream->rate    = 1;
+        stream->ema_val = 0;
+    }
+
+    hub->n_streams = n_streams;
+    hub->n_threads = n_threads;
+    hub->ticks     = 0;
+    hub->round     = 0;
+    hub->busy      = 0;
+    hub->stop      = false;
+    pthread_mutex_init(&hub->lock, NULL);
+    pthread_cond_init(&hub->start_cv, NULL);
+    pthread_cond_init(&hub->done_cv, NULL);
+
+    for (size_t i = 0; i < n_threads; ++i)
+    {
+        hr_hub_worker_t* worker = &hub->workers[i];
+        worker->shard.next      = 0;
+        worker->shard.end       = 0;
+        worker->hub             = hub;
+        worker->samples         = 0;
+        if (i == 0)
+        {
+            continue;
+        }
+
+        const int err = pthread_create(&worker->thread, NULL, worker_main, worker);
+        if (err != 0)
+        {
+            stop_workers(hub, i);
+            hub->streams = NULL;
+            errno        = err;
+            return RB_IO_ERROR;
+        }
+    }
+    return RB_OK;
+}
+
+rb_ret_t hr_hub_set_rate(hr_hub_t* hub, size_t stream, uint32_t rate)
+{
+    CHECK_IF_INIT(hub);
+
+    if (stream >= hub->n_streams)
+    {
+        return RB_INVALID_ARG;
+    }
+    hub->streams[stream].rate = rate;
+    return RB_OK;
+}
+
+rb_ret_t hr_hub_run(hr_hub_t* hub, uint32_t ticks, uint64_t* samples_out)
+{
+    CHECK_IF_INIT(hub);
+
+    // even shards, the stealing evens out the differences in their load
+    pthread_mutex_lock(&hub->lock);
+    for (size_t i = 0; i < hub->n_threads; ++i)
+    {
+        hub->workers[i].shard.next = hub->n_streams * i / hub->n_threads;
+        hub->workers[i].shard.end  = hub->n_streams * (i + 1) / hub->n_threads;
+    }
+    hub->ticks = ticks;
+    hub->busy  = hub->n_threads - 1;
+    hub->round++;
+    pthread_cond_broadcast(&hub->start_cv);
+    pthread_mutex_unlock(&hub->lock);
+
+    run_round(hub, &hub->workers[0]);
+
+    pthread_mutex_lock(&hub->lock);
+    while (hub->busy > 0)
+    {
+        pthread_cond_wait(&hub->done_cv, &hub->lock);
+    }
+    pthread_mutex_unlock(&hub->lock);
+
+    if (samples_out != NULL)
+    {
+        uint64_t samples = 0;
+        for (size_t i = 0; i < hub->n_threads; ++i)
+        {
+            samples += hub->workers[i].samples;
+        }
+        (*samples_out) = samples;
+    }
+    return RB_OK;
+}
+
+rb_ret_t hr_hub_ema(const hr_hub_t* hub, size_t stream, uint8_t* ema_out)
+{
+    CHECK_IF_INIT(hub);
+
+    if ((stream >= hub->n_streams) || (ema_out == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+    (*ema_out) = hub->streams[stream].ema_val;
+    return RB_OK;
+}
+
+rb_ret_t hr_hub_destroy(hr_hub_t* hub)
+{
+    CHECK_IF_INIT(hub);
+
+    stop_workers(hub, hub->n_threads);
+    hub->streams = NULL;
+    return RB_OK;
+}
\ No newline at end of file
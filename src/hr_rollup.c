@@ -0,0 +1,216 @@
+#include "hr_rollup.h"
+
+#define CHECK_IF_INIT(rollup)                                                            \
+    if ((rollup == NULL) || (rollup->raw.buff == NULL))                                  \
+    return RB_NOT_INIT
+
+// alignment of the ring buffers carved out of the user memory
+#define MEM_ALIGN 8u
+
+static inline size_t align_up(size_t val, size_t align)
+{
+    return (val + align - 1) / align * align;
+}
+
+static inline void agg_reset(hr_rollup_agg_t* agg)
+{
+    agg->sum   = 0;
+    agg->count = 0;
+    agg->min   = UINT8_MAX;
+    agg->max   = 0;
+}
+
+static inline void agg_add(hr_rollup_agg_t* agg, uint8_t sample)
+{
+    agg->sum += sample;
+    agg->count++;
+    agg->min = (sample < agg->min) ? sample : agg->min;
+    agg->max = (sample > agg->max) ? sample : agg->max;
+}
+
+static inline void agg_merge(hr_rollup_agg_t* agg, const hr_rollup_agg_t* other)
+{
+    agg->sum += other->sum;
+    agg->count += other->count;
+    agg->min = (other->min < agg->min) ? other->min : agg->min;
+    agg->max = (other->max > agg->max) ? other->max : agg->max;
+}
+
+// Adds the entries [first, last) of a ring buffer whose newest entry has number done - 1,
+// returns false if they aren't all kept. The samples are the entries of level -1.
+static bool scan(hr_rollup_t* rollup, int level, uint64_t done, uint64_t first,
+                 uint64_t last, hr_rollup_agg_t* agg)
+{
+    ring_buffer_t* rb   = (level < 0) ? &rollup->raw : &rollup->levels[level].rb;
+    const uint64_t kept = rb_size(rb);
+    if ((last > done) || (first < done - kept))
+    {
+        return false;
+    }
+
+    for (uint64_t i = first; i < last; ++i)
+    {
+        void* ptr;
+        rb_at(rb, (size_t)(i - (done - kept)), &ptr);
+        if (level < 0)
+        {
+            agg_add(agg, *(const uint8_t*)ptr);
+        }
+        else
+        {
+            agg_merge(agg, (const hr_rollup_agg_t*)ptr);
+        }
+    }
+    return true;
+}
+
+// Adds the samples [from, to) from the completed buckets of the given level that fall
+// into the range and the partial ranges at both ends from the levels below. The partial
+// ranges are shorter than a bucket, so every level below reads less than two spans.
+static bool collect(hr_rollup_t* rollup, int level, uint64_t from, uint64_t to,
+                    hr_rollup_agg_t* agg)
+{
+    if (from >= to)
+    {
+        return true;
+    }
+    if (level < 0)
+    {
+        return scan(rollup, level, rollup->total, from, to, agg);
+    }
+
+    const uint64_t width = rollup->levels[level].width;
+    const uint64_t first = (from + width - 1) / width;
+    const uint64_t last  = to / width;
+    if ((first >= last) || !scan(rollup, level, rollup->total / width, first, last, agg))
+    {
+        return collect(rollup, level - 1, from, to, agg);
+    }
+    return collect(rollup, level - 1, from, first * width, agg) &&
+           collect(rollup, level - 1, last * width, to, agg);
+}
+
+size_t hr_rollup_mem_size(size_t raw_depth, const hr_rollup_cfg_t* cfg, size_t n_levels)
+{
+    if ((cfg == NULL) && (n_levels > 0))
+    {
+        return 0;
+    }
+
+    size_t size = MEM_ALIGN + align_up(raw_depth + 1, MEM_ALIGN);
+    for (size_t i = 0; i < n_levels; ++i)
+    {
+        size += (cfg[i].depth + 1) * sizeof(hr_rollup_agg_t);
+    }
+    return size;
+}
+
+rb_ret_t hr_rollup_init(hr_rollup_t* rollup, void* mem, size_t mem_size, size_t raw_depth,
+                        const hr_rollup_cfg_t* cfg, size_t n_levels)
+{
+    if ((rollup == NULL) || (mem == NULL) || (raw_depth == 0) ||
+        ((cfg == NULL) && (n_levels > 0)) || (n_levels > HR_ROLLUP_MAX_LEVELS))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    // the in-progress bucket of every level is covered by the level below
+    uint64_t width = 1;
+    size_t   below = raw_depth;
+    for (size_t i = 0; i < n_levels; ++i)
+    {
+        if ((cfg[i].span < 2) || (cfg[i].depth == 0) || (cfg[i].span > below) ||
+            (cfg[i].span > UINT32_MAX / width))
+        {
+            return RB_INVALID_ARG;
+        }
+        width *= cfg[i].span;
+        below = cfg[i].depth;
+    }
+    if (mem_size < hr_rollup_mem_size(raw_depth, cfg, n_levels))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    char* base = (char*)align_up((uintptr_t)mem, MEM_ALIGN);
+    rb_init(&rollup->raw, base, raw_depth + 1, sizeof(uint8_t));
+    base += align_up(raw_depth + 1, MEM_ALIGN);
+
+    width = 1;
+    for (size_t i = 0; i < n_levels; ++i)
+    {
+        hr_rollup_level_t* level = &rollup->levels[i];
+        const size_t       size  = (cfg[i].depth + 1) * sizeof(hr_rollup_agg_t);
+
+        width *= cfg[i].span;
+        rb_init(&level->rb, base, size, sizeof(hr_rollup_agg_t));
+        agg_reset(&level->cur);
+        level->width = width;
+        base += size;
+    }
+    rollup->n_levels = n_levels;
+    rollup->total    = 0;
+    return RB_OK;
+}
+
+rb_ret_t hr_rollup_push(hr_rollup_t* rollup, uint8_t sample)
+{
+    CHECK_IF_INIT(rollup);
+
+    rb_push_overwrite(&rollup->raw, &sample, NULL, NULL);
+    rollup->total++;
+    if (rollup->n_levels == 0)
+    {
+        return RB_OK;
+    }
+
+    // a completed bucket is merged into the bucket in progress of the next level
+    agg_add(&rollup->levels[0].cur, sample);
+    for (size_t i = 0; i < rollup->n_levels; ++i)
+    {
+        hr_rollup_level_t* level = &rollup->levels[i];
+        if (level->cur.count != level->width)
+        {
+            break;
+        }
+
+        rb_push_overwrite(&level->rb, &level->cur, NULL, NULL);
+        if (i + 1 < rollup->n_levels)
+        {
+            agg_merge(&rollup->levels[i + 1].cur, &level->cur);
+        }
+        agg_reset(&level->cur);
+    }
+    return RB_OK;
+}
+
+rb_ret_t hr_rollup_query(hr_rollup_t* rollup, uint64_t from, uint64_t to,
+                         hr_rollup_agg_t* agg)
+{
+    CHECK_IF_INIT(rollup);
+
+    if ((agg == NULL) || (from >= to) || (to > rollup->total))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    hr_rollup_agg_t res;
+    agg_reset(&res);
+    if (!collect(rollup, (int)rollup->n_levels - 1, from, to, &res))
+    {
+        return RB_INVALID_ARG;
+    }
+    (*agg) = res;
+    return RB_OK;
+}
+
+rb_ret_t hr_rollup_last(hr_rollup_t* rollup, uint64_t n, hr_rollup_agg_t* agg)
+{
+    CHECK_IF_INIT(rollup);
+
+    if (n > rollup->total)
+    {
+        return RB_INVALID_ARG;
+    }
+    return hr_rollup_query(rollup, rollup->total - n, rollup->total, agg);
+}
\ No newline at end of file
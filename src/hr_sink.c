@@ -0,0 +1,385 @@
+#include "hr_sink.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <time.h>
+#include <unistd.h>
+
+#define CHECK_IF_INIT(sink)                                                              \
+    if ((sink == NULL) || (sink->out == NULL))                                           \
+    return RB_NOT_INIT
+
+#define LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(ptr)       __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define STORE_RELEASE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define STORE_RELAXED(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELAXED)
+
+// alignment of the queue and the output buffer carved out of the user memory
+#define MEM_ALIGN 8u
+
+// sleep of the sink thread between rounds while records keep coming, it grows up to the
+// flush interval
+#define POLL_MIN_US 50u
+#define POLL_START_US 1000u
+
+// number of records the sink thread takes from the queue at once
+#define DRAIN_CHUNK 256u
+
+static const char CSV_HEADER[] = "seq,stream,hr,ema\n";
+
+static inline size_t align_up(size_t val, size_t align)
+{
+    return (val + align - 1) / align * align;
+}
+
+static inline size_t queue_size(size_t depth)
+{
+    return align_up((depth + 1) * sizeof(hr_sink_rec_t), MEM_ALIGN);
+}
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
+// counters are only written by one thread, atomically so that stats may read them
+static inline void count(uint64_t* counter, uint64_t n)
+{
+    STORE_RELAXED(counter, LOAD_RELAXED(counter) + n);
+}
+
+// writes the decimal digits of the value, returns their number
+static size_t put_uint(char* out, uint64_t val)
+{
+    char   digits[20];
+    size_t n = 0;
+    do
+    {
+        digits[n++] = (char)('0' + (val % 10));
+        val /= 10;
+    } while (val > 0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i] = digits[n - 1 - i];
+    }
+    return n;
+}
+
+static inline size_t put_str(char* out, const char* str)
+{
+    const size_t len = strlen(str);
+    memcpy(out, str, len);
+    return len;
+}
+
+static inline size_t put_le(char* out, uint64_t val, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        out[i] = (char)(val >> (8 * i));
+    }
+    return size;
+}
+
+// formats the record at the given position, returns its length
+static size_t format(hr_sink_format_t fmt, const hr_sink_rec_t* rec, char* out)
+{
+    size_t len = 0;
+    switch (fmt)
+    {
+        case HR_SINK_TEXT:
+            len += put_str(out + len, "sample ");
+            len += put_uint(out + len, rec->seq);
+            len += put_str(out + len, ", stream ");
+            len += put_uint(out + len, rec->stream);
+            len += put_str(out + len, ": heart rate ");
+            len += put_uint(out + len, rec->hr);
+            len += put_str(out + len, ", EMA ");
+            len += put_uint(out + len, rec->ema);
+            out[len++] = '\n';
+            break;
+        case HR_SINK_CSV:
+            len += put_uint(out + len, rec->seq);
+            out[len++] = ',';
+            len += put_uint(out + len, rec->stream);
+            out[len++] = ',';
+            len += put_uint(out + len, rec->hr);
+            out[len++] = ',';
+            len += put_uint(out + len, rec->ema);
+            out[len++] = '\n';
+            break;
+        case HR_SINK_BINARY:
+            len += put_le(out + len, rec->seq, sizeof(rec->seq));
+            len += put_le(out + len, rec->stream, sizeof(rec->stream));
+            out[len++] = (char)rec->hr;
+            out[len++] = (char)rec->ema;
+            break;
+    }
+    return len;
+}
+
+// writes the output buffer with as few system calls as the file descriptor allows
+static void flush(hr_sink_t* sink)
+{
+    size_t off = 0;
+    while (off < sink->out_len)
+    {
+        const ssize_t res = write(sink->cfg.fd, sink->out + off, sink->out_len - off);
+        if ((res < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+        count(&sink->cons.writes, 1);
+        if (res < 0)
+        {
+            count(&sink->cons.write_errors, 1);
+            break;
+        }
+        count(&sink->cons.bytes, (uint64_t)res);
+        off += (size_t)res;
+    }
+    if (off == sink->out_len)
+    {
+        count(&sink->cons.written, sink->out_recs);
+    }
+    sink->out_len  = 0;
+    sink->out_recs = 0;
+}
+
+// formats the record into the output buffer, which is written once it can't take another
+static void append(hr_sink_t* sink, const hr_sink_rec_t* rec)
+{
+    sink->out_len += format(sink->cfg.format, rec, sink->out + sink->out_len);
+    sink->out_recs++;
+    if (sink->out_len + HR_SINK_MAX_REC_LEN > sink->cfg.batch_size)
+    {
+        flush(sink);
+    }
+}
+
+// sleeps for the given number of microseconds
+static void sleep_us(uint64_t us)
+{
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(us / 1000000);
+    ts.tv_nsec = (long)((us % 1000000) * 1000);
+    while ((nanosleep(&ts, &ts) != 0) && (errno == EINTR))
+    {
+    }
+}
+
+// Returns the number of records the sink thread may take. Once the sink is stopped the
+// queue may end with the record that woke the thread up, which is not taken.
+static size_t take_limit(hr_sink_t* sink)
+{
+    if (LOAD_ACQUIRE(&sink->stop))
+    {
+        return (size_t)(LOAD_RELAXED(&sink->prod.pushed) - sink->cons.taken);
+    }
+    return sink->cfg.depth;
+}
+
+// Formats the queued records, at most one queue worth, returns their number. They are
+// taken in chunks, so the producer sees the space freed once per chunk. The records were
+// queued after the given time, the output buffer is due a flush interval later.
+static size_t drain(hr_sink_t* sink, uint64_t since, uint64_t* deadline)
+{
+    hr_sink_rec_t recs[DRAIN_CHUNK];
+    const size_t  limit = take_limit(sink);
+    size_t        total = 0;
+    size_t        n;
+    while ((total < limit) &&
+           (rb_spsc_pop_n(&sink->rb, recs,
+                          (limit - total < DRAIN_CHUNK) ? limit - total : DRAIN_CHUNK,
+                          &n) == RB_OK))
+    {
+        if (sink->out_len == 0)
+        {
+            (*deadline) = since + ((uint64_t)sink->cfg.flush_ms * 1000);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            append(sink, &recs[i]);
+        }
+        total += n;
+        sink->cons.taken += n;
+    }
+    return total;
+}
+
+// While idle the thread parks until the first record arrives. While records keep coming
+// it sleeps between rounds instead, so the producer never has to wake it up. The sleep
+// adapts to the rate: it halves when a round finds the queue half full and doubles when
+// it finds it almost empty, up to the flush interval.
+static void* sink_main(void* arg)
+{
+    hr_sink_t*     sink     = (hr_sink_t*)arg;
+    const uint64_t interval = (uint64_t)sink->cfg.flush_ms * 1000;
+    const size_t   depth    = sink->cfg.depth;
+    uint64_t       poll     = (interval < POLL_START_US) ? interval : POLL_START_US;
+    uint64_t       since    = now_us();
+    uint64_t       deadline = since + interval;
+
+    while (1)
+    {
+        size_t n = drain(sink, since, &deadline);
+        if ((n == 0) && (sink->out_len == 0) && !LOAD_ACQUIRE(&sink->stop))
+        {
+            hr_sink_rec_t rec;
+            if ((rb_spsc_pop_wait(&sink->rb, &rec, (int)sink->cfg.flush_ms) == RB_OK) &&
+                (take_limit(sink) > 0))
+            {
+                sink->cons.taken++;
+                since    = now_us();
+                deadline = since + interval;
+                append(sink, &rec);
+                n = 1 + drain(sink, since, &deadline);
+            }
+        }
+
+        const uint64_t now = now_us();
+        if ((sink->out_len > 0) && (now >= deadline))
+        {
+            flush(sink);
+        }
+
+        // the producer doesn't push anymore once the flag is set
+        if (LOAD_ACQUIRE(&sink->stop))
+        {
+            while (drain(sink, now, &deadline) > 0)
+            {
+            }
+            flush(sink);
+            break;
+        }
+
+        // the records taken in the next round are queued from now on
+        since = now;
+        if (n >= depth / 2)
+        {
+            poll = (poll / 2 > POLL_MIN_US) ? poll / 2 : POLL_MIN_US;
+        }
+        else if ((n < depth / 8) && (poll * 2 <= interval))
+        {
+            poll *= 2;
+        }
+        if (sink->out_len > 0)
+        {
+            sleep_us((deadline - now < poll) ? deadline - now : poll);
+        }
+        else if (n > 0)
+        {
+            sleep_us(poll);
+        }
+    }
+    return NULL;
+}
+
+size_t hr_sink_mem_size(size_t depth, size_t batch_size)
+{
+    return MEM_ALIGN + queue_size(depth) + batch_size;
+}
+
+rb_ret_t hr_sink_init(hr_sink_t* sink, void* mem, size_t mem_size,
+                      const hr_sink_cfg_t* cfg)
+{
+    if ((sink == NULL) || (mem == NULL) || (cfg == NULL) || (cfg->fd < 0) ||
+        (cfg->format > HR_SINK_BINARY) || (cfg->depth == 0) ||
+        (cfg->batch_size < HR_SINK_MAX_REC_LEN) || (cfg->flush_ms == 0) ||
+        (cfg->flush_ms > INT_MAX) ||
+        (mem_size < hr_sink_mem_size(cfg->depth, cfg->batch_size)))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    char* base = (char*)align_up((uintptr_t)mem, MEM_ALIGN);
+    rb_spsc_init(&sink->rb, base, (cfg->depth + 1) * sizeof(hr_sink_rec_t),
+                 sizeof(hr_sink_rec_t));
+    sink->cfg      = *cfg;
+    sink->out      = base + queue_size(cfg->depth);
+    sink->out_len  = 0;
+    sink->out_recs = 0;
+    sink->stop     = false;
+    memset(&sink->prod, 0, sizeof(sink->prod));
+    memset(&sink->cons, 0, sizeof(sink->cons));
+
+    // the header goes out with the first batch
+    if (cfg->format == HR_SINK_CSV)
+    {
+        sink->out_len = put_str(sink->out, CSV_HEADER);
+    }
+
+    const int err = pthread_create(&sink->thread, NULL, sink_main, sink);
+    if (err != 0)
+    {
+        sink->out = NULL;
+        errno     = err;
+        return RB_IO_ERROR;
+    }
+    return RB_OK;
+}
+
+rb_ret_t hr_sink_push(hr_sink_t* sink, const hr_sink_rec_t* rec)
+{
+    CHECK_IF_INIT(sink);
+
+    if (rec == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    rb_ret_t ret = rb_spsc_push(&sink->rb, rec);
+    if ((ret == RB_FULL) && (sink->cfg.wait_ms != 0))
+    {
+        count(&sink->prod.full_waits, 1);
+        ret = rb_spsc_push_wait(&sink->rb, rec, sink->cfg.wait_ms);
+    }
+    if (ret != RB_OK)
+    {
+        count(&sink->prod.dropped, 1);
+        return ret;
+    }
+    count(&sink->prod.pushed, 1);
+    return RB_OK;
+}
+
+rb_ret_t hr_sink_stats(hr_sink_t* sink, hr_sink_stats_t* out)
+{
+    CHECK_IF_INIT(sink);
+
+    if (out == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+    out->pushed       = LOAD_RELAXED(&sink->prod.pushed);
+    out->full_waits   = LOAD_RELAXED(&sink->prod.full_waits);
+    out->dropped      = LOAD_RELAXED(&sink->prod.dropped);
+    out->written      = LOAD_RELAXED(&sink->cons.written);
+    out->writes       = LOAD_RELAXED(&sink->cons.writes);
+    out->bytes        = LOAD_RELAXED(&sink->cons.bytes);
+    out->write_errors = LOAD_RELAXED(&sink->cons.write_errors);
+    return RB_OK;
+}
+
+rb_ret_t hr_sink_destroy(hr_sink_t* sink, hr_sink_stats_t* stats)
+{
+    CHECK_IF_INIT(sink);
+
+    // A thread parked in rb_spsc_pop_wait() is only woken by a push, so a record follows
+    // the stop flag. It isn't written, see take_limit(). If the queue is full the thread
+    // isn't parked.
+    const hr_sink_rec_t wake = {0, 0, 0, 0};
+    STORE_RELEASE(&sink->stop, true);
+    rb_spsc_push(&sink->rb, &wake);
+    pthread_join(sink->thread, NULL);
+    if (stats != NULL)
+    {
+        hr_sink_stats(sink, stats);
+    }
+    sink->out = NULL;
+    return RB_OK;
+}
\ No newline at end of file
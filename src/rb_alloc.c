@@ -0,0 +1,184 @@
+#include "ring_buffer.h"
+
+#include <cerrno>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static inline size_t align_up(size_t val, size_t align)
+{
+    return (val + align - 1) / align * align;
+}
+
+static size_t gcd(size_t a, size_t b)
+{
+    while (b != 0)
+    {
+        const size_t rem = a % b;
+        a                = b;
+        b                = rem;
+    }
+    return a;
+}
+
+// returns the number of slots of the buffer that holds at least the given capacity
+static size_t slot_count(size_t cap, size_t el_size, size_t page, uint32_t opts)
+{
+    size_t slots = cap + 1;
+    if ((opts & RB_CREATE_POW2) != 0)
+    {
+        slots = 1;
+        while (slots < cap)
+        {
+            slots *= 2;
+        }
+    }
+
+    // The end of a mirrored buffer must fall on a page boundary, so the slots are a
+    // multiple of page / gcd(page, el_size). It is a power of two like the page size.
+    if ((opts & RB_CREATE_MIRROR) != 0)
+    {
+        slots = align_up(slots, page / gcd(page, el_size));
+    }
+    return slots;
+}
+
+// Reserves inaccessible address space of the given size aligned to the given alignment.
+// The pages are mapped over it with MAP_FIXED.
+static char* reserve(size_t size, size_t align)
+{
+    const size_t total = size + align;
+    const int    flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+    char*        map   = (char*)mmap(NULL, total, PROT_NONE, flags, -1, 0);
+    if (map == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    char*        base = (char*)align_up((uintptr_t)map, align);
+    const size_t tail = (size_t)((map + total) - (base + size));
+    if (base > map)
+    {
+        munmap(map, (size_t)(base - map));
+    }
+    if (tail > 0)
+    {
+        munmap(base + size, tail);
+    }
+    return base;
+}
+
+// maps anonymous memory over the reserved address space
+static bool map_private(char* base, size_t size, uint32_t opts)
+{
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED |
+                      (((opts & RB_CREATE_HUGETLB) != 0) ? MAP_HUGETLB : 0);
+    return mmap(base, size, PROT_READ | PROT_WRITE, flags, -1, 0) != MAP_FAILED;
+}
+
+// maps the same memfd twice back to back over the reserved address space
+static bool map_mirror(char* base, size_t size, uint32_t opts)
+{
+    const bool     hugetlb = (opts & RB_CREATE_HUGETLB) != 0;
+    const unsigned fdFlags = MFD_CLOEXEC | (hugetlb ? MFD_HUGETLB : 0);
+    const int      fd      = memfd_create("rb_mirror", fdFlags);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    const int  prot  = PROT_READ | PROT_WRITE;
+    const int  flags = MAP_SHARED | MAP_FIXED;
+    const bool ok    = (ftruncate(fd, (off_t)size) == 0) &&
+                    (mmap(base, size, prot, flags, fd, 0) != MAP_FAILED) &&
+                    (mmap(base + size, size, prot, flags, fd, 0) != MAP_FAILED);
+
+    // the mappings keep the memory alive
+    const int err = errno;
+    close(fd);
+    errno = err;
+    return ok;
+}
+
+rb_ret_t rb_create(ring_buffer_t* rb, size_t cap, size_t el_size, uint32_t opts)
+{
+    if ((rb == NULL) || (cap == 0) || (el_size == 0) ||
+        (cap > SIZE_MAX / 4 / RB_HUGE_PAGE_SIZE / el_size))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    const size_t sysPage = (size_t)sysconf(_SC_PAGESIZE);
+    const bool   hugetlb = (opts & RB_CREATE_HUGETLB) != 0;
+    const bool   huge    = hugetlb || ((opts & RB_CREATE_THP) != 0);
+    const size_t page    = hugetlb ? RB_HUGE_PAGE_SIZE : sysPage;
+    const size_t align   = huge ? RB_HUGE_PAGE_SIZE : sysPage;
+    const size_t slots   = slot_count(cap, el_size, page, opts);
+    const bool   mirror  = (opts & RB_CREATE_MIRROR) != 0;
+    const size_t size    = align_up(slots * el_size, page);
+    const size_t span    = mirror ? (2 * size) : size;
+
+    char* base = reserve(span, align);
+    if (base == NULL)
+    {
+        return RB_IO_ERROR;
+    }
+
+    bool ok = mirror ? map_mirror(base, size, opts) : map_private(base, size, opts);
+    if (ok && ((opts & RB_CREATE_THP) != 0))
+    {
+        // only a hint, fails when transparent huge pages are disabled
+        madvise(base, span, MADV_HUGEPAGE);
+    }
+    if (ok && ((opts & RB_CREATE_PREFAULT) != 0))
+    {
+        // writing faults in the pages, the second half of a mirror shares them
+        for (size_t off = 0; off < size; off += sysPage)
+        {
+            ((volatile char*)base)[off] = 0;
+        }
+    }
+    if (ok && ((opts & RB_CREATE_MLOCK) != 0))
+    {
+        ok = (mlock(base, span) == 0);
+    }
+    if (!ok)
+    {
+        const int err = errno;
+        munmap(base, span);
+        errno = err;
+        return RB_IO_ERROR;
+    }
+
+    if ((opts & RB_CREATE_POW2) != 0)
+    {
+        rb_init_pow2(rb, base, slots * el_size, el_size);
+    }
+    else
+    {
+        rb_init(rb, base, slots * el_size, el_size);
+    }
+    rb->map_size = span;
+    if (mirror)
+    {
+        rb->flags |= RB_FLAG_MIRRORED;
+    }
+    return RB_OK;
+}
+
+rb_ret_t rb_destroy(ring_buffer_t* rb)
+{
+    if ((rb == NULL) || (rb->buff == NULL))
+    {
+        return RB_NOT_INIT;
+    }
+    if (rb->map_size == 0)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    munmap(rb->buff, rb->map_size);
+    rb->buff     = NULL;
+    rb->cap      = 0;
+    rb->map_size = 0;
+    return RB_OK;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef RB_FUTEX_H
+#define RB_FUTEX_H
+
+// Thin wrappers of the Linux futex system call, internal to the library.
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// returns the current time of the monotonic clock in nanoseconds
+static inline int64_t rb_futex_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+// returns the deadline for a timeout in milliseconds, -1 if the timeout is infinite
+static inline int64_t rb_futex_deadline(int timeout_ms)
+{
+    return (timeout_ms < 0) ? -1 : (rb_futex_now_ns() + ((int64_t)timeout_ms * 1000000));
+}
+
+// Sleeps while the word holds the given value, until woken or the deadline (-1 for
+// none) passes. Returns false if the deadline has passed. Shared futexes work across
+// processes that map the same memory, private ones are cheaper within a process.
+static inline bool rb_futex_wait(uint32_t* word, uint32_t val, int64_t deadline,
+                                 bool shared)
+{
+    struct timespec  rel;
+    struct timespec* pRel = NULL;
+    if (deadline >= 0)
+    {
+        const int64_t left = deadline - rb_futex_now_ns();
+        if (left <= 0)
+        {
+            return false;
+        }
+        rel.tv_sec  = left / 1000000000;
+        rel.tv_nsec = left % 1000000000;
+        pRel        = &rel;
+    }
+
+    const int op = shared ? FUTEX_WAIT : (FUTEX_WAIT | FUTEX_PRIVATE_FLAG);
+    if ((syscall(SYS_futex, word, op, val, pRel, NULL, 0) != 0) && (errno == ETIMEDOUT))
+    {
+        return false;
+    }
+    // woken, interrupted or the value has already changed
+    return true;
+}
+
+// wakes up all threads sleeping on the word
+static inline void rb_futex_wake(uint32_t* word, bool shared)
+{
+    const int op = shared ? FUTEX_WAKE : (FUTEX_WAKE | FUTEX_PRIVATE_FLAG);
+    syscall(SYS_futex, word, op, INT32_MAX, NULL, NULL, 0);
+}
+
+#endif
\ No newline at end of file
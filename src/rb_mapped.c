@@ -0,0 +1,207 @@
+#include "rb_mapped.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CHECK_IF_INIT(mrb)                                                               \
+    if ((mrb == NULL) || (mrb->map == NULL))                                             \
+    return RB_NOT_INIT
+
+// FNV-1a hash of the given bytes continuing from the given hash
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t layout_checksum(const rb_mapped_hdr_t* hdr)
+{
+    return fnv1a(0xcbf29ce484222325ull, hdr, offsetof(rb_mapped_hdr_t, checksum));
+}
+
+static uint64_t slot_checksum(const rb_mapped_slot_t* slot)
+{
+    return fnv1a(0xcbf29ce484222325ull, slot, offsetof(rb_mapped_slot_t, checksum));
+}
+
+static inline rb_mapped_hdr_t* hdr_of(const rb_mapped_t* mrb)
+{
+    return (rb_mapped_hdr_t*)mrb->map;
+}
+
+// restores head and tail from the newest valid slot, an empty ring if there is none
+static void recover(rb_mapped_t* mrb)
+{
+    const rb_mapped_hdr_t*  hdr  = hdr_of(mrb);
+    const rb_mapped_slot_t* best = NULL;
+    for (size_t i = 0; i < 2; ++i)
+    {
+        const rb_mapped_slot_t* slot = &hdr->slots[i];
+        if ((slot->checksum == slot_checksum(slot)) && (slot->head < mrb->rb.cap) &&
+            (slot->tail < mrb->rb.cap) && ((best == NULL) || (slot->seq > best->seq)))
+        {
+            best = slot;
+        }
+    }
+
+    mrb->seq     = (best != NULL) ? best->seq : 0;
+    mrb->rb.head = (best != NULL) ? best->head : 0;
+    mrb->rb.tail = (best != NULL) ? best->tail : 0;
+}
+
+// checks the layout of an existing file or writes it to a new one
+static rb_ret_t attach_header(rb_mapped_hdr_t* hdr, size_t cap, size_t el_size,
+                              size_t data_offset)
+{
+    // a file that was created but whose header was never written is empty as well
+    if (hdr->magic == 0)
+    {
+        memset(hdr, 0, sizeof(*hdr));
+        hdr->version     = RB_MAPPED_VERSION;
+        hdr->el_size     = el_size;
+        hdr->cap         = cap;
+        hdr->data_offset = data_offset;
+        hdr->magic       = RB_MAPPED_MAGIC;
+        hdr->checksum    = layout_checksum(hdr);
+        return RB_OK;
+    }
+
+    if ((hdr->magic != RB_MAPPED_MAGIC) || (hdr->version != RB_MAPPED_VERSION) ||
+        (hdr->checksum != layout_checksum(hdr)) || (hdr->el_size != el_size) ||
+        (hdr->cap != cap) || (hdr->data_offset != data_offset))
+    {
+        return RB_INVALID_ARG;
+    }
+    return RB_OK;
+}
+
+rb_ret_t rb_open_mapped(rb_mapped_t* mrb, const char* path, size_t cap, size_t el_size)
+{
+    if ((mrb == NULL) || (path == NULL) || (cap == 0) || (el_size == 0))
+    {
+        return RB_INVALID_ARG;
+    }
+    mrb->map = NULL;
+
+    // the data keeps one free slot like every ring buffer initialized by rb_init()
+    const size_t dataOffset =
+        (sizeof(rb_mapped_hdr_t) + RB_CACHE_LINE_SIZE - 1) / RB_CACHE_LINE_SIZE *
+        RB_CACHE_LINE_SIZE;
+    const size_t dataSize = (cap + 1) * el_size;
+    const size_t mapSize  = dataOffset + dataSize;
+
+    const int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return RB_IO_ERROR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return RB_IO_ERROR;
+    }
+    if ((st.st_size == 0) && (ftruncate(fd, (off_t)mapSize) != 0))
+    {
+        close(fd);
+        return RB_IO_ERROR;
+    }
+    if ((st.st_size != 0) && ((size_t)st.st_size != mapSize))
+    {
+        close(fd);
+        return RB_INVALID_ARG;
+    }
+
+    void* map = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        close(fd);
+        return RB_IO_ERROR;
+    }
+
+    rb_ret_t ret = attach_header((rb_mapped_hdr_t*)map, cap, el_size, dataOffset);
+    if (ret == RB_OK)
+    {
+        ret = rb_init(&mrb->rb, (char*)map + dataOffset, dataSize, el_size);
+    }
+    if (ret != RB_OK)
+    {
+        munmap(map, mapSize);
+        close(fd);
+        return ret;
+    }
+
+    mrb->map        = map;
+    mrb->map_size   = mapSize;
+    mrb->fd         = fd;
+    mrb->sync_every = 0;
+    mrb->unsynced   = 0;
+    recover(mrb);
+    return RB_OK;
+}
+
+rb_ret_t rb_mapped_commit(rb_mapped_t* mrb)
+{
+    CHECK_IF_INIT(mrb);
+
+    // the elements must be stored before the indices that make them visible
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    mrb->seq++;
+    rb_mapped_slot_t* slot = &hdr_of(mrb)->slots[mrb->seq & 1];
+    slot->seq              = mrb->seq;
+    slot->head             = mrb->rb.head;
+    slot->tail             = mrb->rb.tail;
+    slot->checksum         = slot_checksum(slot);
+
+    mrb->unsynced++;
+    if ((mrb->sync_every > 0) && (mrb->unsynced >= mrb->sync_every))
+    {
+        return rb_mapped_sync(mrb);
+    }
+    return RB_OK;
+}
+
+rb_ret_t rb_mapped_set_sync(rb_mapped_t* mrb, size_t sync_every)
+{
+    CHECK_IF_INIT(mrb);
+
+    mrb->sync_every = sync_every;
+    return RB_OK;
+}
+
+rb_ret_t rb_mapped_sync(rb_mapped_t* mrb)
+{
+    CHECK_IF_INIT(mrb);
+
+    mrb->unsynced = 0;
+    if (msync(mrb->map, mrb->map_size, MS_SYNC) != 0)
+    {
+        return RB_IO_ERROR;
+    }
+    return RB_OK;
+}
+
+rb_ret_t rb_close_mapped(rb_mapped_t* mrb)
+{
+    CHECK_IF_INIT(mrb);
+
+    rb_ret_t ret = rb_mapped_commit(mrb);
+    if ((ret == RB_OK) && (mrb->unsynced > 0) && (mrb->sync_every > 0))
+    {
+        ret = rb_mapped_sync(mrb);
+    }
+
+    munmap(mrb->map, mrb->map_size);
+    close(mrb->fd);
+    mrb->map = NULL;
+    return ret;
+}
\ No newline at end of file
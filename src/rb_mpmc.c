@@ -0,0 +1,140 @@
+#include "rb_mpmc.h"
+
+#include <cstring>
+
+#define CHECK_IF_INIT(rb)                                                                \
+    if ((rb->cfg.buff == NULL) || (rb->cfg.el_size == 0))                                \
+    return RB_NOT_INIT
+
+// returns the sequence counter of the cell for the given position
+static inline size_t* cell_seq(const rb_mpmc_t* rb, size_t pos)
+{
+    return (size_t*)((char*)rb->cfg.buff + ((pos & rb->cfg.mask) * rb->cfg.cell_size));
+}
+
+// returns the element stored in the cell, it directly follows the sequence counter
+static inline void* cell_data(size_t* seq)
+{
+    return seq + 1;
+}
+
+rb_ret_t rb_mpmc_init(rb_mpmc_t* rb, void* buff, size_t buff_size, size_t el_size)
+{
+    if ((rb == NULL) || (buff == NULL) || (el_size == 0) ||
+        (((uintptr_t)buff % sizeof(size_t)) != 0))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    const size_t cellSize = RB_MPMC_CELL_SIZE(el_size);
+    const size_t nCells   = buff_size / cellSize;
+    if (nCells == 0)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    // round the number of cells down to a power of two so positions can be masked
+    size_t cap = 1;
+    while (cap <= nCells / 2)
+    {
+        cap *= 2;
+    }
+
+    rb->cfg.buff      = buff;
+    rb->cfg.mask      = cap - 1;
+    rb->cfg.el_size   = el_size;
+    rb->cfg.cell_size = cellSize;
+    rb->enq.pos       = 0;
+    rb->deq.pos       = 0;
+
+    // a cell with sequence equal to the position is free to be written at the position
+    for (size_t i = 0; i < cap; ++i)
+    {
+        *cell_seq(rb, i) = i;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return RB_OK;
+}
+
+rb_ret_t rb_mpmc_try_push(rb_mpmc_t* rb, const void* data)
+{
+    CHECK_IF_INIT(rb);
+
+    size_t* seq;
+    size_t  pos = __atomic_load_n(&rb->enq.pos, __ATOMIC_RELAXED);
+    while (1)
+    {
+        seq                 = cell_seq(rb, pos);
+        const size_t   cur  = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        const intptr_t diff = (intptr_t)cur - (intptr_t)pos;
+        if (diff == 0)
+        {
+            // cell is free, try to claim the position
+            if (__atomic_compare_exchange_n(&rb->enq.pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // cell still holds the element from the previous lap
+            return RB_FULL;
+        }
+        else
+        {
+            // another producer claimed the position
+            pos = __atomic_load_n(&rb->enq.pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(cell_data(seq), data, rb->cfg.el_size);
+
+    // publish the element to the consumer of this position
+    __atomic_store_n(seq, pos + 1, __ATOMIC_RELEASE);
+    return RB_OK;
+}
+
+rb_ret_t rb_mpmc_try_pop(rb_mpmc_t* rb, void* data_out)
+{
+    CHECK_IF_INIT(rb);
+
+    size_t* seq;
+    size_t  pos = __atomic_load_n(&rb->deq.pos, __ATOMIC_RELAXED);
+    while (1)
+    {
+        seq                 = cell_seq(rb, pos);
+        const size_t   cur  = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        const intptr_t diff = (intptr_t)cur - (intptr_t)(pos + 1);
+        if (diff == 0)
+        {
+            // cell is filled, try to claim the position
+            if (__atomic_compare_exchange_n(&rb->deq.pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // cell wasn't written yet
+            return RB_EMPTY;
+        }
+        else
+        {
+            // another consumer claimed the position
+            pos = __atomic_load_n(&rb->deq.pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(data_out, cell_data(seq), rb->cfg.el_size);
+
+    // release the cell to the producer of the next lap
+    __atomic_store_n(seq, pos + rb->cfg.mask + 1, __ATOMIC_RELEASE);
+    return RB_OK;
+}
+
+size_t rb_mpmc_capacity(rb_mpmc_t* rb)
+{
+    return (rb->cfg.buff == NULL) ? 0 : rb->cfg.mask + 1;
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "rb_shm.h"
+#include "rb_wait.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CHECK_IF_INIT(rb)                                                                \
+    if ((rb == NULL) || (rb->hdr == NULL))                                               \
+    return RB_NOT_INIT
+
+#define LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(ptr)       __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define STORE_RELEASE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+
+static inline size_t data_offset(void)
+{
+    return (sizeof(rb_shm_hdr_t) + RB_CACHE_LINE_SIZE - 1) / RB_CACHE_LINE_SIZE *
+           RB_CACHE_LINE_SIZE;
+}
+
+// maps the shared memory of the given descriptor and fills the handle
+static rb_ret_t map_fd(rb_shm_t* rb, int fd, size_t map_size)
+{
+    void* map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        return RB_IO_ERROR;
+    }
+
+    rb->hdr        = (rb_shm_hdr_t*)map;
+    rb->data       = (char*)map + data_offset();
+    rb->map_size   = map_size;
+    rb->fd         = fd;
+    rb->head_cache = 0;
+    rb->tail_cache = 0;
+    rb->spin_limit = RB_WAIT_SPIN_MIN;
+    return RB_OK;
+}
+
+// maps the ring buffer of an existing shared memory and checks its header
+static rb_ret_t attach(rb_shm_t* rb, int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        return RB_IO_ERROR;
+    }
+    if ((size_t)st.st_size < data_offset())
+    {
+        return RB_INVALID_ARG;
+    }
+
+    rb_ret_t ret = map_fd(rb, fd, (size_t)st.st_size);
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+
+    // the magic is published last by the creator
+    const rb_shm_hdr_t* hdr  = rb->hdr;
+    const size_t        size = data_offset() + (hdr->cfg.cap * hdr->cfg.el_size);
+    if ((LOAD_ACQUIRE(&hdr->cfg.magic) != RB_SHM_MAGIC) ||
+        (hdr->cfg.version != RB_SHM_VERSION) || (hdr->cfg.data_offset != data_offset()) ||
+        (hdr->cfg.el_size == 0) || (hdr->cfg.cap == 0) ||
+        ((hdr->cfg.cap & (hdr->cfg.cap - 1)) != 0) || (size > rb->map_size))
+    {
+        munmap(rb->hdr, rb->map_size);
+        rb->hdr = NULL;
+        return RB_INVALID_ARG;
+    }
+
+    rb->el_size    = hdr->cfg.el_size;
+    rb->mask       = hdr->cfg.cap - 1;
+    rb->head_cache = LOAD_ACQUIRE(&hdr->prod.head);
+    rb->tail_cache = LOAD_ACQUIRE(&hdr->cons.tail);
+    return RB_OK;
+}
+
+static inline char* el_ptr(const rb_shm_t* rb, uint64_t idx)
+{
+    return rb->data + ((idx & rb->mask) * rb->el_size);
+}
+
+rb_ret_t rb_shm_create(rb_shm_t* rb, const char* name, size_t cap, size_t el_size)
+{
+    if ((rb == NULL) || (cap == 0) || (el_size == 0))
+    {
+        return RB_INVALID_ARG;
+    }
+    rb->hdr = NULL;
+
+    // round the capacity down to a power of two
+    size_t pow2Cap = 1;
+    while (pow2Cap <= cap / 2)
+    {
+        pow2Cap *= 2;
+    }
+    const size_t mapSize = data_offset() + (pow2Cap * el_size);
+
+    const int fd = (name != NULL) ? shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600)
+                                  : memfd_create("rb_shm", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        return RB_IO_ERROR;
+    }
+
+    rb_ret_t ret = (ftruncate(fd, (off_t)mapSize) == 0) ? map_fd(rb, fd, mapSize)
+                                                        : RB_IO_ERROR;
+    if (ret != RB_OK)
+    {
+        close(fd);
+        if (name != NULL)
+        {
+            shm_unlink(name);
+        }
+        return ret;
+    }
+
+    // the new memory is zeroed, so the indices and the wait part are already reset
+    rb_shm_hdr_t* hdr    = rb->hdr;
+    hdr->cfg.version     = RB_SHM_VERSION;
+    hdr->cfg.el_size     = el_size;
+    hdr->cfg.cap         = pow2Cap;
+    hdr->cfg.data_offset = data_offset();
+    STORE_RELEASE(&hdr->cfg.magic, RB_SHM_MAGIC);
+
+    rb->el_size = el_size;
+    rb->mask    = pow2Cap - 1;
+    return RB_OK;
+}
+
+rb_ret_t rb_shm_attach(rb_shm_t* rb, const char* name)
+{
+    if ((rb == NULL) || (name == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+    rb->hdr = NULL;
+
+    const int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+    {
+        return RB_IO_ERROR;
+    }
+
+    rb_ret_t ret = attach(rb, fd);
+    if (ret != RB_OK)
+    {
+        close(fd);
+    }
+    return ret;
+}
+
+rb_ret_t rb_shm_attach_fd(rb_shm_t* rb, int fd)
+{
+    if ((rb == NULL) || (fd < 0))
+    {
+        return RB_INVALID_ARG;
+    }
+    rb->hdr = NULL;
+
+    const int dupFd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (dupFd < 0)
+    {
+        return RB_IO_ERROR;
+    }
+
+    rb_ret_t ret = attach(rb, dupFd);
+    if (ret != RB_OK)
+    {
+        close(dupFd);
+    }
+    return ret;
+}
+
+int rb_shm_fd(const rb_shm_t* rb)
+{
+    return ((rb == NULL) || (rb->hdr == NULL)) ? -1 : rb->fd;
+}
+
+rb_ret_t rb_shm_close(rb_shm_t* rb)
+{
+    CHECK_IF_INIT(rb);
+
+    munmap(rb->hdr, rb->map_size);
+    close(rb->fd);
+    rb->hdr = NULL;
+    return RB_OK;
+}
+
+rb_ret_t rb_shm_unlink(const char* name)
+{
+    return (shm_unlink(name) == 0) ? RB_OK : RB_IO_ERROR;
+}
+
+rb_ret_t rb_shm_push(rb_shm_t* rb, const void* data)
+{
+    CHECK_IF_INIT(rb);
+
+    rb_shm_hdr_t*  hdr  = rb->hdr;
+    const uint64_t head = LOAD_RELAXED(&hdr->prod.head);
+    if (head - rb->tail_cache > rb->mask)
+    {
+        rb->tail_cache = LOAD_ACQUIRE(&hdr->cons.tail);
+        if (head - rb->tail_cache > rb->mask)
+        {
+            return RB_FULL;
+        }
+    }
+
+    memcpy(el_ptr(rb, head), data, rb->el_size);
+
+    STORE_RELEASE(&hdr->prod.head, head + 1);
+    rb_wait_wake(&hdr->wait.cons_waiting, &hdr->wait.data_seq, true);
+    return RB_OK;
+}
+
+rb_ret_t rb_shm_pop(rb_shm_t* rb, void* data_out)
+{
+    CHECK_IF_INIT(rb);
+
+    rb_shm_hdr_t*  hdr  = rb->hdr;
+    const uint64_t tail = LOAD_RELAXED(&hdr->cons.tail);
+    if (tail == rb->head_cache)
+    {
+        rb->head_cache = LOAD_ACQUIRE(&hdr->prod.head);
+        if (tail == rb->head_cache)
+        {
+            return RB_EMPTY;
+        }
+    }
+
+    memcpy(data_out, el_ptr(rb, tail), rb->el_size);
+
+    STORE_RELEASE(&hdr->cons.tail, tail + 1);
+    rb_wait_wake(&hdr->wait.prod_waiting, &hdr->wait.space_seq, true);
+    return RB_OK;
+}
+
+static rb_ret_t push_op(void* rb, void* data)
+{
+    return rb_shm_push((rb_shm_t*)rb, data);
+}
+
+static rb_ret_t pop_op(void* rb, void* data_out)
+{
+    return rb_shm_pop((rb_shm_t*)rb, data_out);
+}
+
+rb_ret_t rb_shm_push_wait(rb_shm_t* rb, const void* data, int timeout_ms)
+{
+    CHECK_IF_INIT(rb);
+
+    return rb_wait_until(push_op, rb, (void*)data, RB_FULL, &rb->hdr->wait.prod_waiting,
+                         &rb->hdr->wait.space_seq, &rb->spin_limit, timeout_ms, true);
+}
+
+rb_ret_t rb_shm_pop_wait(rb_shm_t* rb, void* data_out, int timeout_ms)
+{
+    CHECK_IF_INIT(rb);
+
+    return rb_wait_until(pop_op, rb, data_out, RB_EMPTY, &rb->hdr->wait.cons_waiting,
+                         &rb->hdr->wait.data_seq, &rb->spin_limit, timeout_ms, true);
+}
\ No newline at end of file
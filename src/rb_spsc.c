@@ -0,0 +1,401 @@
+#include "rb_spsc.h"
+#include "rb_wait.h"
+
+#include <cstring>
+
+#define CHECK_IF_INIT(rb)                                                                \
+    if ((rb->cfg.buff == NULL) || (rb->cfg.cap == 0) || (rb->cfg.el_size == 0))          \
+    return RB_NOT_INIT
+
+#define LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(ptr)       __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define STORE_RELEASE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+
+// counters are written by one thread only, the atomic store lets other threads read them
+#define STAT_INC(ptr) __atomic_store_n(ptr, (*(ptr)) + 1, __ATOMIC_RELAXED)
+
+// returns the index following the given one, wrapping at the end of the buffer
+static inline size_t next_idx(const rb_spsc_t* rb, size_t idx)
+{
+    idx++;
+    return (idx >= rb->cfg.cap) ? 0 : idx;
+}
+
+// returns the address of the element in the given slot
+static inline char* el_ptr(const rb_spsc_t* rb, size_t slot)
+{
+    return (char*)rb->cfg.buff + (slot * rb->cfg.el_size);
+}
+
+// returns the number of elements between the given tail and head
+static inline size_t used_count(const rb_spsc_t* rb, size_t head, size_t tail)
+{
+    if (rb->cfg.overwrite || (head >= tail))
+    {
+        return head - tail;
+    }
+    return rb->cfg.cap - tail + head;
+}
+
+// Counts a push of the producer. The cached tail is never newer than the real one, so
+// the size it gives is an upper bound. The real tail is only loaded when that bound
+// exceeds the high-water mark, which keeps the mark exact with rare shared reads.
+static inline void stat_pushed(rb_spsc_t* rb, size_t head)
+{
+#ifdef RB_ENABLE_STATS
+    STAT_INC(&rb->prod.pushes);
+    if (used_count(rb, head, rb->prod.tail_cache) > rb->prod.high_water)
+    {
+        rb->prod.tail_cache = LOAD_ACQUIRE(&rb->cons.tail);
+        const size_t size   = used_count(rb, head, rb->prod.tail_cache);
+        if (size > rb->prod.high_water)
+        {
+            __atomic_store_n(&rb->prod.high_water, size, __ATOMIC_RELAXED);
+        }
+    }
+#else
+    (void)rb;
+    (void)head;
+#endif
+}
+
+// In the overwrite mode head and tail are free-running counters masked on access. The
+// producer may move the tail to evict the oldest element, so both sides move it with a
+// compare-and-swap. Counters never repeat, so a consumer that lost the race against an
+// eviction always notices it.
+static rb_ret_t ow_push(rb_spsc_t* rb, const void* data, bool overwrite,
+                        void* evicted_out, bool* evicted)
+{
+    const size_t head    = LOAD_RELAXED(&rb->prod.head);
+    bool         removed = false;
+
+    // the tail only moves forward, so a cached value that leaves free space is valid
+    if (head - rb->prod.tail_cache == rb->cfg.cap)
+    {
+        size_t tail = LOAD_ACQUIRE(&rb->cons.tail);
+        while (head - tail == rb->cfg.cap)
+        {
+            if (!overwrite)
+            {
+                rb->prod.tail_cache = tail;
+#ifdef RB_ENABLE_STATS
+                STAT_INC(&rb->prod.full_rejects);
+#endif
+                return RB_FULL;
+            }
+
+            // only the producer writes elements, the slot can be copied before claiming
+            if (evicted_out != NULL)
+            {
+                memcpy(evicted_out, el_ptr(rb, tail & rb->cfg.mask), rb->cfg.el_size);
+            }
+            if (__atomic_compare_exchange_n(&rb->cons.tail, &tail, tail + 1, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                removed = true;
+                tail++;
+#ifdef RB_ENABLE_STATS
+                STAT_INC(&rb->prod.overwrites);
+#endif
+            }
+        }
+        rb->prod.tail_cache = tail;
+    }
+    if (evicted != NULL)
+    {
+        (*evicted) = removed;
+    }
+
+    memcpy(el_ptr(rb, head & rb->cfg.mask), data, rb->cfg.el_size);
+
+    STORE_RELEASE(&rb->prod.head, head + 1);
+    stat_pushed(rb, head + 1);
+    rb_wait_wake(&rb->wait.cons_waiting, &rb->wait.data_seq, false);
+    return RB_OK;
+}
+
+static rb_ret_t ow_pop(rb_spsc_t* rb, void* data_out)
+{
+    size_t tail = LOAD_ACQUIRE(&rb->cons.tail);
+    while (1)
+    {
+        // an eviction may move the tail past the cached head
+        if ((intptr_t)(rb->cons.head_cache - tail) <= 0)
+        {
+            rb->cons.head_cache = LOAD_ACQUIRE(&rb->prod.head);
+            if (rb->cons.head_cache == tail)
+            {
+#ifdef RB_ENABLE_STATS
+                STAT_INC(&rb->cons.empty_rejects);
+#endif
+                return RB_EMPTY;
+            }
+        }
+
+        memcpy(data_out, el_ptr(rb, tail & rb->cfg.mask), rb->cfg.el_size);
+
+        // fails if the producer evicted the element meanwhile, the copy is discarded
+        if (__atomic_compare_exchange_n(&rb->cons.tail, &tail, tail + 1, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+#ifdef RB_ENABLE_STATS
+            STAT_INC(&rb->cons.pops);
+#endif
+            rb_wait_wake(&rb->wait.prod_waiting, &rb->wait.space_seq, false);
+            return RB_OK;
+        }
+    }
+}
+
+rb_ret_t rb_spsc_init(rb_spsc_t* rb, void* buff, size_t buff_size, size_t el_size)
+{
+    if ((rb == NULL) || (buff == NULL) || (el_size == 0) || (buff_size < el_size))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    rb->cfg.buff        = buff;
+    rb->cfg.cap         = buff_size / el_size;
+    rb->cfg.el_size     = el_size;
+    rb->cfg.mask        = 0;
+    rb->cfg.overwrite   = false;
+    rb->prod.head       = 0;
+    rb->prod.tail_cache = 0;
+    rb->cons.tail       = 0;
+    rb->cons.head_cache = 0;
+    rb->prod.spin_limit = RB_WAIT_SPIN_MIN;
+    rb->cons.spin_limit = RB_WAIT_SPIN_MIN;
+
+    rb->wait.data_seq     = 0;
+    rb->wait.space_seq    = 0;
+    rb->wait.cons_waiting = 0;
+    rb->wait.prod_waiting = 0;
+#ifdef RB_ENABLE_STATS
+    rb->prod.pushes        = 0;
+    rb->prod.full_rejects  = 0;
+    rb->prod.overwrites    = 0;
+    rb->prod.high_water    = 0;
+    rb->cons.pops          = 0;
+    rb->cons.empty_rejects = 0;
+#endif
+    rb_wait_init();
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return RB_OK;
+}
+
+rb_ret_t rb_spsc_init_overwrite(rb_spsc_t* rb, void* buff, size_t buff_size,
+                                size_t el_size)
+{
+    rb_ret_t ret = rb_spsc_init(rb, buff, buff_size, el_size);
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+
+    // round the capacity down to a power of two
+    size_t cap = 1;
+    while (cap <= rb->cfg.cap / 2)
+    {
+        cap *= 2;
+    }
+
+    rb->cfg.cap       = cap;
+    rb->cfg.mask      = cap - 1;
+    rb->cfg.overwrite = true;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return RB_OK;
+}
+
+rb_ret_t rb_spsc_push(rb_spsc_t* rb, const void* data)
+{
+    CHECK_IF_INIT(rb);
+
+    if (rb->cfg.overwrite)
+    {
+        return ow_push(rb, data, false, NULL, NULL);
+    }
+
+    // the head is only written by this thread, no ordering is required to read it
+    const size_t head     = LOAD_RELAXED(&rb->prod.head);
+    const size_t nextHead = next_idx(rb, head);
+    if (nextHead == rb->prod.tail_cache)
+    {
+        rb->prod.tail_cache = LOAD_ACQUIRE(&rb->cons.tail);
+        if (nextHead == rb->prod.tail_cache)
+        {
+#ifdef RB_ENABLE_STATS
+            STAT_INC(&rb->prod.full_rejects);
+#endif
+            return RB_FULL;
+        }
+    }
+
+    memcpy(el_ptr(rb, head), data, rb->cfg.el_size);
+
+    STORE_RELEASE(&rb->prod.head, nextHead);
+    stat_pushed(rb, nextHead);
+    rb_wait_wake(&rb->wait.cons_waiting, &rb->wait.data_seq, false);
+    return RB_OK;
+}
+
+rb_ret_t rb_spsc_push_overwrite(rb_spsc_t* rb, const void* data, void* evicted_out,
+                                bool* evicted)
+{
+    CHECK_IF_INIT(rb);
+
+    if (!rb->cfg.overwrite)
+    {
+        return RB_INVALID_ARG;
+    }
+    return ow_push(rb, data, true, evicted_out, evicted);
+}
+
+rb_ret_t rb_spsc_pop(rb_spsc_t* rb, void* data_out)
+{
+    CHECK_IF_INIT(rb);
+
+    if (rb->cfg.overwrite)
+    {
+        return ow_pop(rb, data_out);
+    }
+
+    const size_t tail = LOAD_RELAXED(&rb->cons.tail);
+    if (tail == rb->cons.head_cache)
+    {
+        rb->cons.head_cache = LOAD_ACQUIRE(&rb->prod.head);
+        if (tail == rb->cons.head_cache)
+        {
+#ifdef RB_ENABLE_STATS
+            STAT_INC(&rb->cons.empty_rejects);
+#endif
+            return RB_EMPTY;
+        }
+    }
+
+    memcpy(data_out, el_ptr(rb, tail), rb->cfg.el_size);
+
+    STORE_RELEASE(&rb->cons.tail, next_idx(rb, tail));
+#ifdef RB_ENABLE_STATS
+    STAT_INC(&rb->cons.pops);
+#endif
+    rb_wait_wake(&rb->wait.prod_waiting, &rb->wait.space_seq, false);
+    return RB_OK;
+}
+
+rb_ret_t rb_spsc_pop_n(rb_spsc_t* rb, void* data_out, size_t n, size_t* popped)
+{
+    CHECK_IF_INIT(rb);
+
+    char*  out   = (char*)data_out;
+    size_t count = 0;
+    if (rb->cfg.overwrite)
+    {
+        // an evicting producer may move the tail at any time, elements go one by one
+        while ((count < n) && (ow_pop(rb, out + (count * rb->cfg.el_size)) == RB_OK))
+        {
+            count++;
+        }
+    }
+    else if (n > 0)
+    {
+        const size_t tail = LOAD_RELAXED(&rb->cons.tail);
+        if (used_count(rb, rb->cons.head_cache, tail) < n)
+        {
+            rb->cons.head_cache = LOAD_ACQUIRE(&rb->prod.head);
+        }
+        const size_t used = used_count(rb, rb->cons.head_cache, tail);
+        count             = (used < n) ? used : n;
+
+        const size_t first = (rb->cfg.cap - tail < count) ? rb->cfg.cap - tail : count;
+        memcpy(out, el_ptr(rb, tail), first * rb->cfg.el_size);
+        memcpy(out + (first * rb->cfg.el_size), el_ptr(rb, 0),
+               (count - first) * rb->cfg.el_size);
+
+        size_t next = tail + count;
+        next        = (next >= rb->cfg.cap) ? next - rb->cfg.cap : next;
+        if (count > 0)
+        {
+            STORE_RELEASE(&rb->cons.tail, next);
+#ifdef RB_ENABLE_STATS
+            __atomic_store_n(&rb->cons.pops, rb->cons.pops + count, __ATOMIC_RELAXED);
+#endif
+            rb_wait_wake(&rb->wait.prod_waiting, &rb->wait.space_seq, false);
+        }
+#ifdef RB_ENABLE_STATS
+        else
+        {
+            STAT_INC(&rb->cons.empty_rejects);
+        }
+#endif
+    }
+
+    if (popped != NULL)
+    {
+        (*popped) = count;
+    }
+    return ((count == 0) && (n > 0)) ? RB_EMPTY : RB_OK;
+}
+
+static rb_ret_t push_op(void* rb, void* data)
+{
+    return rb_spsc_push((rb_spsc_t*)rb, data);
+}
+
+static rb_ret_t pop_op(void* rb, void* data_out)
+{
+    return rb_spsc_pop((rb_spsc_t*)rb, data_out);
+}
+
+rb_ret_t rb_spsc_push_wait(rb_spsc_t* rb, const void* data, int timeout_ms)
+{
+    CHECK_IF_INIT(rb);
+
+    return rb_wait_until(push_op, rb, (void*)data, RB_FULL, &rb->wait.prod_waiting,
+                         &rb->wait.space_seq, &rb->prod.spin_limit, timeout_ms, false);
+}
+
+rb_ret_t rb_spsc_pop_wait(rb_spsc_t* rb, void* data_out, int timeout_ms)
+{
+    CHECK_IF_INIT(rb);
+
+    return rb_wait_until(pop_op, rb, data_out, RB_EMPTY, &rb->wait.cons_waiting,
+                         &rb->wait.data_seq, &rb->cons.spin_limit, timeout_ms, false);
+}
+
+bool rb_spsc_is_empty(rb_spsc_t* rb)
+{
+    return LOAD_ACQUIRE(&rb->cons.tail) == LOAD_ACQUIRE(&rb->prod.head);
+}
+
+bool rb_spsc_is_full(rb_spsc_t* rb)
+{
+    const size_t head = LOAD_ACQUIRE(&rb->prod.head);
+    const size_t tail = LOAD_ACQUIRE(&rb->cons.tail);
+    if (rb->cfg.overwrite)
+    {
+        return (head - tail) == rb->cfg.cap;
+    }
+    return next_idx(rb, head) == tail;
+}
+
+rb_ret_t rb_spsc_stats_snapshot(rb_spsc_t* rb, rb_stats_t* out)
+{
+#ifdef RB_ENABLE_STATS
+    if ((rb == NULL) || (out == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    out->pushes        = LOAD_RELAXED(&rb->prod.pushes);
+    out->full_rejects  = LOAD_RELAXED(&rb->prod.full_rejects);
+    out->overwrites    = LOAD_RELAXED(&rb->prod.overwrites);
+    out->high_water    = LOAD_RELAXED(&rb->prod.high_water);
+    out->pops          = LOAD_RELAXED(&rb->cons.pops);
+    out->empty_rejects = LOAD_RELAXED(&rb->cons.empty_rejects);
+    return RB_OK;
+#else
+    (void)rb;
+    (void)out;
+    return RB_UNSUPPORTED;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "rb_var.h"
+
+#include <cstring>
+
+#define CHECK_IF_INIT(rb)                                                                \
+    if ((rb == NULL) || (rb->buff == NULL))                                              \
+    return RB_NOT_INIT
+
+// length in the header of the record that only marks the wrap to the start of the buffer
+#define WRAP_MARKER UINT32_MAX
+
+static inline size_t align_up(size_t val, size_t align)
+{
+    return (val + align - 1) / align * align;
+}
+
+// returns the space taken by a record with the given payload size
+static inline size_t rec_size(size_t len)
+{
+    return RB_VAR_HDR_SIZE + align_up(len, RB_VAR_ALIGN);
+}
+
+static inline uint32_t read_len(const rb_var_t* rb, size_t off)
+{
+    uint32_t len;
+    memcpy(&len, rb->buff + off, sizeof(len));
+    return len;
+}
+
+static inline void write_len(rb_var_t* rb, size_t off, uint32_t len)
+{
+    memcpy(rb->buff + off, &len, sizeof(len));
+}
+
+// returns the offset of the oldest record, skipping the wrap marker
+static inline size_t oldest_off(rb_var_t* rb)
+{
+    if (read_len(rb, rb->tail) == WRAP_MARKER)
+    {
+        rb->tail = 0;
+    }
+    return rb->tail;
+}
+
+rb_ret_t rb_var_init(rb_var_t* rb, void* buff, size_t buff_size)
+{
+    if ((rb == NULL) || (buff == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    const uintptr_t start = align_up((uintptr_t)buff, RB_VAR_ALIGN);
+    const uintptr_t end   = ((uintptr_t)buff + buff_size) / RB_VAR_ALIGN * RB_VAR_ALIGN;
+    // head must stay behind the tail, so a record leaves at least one unit free
+    if ((end <= start) || (end - start < RB_VAR_HDR_SIZE + (2 * RB_VAR_ALIGN)))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    rb->buff     = (char*)start;
+    rb->size     = end - start;
+    rb->head     = 0;
+    rb->tail     = 0;
+    rb->count    = 0;
+    rb->res_off  = 0;
+    rb->res_len  = 0;
+    rb->res_wrap = false;
+    return RB_OK;
+}
+
+size_t rb_var_max_len(const rb_var_t* rb)
+{
+    if ((rb == NULL) || (rb->buff == NULL))
+    {
+        return 0;
+    }
+
+    const size_t maxLen = rb->size - RB_VAR_HDR_SIZE - RB_VAR_ALIGN;
+    const size_t limit  = (size_t)(WRAP_MARKER - 1) / RB_VAR_ALIGN * RB_VAR_ALIGN;
+    return (maxLen < limit) ? maxLen : limit;
+}
+
+rb_ret_t rb_var_reserve(rb_var_t* rb, size_t len, void** ptr)
+{
+    CHECK_IF_INIT(rb);
+
+    if ((ptr == NULL) || (len == 0) || (len > rb_var_max_len(rb)))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    // an empty buffer starts over to have the largest contiguous space
+    if (rb->head == rb->tail)
+    {
+        rb->head = 0;
+        rb->tail = 0;
+    }
+
+    const size_t need = rec_size(len);
+    size_t       off  = rb->head;
+    bool         wrap = false;
+    if (rb->head >= rb->tail)
+    {
+        // the head may reach the end of the buffer unless it would wrap onto the tail
+        const size_t end = rb->head + need;
+        if ((end > rb->size) || ((end == rb->size) && (rb->tail == 0)))
+        {
+            if (need >= rb->tail)
+            {
+                return RB_FULL;
+            }
+            off  = 0;
+            wrap = true;
+        }
+    }
+    else if (rb->head + need >= rb->tail)
+    {
+        return RB_FULL;
+    }
+
+    rb->res_off  = off;
+    rb->res_len  = len;
+    rb->res_wrap = wrap;
+    (*ptr)       = rb->buff + off + RB_VAR_HDR_SIZE;
+    return RB_OK;
+}
+
+rb_ret_t rb_var_commit(rb_var_t* rb, size_t len)
+{
+    CHECK_IF_INIT(rb);
+
+    if ((rb->res_len == 0) || (len > rb->res_len))
+    {
+        return RB_INVALID_ARG;
+    }
+    rb->res_len = 0;
+    if (len == 0)
+    {
+        return RB_OK;
+    }
+
+    if (rb->res_wrap)
+    {
+        write_len(rb, rb->head, WRAP_MARKER);
+    }
+    write_len(rb, rb->res_off, (uint32_t)len);
+
+    rb->head = rb->res_off + rec_size(len);
+    if (rb->head == rb->size)
+    {
+        rb->head = 0;
+    }
+    rb->count++;
+    return RB_OK;
+}
+
+rb_ret_t rb_var_push(rb_var_t* rb, const void* data, size_t len)
+{
+    CHECK_IF_INIT(rb);
+
+    if (data == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    void*    ptr;
+    rb_ret_t ret = rb_var_reserve(rb, len, &ptr);
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+    memcpy(ptr, data, len);
+    return rb_var_commit(rb, len);
+}
+
+rb_ret_t rb_var_peek(rb_var_t* rb, const void** ptr, size_t* len)
+{
+    CHECK_IF_INIT(rb);
+
+    if ((ptr == NULL) || (len == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+    if (rb->head == rb->tail)
+    {
+        return RB_EMPTY;
+    }
+
+    const size_t off = oldest_off(rb);
+    (*ptr)           = rb->buff + off + RB_VAR_HDR_SIZE;
+    (*len)           = read_len(rb, off);
+    return RB_OK;
+}
+
+rb_ret_t rb_var_release(rb_var_t* rb)
+{
+    CHECK_IF_INIT(rb);
+
+    if (rb->head == rb->tail)
+    {
+        return RB_EMPTY;
+    }
+
+    const size_t off = oldest_off(rb);
+    rb->tail         = off + rec_size(read_len(rb, off));
+    if (rb->tail == rb->size)
+    {
+        rb->tail = 0;
+    }
+    rb->count--;
+    return RB_OK;
+}
+
+rb_ret_t rb_var_init_read_it(const rb_var_t* rb, rb_var_it_t* it)
+{
+    if (it == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    CHECK_IF_INIT(rb);
+
+    it->rb  = rb;
+    it->off = rb->tail;
+    return RB_OK;
+}
+
+rb_ret_t rb_var_next(rb_var_it_t* it, const void** ptr, size_t* len)
+{
+    if ((it == NULL) || (ptr == NULL) || (len == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+    if ((it->rb == NULL) || (it->rb->buff == NULL))
+    {
+        return RB_NOT_INIT;
+    }
+
+    const rb_var_t* rb = it->rb;
+    if (it->off == rb->head)
+    {
+        return RB_EMPTY;
+    }
+    if (read_len(rb, it->off) == WRAP_MARKER)
+    {
+        it->off = 0;
+    }
+
+    (*ptr)  = rb->buff + it->off + RB_VAR_HDR_SIZE;
+    (*len)  = read_len(rb, it->off);
+    it->off += rec_size(*len);
+    if (it->off == rb->size)
+    {
+        it->off = 0;
+    }
+    return RB_OK;
+}
+
+size_t rb_var_count(const rb_var_t* rb)
+{
+    return ((rb == NULL) || (rb->buff == NULL)) ? 0 : rb->count;
+}
\ No newline at end of file
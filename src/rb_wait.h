@@ -0,0 +1,138 @@
+#ifndef RB_WAIT_H
+#define RB_WAIT_H
+
+// Spin-then-park waiting shared by the concurrent ring buffers, internal to the library.
+//
+// A waiter sets its flag and then retries the operation, the other side publishes its
+// index and then checks the flag. Either the retry succeeds or the flag is seen and a
+// wake-up is issued, as long as both sides order their store before their load. Within
+// one process the ordering is made asymmetric: the waiter issues a membarrier that
+// serializes all threads of the process, so the fast path only needs a compiler
+// barrier. Processes sharing memory always use full fences on both sides.
+
+#include "ring_buffer.h"
+#include "rb_futex.h"
+
+#include <linux/membarrier.h>
+
+#define RB_WAIT_SPIN_MIN 16U
+#define RB_WAIT_SPIN_MAX 4096U
+
+// 0 - not registered yet, 1 - membarrier is available, -1 - it isn't. Every translation
+// unit has its own copy, it's only used by those that wait within one process.
+static int rb_wait_membarrier_state = 0;
+
+static inline void rb_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// registers the process for expedited membarriers, called before the first wait
+static inline void rb_wait_init(void)
+{
+    if (__atomic_load_n(&rb_wait_membarrier_state, __ATOMIC_ACQUIRE) != 0)
+    {
+        return;
+    }
+    const int state =
+        (syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0)
+            ? 1
+            : -1;
+    __atomic_store_n(&rb_wait_membarrier_state, state, __ATOMIC_RELEASE);
+}
+
+// orders the preceding index store before the following waiter flag load
+static inline void rb_wait_light_barrier(bool shared)
+{
+    if (!shared && (__atomic_load_n(&rb_wait_membarrier_state, __ATOMIC_RELAXED) == 1))
+    {
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    }
+    else
+    {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+}
+
+// orders the preceding waiter flag store before the following index load
+static inline void rb_wait_heavy_barrier(bool shared)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!shared && (__atomic_load_n(&rb_wait_membarrier_state, __ATOMIC_RELAXED) == 1))
+    {
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+    }
+}
+
+// wakes up the other side if it has registered as a waiter
+static inline void rb_wait_wake(uint32_t* waiting, uint32_t* seq, bool shared)
+{
+    rb_wait_light_barrier(shared);
+    if (__atomic_load_n(waiting, __ATOMIC_RELAXED) != 0)
+    {
+        __atomic_fetch_add(seq, 1, __ATOMIC_RELEASE);
+        rb_futex_wake(seq, shared);
+    }
+}
+
+typedef rb_ret_t (*rb_wait_op_t)(void* rb, void* arg);
+
+// Retries the operation while it fails with the busy code. It first spins up to the
+// adaptive limit, which grows when spinning pays off and shrinks when the waiter has to
+// park, and then sleeps on the sequence word until woken or the timeout passes.
+static inline rb_ret_t rb_wait_until(rb_wait_op_t op, void* rb, void* arg,
+                                     rb_ret_t busy, uint32_t* waiting, uint32_t* seq,
+                                     uint32_t* spin_limit, int timeout_ms, bool shared)
+{
+    rb_ret_t ret = op(rb, arg);
+    if ((ret != busy) || (timeout_ms == 0))
+    {
+        return ret;
+    }
+
+    for (uint32_t i = 0; i < (*spin_limit); ++i)
+    {
+        rb_cpu_relax();
+        ret = op(rb, arg);
+        if (ret != busy)
+        {
+            if ((*spin_limit) < RB_WAIT_SPIN_MAX)
+            {
+                (*spin_limit) *= 2;
+            }
+            return ret;
+        }
+    }
+    if ((*spin_limit) > RB_WAIT_SPIN_MIN)
+    {
+        (*spin_limit) /= 2;
+    }
+
+    const int64_t deadline = rb_futex_deadline(timeout_ms);
+    while (1)
+    {
+        const uint32_t seen = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        __atomic_store_n(waiting, 1, __ATOMIC_RELAXED);
+        rb_wait_heavy_barrier(shared);
+
+        ret = op(rb, arg);
+        const bool woken = (ret == busy) && rb_futex_wait(seq, seen, deadline, shared);
+        __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+        if (!woken)
+        {
+            return ret;
+        }
+
+        ret = op(rb, arg);
+        if (ret != busy)
+        {
+            return ret;
+        }
+    }
+}
+
+#endif
\ No newline at end of file
@@ -6,14 +6,160 @@
     if ((rb->buff == NULL) || (rb->cap == 0) || (rb->el_size == 0))                      \
     return RB_NOT_INIT
 
-// increments the index of the ring buffer and moves it to the beginning if the index has
-// reached the end of the buffer
-static void increment_idx(ring_buffer_t* rb, size_t* const idx)
+// In the default mode head, tail and iterator indices are slot numbers that wrap at the
+// capacity and one slot is kept free to distinguish full and empty buffer. In the power
+// of two mode they are free-running counters, the slot is obtained by masking and all
+// slots are used.
+static inline bool is_pow2(const ring_buffer_t* rb)
 {
-    (*idx)++;
-    if (*idx >= rb->cap)
+    return (rb->flags & RB_FLAG_POW2) != 0;
+}
+
+// returns the slot number of the given index
+static inline size_t slot_of(const ring_buffer_t* rb, size_t idx)
+{
+    return is_pow2(rb) ? (idx & rb->mask) : idx;
+}
+
+// returns the address of the element at the given index
+static inline char* el_ptr(const ring_buffer_t* rb, size_t idx)
+{
+    return (char*)rb->buff + (slot_of(rb, idx) * rb->el_size);
+}
+
+// moves the index of the ring buffer forward by the given number of elements, the count
+// must not exceed the capacity
+static inline void advance_idx(const ring_buffer_t* rb, size_t* const idx, size_t count)
+{
+    (*idx) += count;
+    if (!is_pow2(rb) && (*idx >= rb->cap))
+    {
+        (*idx) -= rb->cap;
+    }
+}
+
+// moves the index of the ring buffer back by one element
+static inline void retreat_idx(const ring_buffer_t* rb, size_t* const idx)
+{
+    if (!is_pow2(rb) && (*idx == 0))
+    {
+        (*idx) = rb->cap;
+    }
+    (*idx)--;
+}
+
+// returns the number of elements between the given index and the head
+static inline size_t count_to_head(const ring_buffer_t* rb, size_t idx)
+{
+    if (is_pow2(rb) || (rb->head >= idx))
+    {
+        return rb->head - idx;
+    }
+    return rb->cap - idx + rb->head;
+}
+
+// returns the number of elements that can still be added
+static inline size_t free_count(const ring_buffer_t* rb)
+{
+    const size_t usable = is_pow2(rb) ? rb->cap : (rb->cap - 1);
+    return usable - count_to_head(rb, rb->tail);
+}
+
+// Returns the number of slots from the given index up to the end of the buffer. The
+// slots after the end of a mirrored buffer are the same memory as its beginning, so any
+// run of up to the capacity is contiguous.
+static inline size_t count_to_end(const ring_buffer_t* rb, size_t idx)
+{
+    if ((rb->flags & RB_FLAG_MIRRORED) != 0)
+    {
+        return rb->cap;
+    }
+    return rb->cap - slot_of(rb, idx);
+}
+
+// counts elements added to the buffer and updates the high-water mark
+static inline void stat_pushed(ring_buffer_t* rb, size_t count)
+{
+#ifdef RB_ENABLE_STATS
+    const size_t size = count_to_head(rb, rb->tail);
+    rb->stats.pushes += count;
+    if (size > rb->stats.high_water)
+    {
+        rb->stats.high_water = size;
+    }
+#else
+    (void)rb;
+    (void)count;
+#endif
+}
+
+// counts elements removed from the buffer
+static inline void stat_popped(ring_buffer_t* rb, size_t count)
+{
+#ifdef RB_ENABLE_STATS
+    rb->stats.pops += count;
+#else
+    (void)rb;
+    (void)count;
+#endif
+}
+
+// counts calls that didn't add (full) or remove (empty) all requested elements
+static inline void stat_rejected(ring_buffer_t* rb, bool full)
+{
+#ifdef RB_ENABLE_STATS
+    if (full)
+    {
+        rb->stats.full_rejects++;
+    }
+    else
     {
-        (*idx) = 0;
+        rb->stats.empty_rejects++;
+    }
+#else
+    (void)rb;
+    (void)full;
+#endif
+}
+
+// returns the timestamp of the element at the given index of a timestamped buffer
+static inline uint64_t ts_at(const ring_buffer_t* rb, size_t idx)
+{
+    uint64_t ts;
+    memcpy(&ts, el_ptr(rb, idx), sizeof(ts));
+    return ts;
+}
+
+// Returns the number of elements from the tail up to the oldest one whose timestamp is
+// not less than the given one. The elements from the tail to the head are sorted, so a
+// binary search over their positions finds it.
+static size_t lower_bound_ts(const ring_buffer_t* rb, uint64_t t)
+{
+    size_t lo = 0;
+    size_t hi = count_to_head(rb, rb->tail);
+    while (lo < hi)
+    {
+        const size_t mid = lo + ((hi - lo) / 2);
+        size_t       idx = rb->tail;
+        advance_idx(rb, &idx, mid);
+        if (ts_at(rb, idx) < t)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// stores the given value by the pointer if it is provided
+static void set_count(size_t* const count_out, size_t count)
+{
+    if (count_out != NULL)
+    {
+        (*count_out) = count;
     }
 }
 
@@ -24,11 +170,54 @@ rb_ret_t rb_init(ring_buffer_t* rb, void* buff, size_t buff_size, size_t el_size
         return RB_INVALID_ARG;
     }
 
-    rb->buff    = buff;
-    rb->cap     = buff_size / el_size;
-    rb->el_size = el_size;
-    rb->head    = 0;
-    rb->tail    = 0;
+    rb->buff     = buff;
+    rb->cap      = buff_size / el_size;
+    rb->el_size  = el_size;
+    rb->head     = 0;
+    rb->tail     = 0;
+    rb->mask     = 0;
+    rb->map_size = 0;
+    rb->flags    = 0;
+#ifdef RB_ENABLE_STATS
+    memset(&rb->stats, 0, sizeof(rb->stats));
+#endif
+    return RB_OK;
+}
+
+rb_ret_t rb_init_pow2(ring_buffer_t* rb, void* buff, size_t buff_size, size_t el_size)
+{
+    rb_ret_t ret = rb_init(rb, buff, buff_size, el_size);
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+
+    // round the capacity down to a power of two
+    size_t cap = 1;
+    while (cap <= rb->cap / 2)
+    {
+        cap *= 2;
+    }
+
+    rb->cap   = cap;
+    rb->mask  = cap - 1;
+    rb->flags = RB_FLAG_POW2;
+    return RB_OK;
+}
+
+rb_ret_t rb_init_ts(ring_buffer_t* rb, void* buff, size_t buff_size, size_t el_size)
+{
+    if (el_size < sizeof(uint64_t))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    rb_ret_t ret = rb_init(rb, buff, buff_size, el_size);
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+    rb->flags |= RB_FLAG_TIMESTAMPED;
     return RB_OK;
 }
 
@@ -38,12 +227,42 @@ rb_ret_t rb_add(ring_buffer_t* rb, void* data)
 
     if (rb_is_full(rb) == true)
     {
+        stat_rejected(rb, true);
         return RB_FULL;
     }
 
-    memcpy((char*)rb->buff + (rb->head * rb->el_size), data, rb->el_size);
+    memcpy(el_ptr(rb, rb->head), data, rb->el_size);
 
-    increment_idx(rb, &rb->head);
+    advance_idx(rb, &rb->head, 1);
+    stat_pushed(rb, 1);
+    return RB_OK;
+}
+
+rb_ret_t rb_push_overwrite(ring_buffer_t* rb, const void* data, void* evicted_out,
+                           bool* evicted)
+{
+    CHECK_IF_INIT(rb);
+
+    const bool isFull = (free_count(rb) == 0);
+    if (isFull)
+    {
+        if (evicted_out != NULL)
+        {
+            memcpy(evicted_out, el_ptr(rb, rb->tail), rb->el_size);
+        }
+        advance_idx(rb, &rb->tail, 1);
+#ifdef RB_ENABLE_STATS
+        rb->stats.overwrites++;
+#endif
+    }
+    if (evicted != NULL)
+    {
+        (*evicted) = isFull;
+    }
+
+    memcpy(el_ptr(rb, rb->head), data, rb->el_size);
+    advance_idx(rb, &rb->head, 1);
+    stat_pushed(rb, 1);
     return RB_OK;
 }
 
@@ -53,18 +272,150 @@ rb_ret_t rb_remove(ring_buffer_t* rb)
 
     if (rb_is_empty(rb) == true)
     {
+        stat_rejected(rb, false);
+        return RB_EMPTY;
+    }
+
+    advance_idx(rb, &rb->tail, 1);
+    stat_popped(rb, 1);
+    return RB_OK;
+}
+
+rb_ret_t rb_add_n(ring_buffer_t* rb, const void* data, size_t n, size_t* added)
+{
+    set_count(added, 0);
+    CHECK_IF_INIT(rb);
+
+    const size_t freeCount = free_count(rb);
+    const size_t count     = (n < freeCount) ? n : freeCount;
+    if (count < n)
+    {
+        stat_rejected(rb, true);
+    }
+    if ((count == 0) && (n > 0))
+    {
+        return RB_FULL;
+    }
+
+    // copy up to the end of the buffer and the rest to the beginning
+    const size_t toEnd = count_to_end(rb, rb->head);
+    const size_t first = (count < toEnd) ? count : toEnd;
+    memcpy(el_ptr(rb, rb->head), data, first * rb->el_size);
+    memcpy(rb->buff, (const char*)data + (first * rb->el_size),
+           (count - first) * rb->el_size);
+
+    advance_idx(rb, &rb->head, count);
+    stat_pushed(rb, count);
+    set_count(added, count);
+    return RB_OK;
+}
+
+rb_ret_t rb_remove_n(ring_buffer_t* rb, size_t n, size_t* removed)
+{
+    set_count(removed, 0);
+    CHECK_IF_INIT(rb);
+
+    const size_t used  = count_to_head(rb, rb->tail);
+    const size_t count = (n < used) ? n : used;
+    if (count < n)
+    {
+        stat_rejected(rb, false);
+    }
+    if ((count == 0) && (n > 0))
+    {
+        return RB_EMPTY;
+    }
+
+    advance_idx(rb, &rb->tail, count);
+    stat_popped(rb, count);
+    set_count(removed, count);
+    return RB_OK;
+}
+
+rb_ret_t rb_reserve_write(ring_buffer_t* rb, size_t n, void** ptr, size_t* count)
+{
+    CHECK_IF_INIT(rb);
+
+    if ((ptr == NULL) || (count == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    // the region ends either at the end of the buffer or at the last free slot
+    const size_t freeCount = free_count(rb);
+    const size_t contig    = count_to_end(rb, rb->head);
+    const size_t avail     = (freeCount < contig) ? freeCount : contig;
+    if (avail == 0)
+    {
+        (*count) = 0;
+        stat_rejected(rb, true);
+        return RB_FULL;
+    }
+
+    (*ptr)   = el_ptr(rb, rb->head);
+    (*count) = (n < avail) ? n : avail;
+    return RB_OK;
+}
+
+rb_ret_t rb_commit_write(ring_buffer_t* rb, size_t count)
+{
+    CHECK_IF_INIT(rb);
+
+    if ((count > free_count(rb)) || (count > count_to_end(rb, rb->head)))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    advance_idx(rb, &rb->head, count);
+    stat_pushed(rb, count);
+    return RB_OK;
+}
+
+rb_ret_t rb_peek_read(ring_buffer_t* rb, void** ptr, size_t* count)
+{
+    CHECK_IF_INIT(rb);
+
+    if ((ptr == NULL) || (count == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    const size_t used   = count_to_head(rb, rb->tail);
+    const size_t contig = count_to_end(rb, rb->tail);
+    if (used == 0)
+    {
+        (*count) = 0;
+        stat_rejected(rb, false);
         return RB_EMPTY;
     }
 
-    increment_idx(rb, &rb->tail);
+    (*ptr)   = el_ptr(rb, rb->tail);
+    (*count) = (used < contig) ? used : contig;
+    return RB_OK;
+}
+
+rb_ret_t rb_release_read(ring_buffer_t* rb, size_t count)
+{
+    CHECK_IF_INIT(rb);
+
+    if (count > count_to_head(rb, rb->tail))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    advance_idx(rb, &rb->tail, count);
+    stat_popped(rb, count);
     return RB_OK;
 }
 
 bool rb_is_full(ring_buffer_t* rb)
 {
-    size_t nextHead = rb->head;
-    increment_idx(rb, &nextHead);
-    return (nextHead == rb->tail);
+    return free_count(rb) == 0;
+}
+
+size_t rb_size(ring_buffer_t* rb)
+{
+    return count_to_head(rb, rb->tail);
 }
 
 bool rb_is_empty(ring_buffer_t* rb)
@@ -72,15 +423,73 @@ bool rb_is_empty(ring_buffer_t* rb)
     return rb->tail == rb->head;
 }
 
-rb_ret_t rb_init_read_it(ring_buffer_t* rb, rb_it_t* it)
+rb_ret_t rb_at(ring_buffer_t* rb, size_t i, void** ptr)
+{
+    if (ptr == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    CHECK_IF_INIT(rb);
+
+    if (i >= count_to_head(rb, rb->tail))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    size_t idx = rb->tail;
+    advance_idx(rb, &idx, i);
+    (*ptr) = el_ptr(rb, idx);
+    return RB_OK;
+}
+
+rb_ret_t rb_peek_oldest(ring_buffer_t* rb, void** ptr)
+{
+    if (ptr == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    CHECK_IF_INIT(rb);
+
+    if (rb->tail == rb->head)
+    {
+        return RB_EMPTY;
+    }
+
+    (*ptr) = el_ptr(rb, rb->tail);
+    return RB_OK;
+}
+
+rb_ret_t rb_peek_newest(ring_buffer_t* rb, void** ptr)
 {
+    if (ptr == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
     CHECK_IF_INIT(rb);
 
+    if (rb->tail == rb->head)
+    {
+        return RB_EMPTY;
+    }
+
+    size_t idx = rb->head;
+    retreat_idx(rb, &idx);
+    (*ptr) = el_ptr(rb, idx);
+    return RB_OK;
+}
+
+rb_ret_t rb_init_read_it(ring_buffer_t* rb, rb_it_t* it)
+{
     if (it == NULL)
     {
         return RB_INVALID_ARG;
     }
 
+    CHECK_IF_INIT(rb);
+
     it->rb  = rb;
     it->idx = rb->tail;
     return RB_OK;
@@ -98,7 +507,149 @@ rb_ret_t rb_get_next_val(rb_it_t* it, void* data_out)
         return RB_EMPTY;
     }
 
-    memcpy(data_out, (char*)it->rb->buff + (it->idx * it->rb->el_size), it->rb->el_size);
-    increment_idx(it->rb, &it->idx);
+    memcpy(data_out, el_ptr(it->rb, it->idx), it->rb->el_size);
+    advance_idx(it->rb, &it->idx, 1);
+    return RB_OK;
+}
+
+rb_ret_t rb_read_n(rb_it_t* it, void* data_out, size_t n, size_t* read)
+{
+    set_count(read, 0);
+    if (it->rb == NULL)
+    {
+        return RB_NOT_INIT;
+    }
+
+    ring_buffer_t* rb    = it->rb;
+    const size_t   avail = count_to_head(rb, it->idx);
+    const size_t   count = (n < avail) ? n : avail;
+    if ((count == 0) && (n > 0))
+    {
+        return RB_EMPTY;
+    }
+
+    // copy up to the end of the buffer and the rest from the beginning
+    const size_t toEnd = count_to_end(rb, it->idx);
+    const size_t first = (count < toEnd) ? count : toEnd;
+    memcpy(data_out, el_ptr(rb, it->idx), first * rb->el_size);
+    memcpy((char*)data_out + (first * rb->el_size), rb->buff,
+           (count - first) * rb->el_size);
+
+    advance_idx(rb, &it->idx, count);
+    set_count(read, count);
+    return RB_OK;
+}
+
+rb_ret_t rb_init_reverse_it(ring_buffer_t* rb, rb_it_t* it)
+{
+    if (it == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    CHECK_IF_INIT(rb);
+
+    it->rb  = rb;
+    it->idx = rb->head;
+    return RB_OK;
+}
+
+rb_ret_t rb_get_prev_val(rb_it_t* it, void* data_out)
+{
+    if (it->rb == NULL)
+    {
+        return RB_NOT_INIT;
+    }
+
+    if (it->idx == it->rb->tail)
+    {
+        return RB_EMPTY;
+    }
+
+    retreat_idx(it->rb, &it->idx);
+    memcpy(data_out, el_ptr(it->rb, it->idx), it->rb->el_size);
+    return RB_OK;
+}
+
+rb_ret_t rb_seek_time(ring_buffer_t* rb, uint64_t t, rb_it_t* it)
+{
+    if ((rb == NULL) || (it == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    CHECK_IF_INIT(rb);
+
+    if ((rb->flags & RB_FLAG_TIMESTAMPED) == 0)
+    {
+        return RB_UNSUPPORTED;
+    }
+
+    it->rb  = rb;
+    it->idx = rb->tail;
+    advance_idx(rb, &it->idx, lower_bound_ts(rb, t));
+    return RB_OK;
+}
+
+rb_ret_t rb_seek_range(ring_buffer_t* rb, uint64_t t0, uint64_t t1, rb_range_t* range)
+{
+    if (range == NULL)
+    {
+        return RB_INVALID_ARG;
+    }
+
+    range->it.rb = NULL;
+    range->left  = 0;
+    rb_ret_t ret = rb_seek_time(rb, t0, &range->it);
+    if (ret != RB_OK)
+    {
+        return ret;
+    }
+
+    // the iterator is at the start of the range, the end is searched from the tail
+    const size_t begin = count_to_head(rb, rb->tail) - count_to_head(rb, range->it.idx);
+    const size_t end   = (t1 > t0) ? lower_bound_ts(rb, t1) : begin;
+    range->left        = end - begin;
+    return RB_OK;
+}
+
+rb_ret_t rb_range_next(rb_range_t* range, void* data_out)
+{
+    if (range->it.rb == NULL)
+    {
+        return RB_NOT_INIT;
+    }
+    if (range->left == 0)
+    {
+        return RB_EMPTY;
+    }
+
+    rb_ret_t ret = rb_get_next_val(&range->it, data_out);
+    if (ret == RB_OK)
+    {
+        range->left--;
+    }
+    return ret;
+}
+
+size_t rb_range_left(const rb_range_t* range)
+{
+    return range->left;
+}
+
+rb_ret_t rb_stats_snapshot(ring_buffer_t* rb, rb_stats_t* out)
+{
+#ifdef RB_ENABLE_STATS
+    if ((rb == NULL) || (out == NULL))
+    {
+        return RB_INVALID_ARG;
+    }
+
+    (*out) = rb->stats;
     return RB_OK;
+#else
+    (void)rb;
+    (void)out;
+    return RB_UNSUPPORTED;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "gtest/gtest.h"
+
+#include "hr_archive.h"
+#include "hr_gen.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// archive with its own memory for at least the given number of samples
+class Archive
+{
+public:
+
+    explicit Archive(size_t samples)
+        : m_mem(hr_archive_mem_size(samples))
+    {
+        EXPECT_EQ(hr_archive_init(&m_ar, m_mem.data(), m_mem.size()), RB_OK);
+    }
+
+    void push(const std::vector<uint8_t>& samples)
+    {
+        ASSERT_EQ(hr_archive_push(&m_ar, samples.data(), samples.size()), RB_OK);
+    }
+
+    std::vector<uint8_t> read(uint64_t from, size_t n)
+    {
+        std::vector<uint8_t> out(n);
+        size_t               read = 0;
+        EXPECT_EQ(hr_archive_read(&m_ar, from, out.data(), n, &read), RB_OK);
+        out.resize(read);
+        return out;
+    }
+
+    hr_archive_t m_ar;
+
+private:
+
+    std::vector<char> m_mem;
+};
+
+// heart rate that drifts by a few beats per sample within the generator range
+std::vector<uint8_t> randomWalk(size_t n, uint32_t seed)
+{
+    std::mt19937                       gen(seed);
+    std::uniform_int_distribution<int> step(-2, 2);
+    std::vector<uint8_t>               samples(n);
+    int                                val = 70;
+    for (uint8_t& sample: samples)
+    {
+        val    = std::max(val + step(gen), (int)HR_GEN_MIN_HR);
+        val    = std::min(val, (int)HR_GEN_MAX_HR);
+        sample = (uint8_t)val;
+    }
+    return samples;
+}
+
+std::vector<uint8_t> uniform(size_t n, uint64_t seed)
+{
+    hr_gen_t gen;
+    hr_gen_init(&gen, seed);
+    std::vector<uint8_t> samples(n);
+    hr_gen_fill(&gen, samples.data(), n);
+    return samples;
+}
+
+TEST(HrArchiveTest, hr_archive_init_GivenInvalidArgs_ReturnsInvalidArg)
+{
+    hr_archive_t      ar = {};
+    std::vector<char> mem(hr_archive_mem_size(1));
+    EXPECT_EQ(hr_archive_init(NULL, mem.data(), mem.size()), RB_INVALID_ARG);
+    EXPECT_EQ(hr_archive_init(&ar, NULL, mem.size()), RB_INVALID_ARG);
+    EXPECT_EQ(hr_archive_init(&ar, mem.data(), 64), RB_INVALID_ARG);
+    EXPECT_EQ(hr_archive_push(&ar, NULL, 0), RB_NOT_INIT);
+
+    ASSERT_EQ(hr_archive_init(&ar, mem.data(), mem.size()), RB_OK);
+    uint8_t  out;
+    size_t   read;
+    uint64_t oldest;
+    uint64_t next;
+    EXPECT_EQ(hr_archive_push(&ar, NULL, 1), RB_INVALID_ARG);
+    EXPECT_EQ(hr_archive_read(&ar, 0, &out, 1, &read), RB_EMPTY);
+    EXPECT_EQ(hr_archive_read(&ar, 0, NULL, 1, &read), RB_INVALID_ARG);
+    EXPECT_EQ(hr_archive_range(&ar, &oldest, &next), RB_OK);
+    EXPECT_EQ(oldest, 0u);
+    EXPECT_EQ(next, 0u);
+}
+
+TEST(HrArchiveTest, hr_archive_read_GivenAnyRange_ReturnsPushedSamples)
+{
+    for (bool walk: {true, false})
+    {
+        const std::vector<uint8_t> samples =
+            walk ? randomWalk(10000, 1) : uniform(10000, 1);
+        Archive ar(samples.size());
+
+        // pushed in uneven pieces, so blocks are filled across calls
+        for (size_t off = 0; off < samples.size(); off += 777)
+        {
+            const size_t n = std::min<size_t>(777, samples.size() - off);
+            auto begin = samples.begin() + off;
+            ar.push(std::vector<uint8_t>(begin, begin + n));
+        }
+
+        std::mt19937                          gen(2);
+        std::uniform_int_distribution<size_t> dist(0, samples.size() - 1);
+        for (int i = 0; i < 500; ++i)
+        {
+            const size_t from  = dist(gen);
+            const size_t n     = dist(gen) % 1000 + 1;
+            const size_t cnt   = std::min(n, samples.size() - from);
+            auto         begin = samples.begin() + from;
+            EXPECT_EQ(ar.read(from, n), std::vector<uint8_t>(begin, begin + cnt));
+        }
+        EXPECT_EQ(ar.read(0, samples.size()), samples);
+    }
+}
+
+TEST(HrArchiveTest, hr_archive_push_WhenFull_EvictsOldestBlocks)
+{
+    const size_t               capacity = 2000;
+    const std::vector<uint8_t> samples  = uniform(20000, 3);
+    Archive                    ar(capacity);
+
+    for (size_t i = 0; i < samples.size(); i += 100)
+    {
+        ar.push(std::vector<uint8_t>(samples.begin() + i, samples.begin() + i + 100));
+
+        uint64_t oldest;
+        uint64_t next;
+        ASSERT_EQ(hr_archive_range(&ar.m_ar, &oldest, &next), RB_OK);
+        ASSERT_EQ(next, i + 100);
+        ASSERT_EQ(oldest % HR_ARCHIVE_BLOCK_LEN, 0u);
+        ASSERT_GE(next - oldest, std::min<uint64_t>(capacity, next));
+        ASSERT_EQ(ar.read(oldest, samples.size()),
+                  std::vector<uint8_t>(samples.begin() + oldest, samples.begin() + next));
+    }
+
+    uint8_t  out;
+    size_t   read;
+    uint64_t oldest;
+    uint64_t next;
+    ASSERT_EQ(hr_archive_range(&ar.m_ar, &oldest, &next), RB_OK);
+    ASSERT_GT(oldest, 0u);
+    EXPECT_EQ(hr_archive_read(&ar.m_ar, oldest - 1, &out, 1, &read), RB_INVALID_ARG);
+}
+
+TEST(HrArchiveTest, hr_archive_usage_GivenSlowSignal_CompressesSamples)
+{
+    const std::vector<uint8_t> walk = randomWalk(100 * HR_ARCHIVE_BLOCK_LEN, 4);
+    Archive                    ar(walk.size());
+    ar.push(walk);
+
+    // steps of at most 2 need 3 bits as deltas, plus the block and record headers
+    uint64_t samples;
+    size_t   bytes;
+    ASSERT_EQ(hr_archive_usage(&ar.m_ar, &samples, &bytes), RB_OK);
+    EXPECT_EQ(samples, walk.size());
+    EXPECT_LE(bytes * 2, samples);
+
+    // a constant signal only keeps the headers
+    Archive flat(walk.size());
+    flat.push(std::vector<uint8_t>(walk.size() + 10, 72));
+    ASSERT_EQ(hr_archive_usage(&flat.m_ar, &samples, &bytes), RB_OK);
+    EXPECT_EQ(samples, walk.size());
+    EXPECT_EQ(bytes, 100 * (RB_VAR_HDR_SIZE + sizeof(hr_archive_hdr_t)));
+    EXPECT_EQ(flat.read(walk.size() - 5, 100), std::vector<uint8_t>(15, 72));
+}
+
+} // namespace
\ No newline at end of file
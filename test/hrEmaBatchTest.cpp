@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+
+#include "hr_ema_batch.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+const hr_ema_isa_t kIsas[] = {HR_EMA_ISA_SCALAR, HR_EMA_ISA_SSE2, HR_EMA_ISA_AVX2};
+
+TEST(hrEmaBatchTest, hr_ema_batch_init_GivenInvalidArguments_ReturnsError)
+{
+    hr_ema_batch_t    batch;
+    std::vector<char> mem(hr_ema_batch_mem_size(10, 4));
+
+    EXPECT_EQ(hr_ema_batch_init(NULL, mem.data(), mem.size(), 10, 4), RB_INVALID_ARG);
+    EXPECT_EQ(hr_ema_batch_init(&batch, NULL, mem.size(), 10, 4), RB_INVALID_ARG);
+    EXPECT_EQ(hr_ema_batch_init(&batch, mem.data(), mem.size() - 1, 10, 4),
+              RB_INVALID_ARG);
+    EXPECT_EQ(hr_ema_batch_init(&batch, mem.data(), mem.size(), 0, 4), RB_INVALID_ARG);
+    EXPECT_EQ(hr_ema_batch_init(&batch, mem.data(), mem.size(), 10, 0), RB_INVALID_ARG);
+    EXPECT_EQ(hr_ema_batch_init(&batch, mem.data(), mem.size(), 10, 4), RB_OK);
+}
+
+TEST(hrEmaBatchTest, hr_ema_batch_push_GivenNotInitializedBatch_ReturnsError)
+{
+    hr_ema_batch_t batch = {};
+    uint8_t        sample = 60;
+    uint8_t        res;
+
+    EXPECT_EQ(hr_ema_batch_push(&batch, &sample, &res), RB_NOT_INIT);
+}
+
+TEST(hrEmaBatchTest, hr_ema_batch_push_GivenRandomChannels_MatchesEmaCalc)
+{
+    std::mt19937                       gen(7);
+    std::uniform_int_distribution<int> dist(44, 185);
+
+    // channel counts that leave a remainder for every vector width
+    const size_t channels = 37;
+    for (size_t window: {1, 2, 10, 100})
+    {
+        for (hr_ema_isa_t isa: kIsas)
+        {
+            hr_ema_batch_t    batch;
+            std::vector<char> mem(hr_ema_batch_mem_size(channels, window));
+            ASSERT_EQ(hr_ema_batch_init(&batch, mem.data(), mem.size(), channels, window),
+                      RB_OK);
+            if (hr_ema_batch_set_isa(&batch, isa) != RB_OK)
+            {
+                continue;
+            }
+
+            std::vector<std::vector<uint8_t>> buffs(channels,
+                                                    std::vector<uint8_t>(window + 1));
+            std::vector<ring_buffer_t>        rbs(channels);
+            for (size_t c = 0; c < channels; ++c)
+            {
+                ASSERT_EQ(rb_init(&rbs[c], buffs[c].data(), window + 1, sizeof(uint8_t)),
+                          RB_OK);
+            }
+
+            int                  maxDiff = 0;
+            std::vector<uint8_t> samples(channels);
+            std::vector<uint8_t> res(channels);
+            for (size_t i = 0; i < 5 * window + 50; ++i)
+            {
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    samples[c] = dist(gen);
+                    rb_push_overwrite(&rbs[c], &samples[c], NULL, NULL);
+                }
+                ASSERT_EQ(hr_ema_batch_push(&batch, samples.data(), res.data()), RB_OK);
+
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    int diff = std::abs((int)res[c] - (int)hr_ema_calc(&rbs[c]));
+                    maxDiff  = (diff > maxDiff) ? diff : maxDiff;
+                }
+            }
+            EXPECT_LE(maxDiff, 1) << "window " << window << " isa " << isa;
+        }
+    }
+}
+
+TEST(hrEmaBatchTest, hr_ema_batch_push_GivenSupportedIsas_ProducesIdenticalResults)
+{
+    std::mt19937                       gen(11);
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    const size_t channels = 203;
+    const size_t window   = 16;
+
+    std::vector<std::vector<char>> mems;
+    std::vector<hr_ema_batch_t>    batches;
+    for (hr_ema_isa_t isa: kIsas)
+    {
+        hr_ema_batch_t    batch;
+        std::vector<char> mem(hr_ema_batch_mem_size(channels, window));
+        ASSERT_EQ(hr_ema_batch_init(&batch, mem.data(), mem.size(), channels, window),
+                  RB_OK);
+        if (hr_ema_batch_set_isa(&batch, isa) == RB_OK)
+        {
+            // the batch points into the memory, which moves along with the vector
+            mems.push_back(std::move(mem));
+            batches.push_back(batch);
+        }
+    }
+    ASSERT_GE(batches.size(), 1u);
+
+    std::vector<uint8_t> samples(channels);
+    std::vector<uint8_t> expected(channels);
+    std::vector<uint8_t> res(channels);
+    for (size_t i = 0; i < 10 * window; ++i)
+    {
+        for (auto& sample: samples)
+        {
+            sample = dist(gen);
+        }
+        ASSERT_EQ(hr_ema_batch_push(&batches[0], samples.data(), expected.data()), RB_OK);
+        for (size_t b = 1; b < batches.size(); ++b)
+        {
+            ASSERT_EQ(hr_ema_batch_push(&batches[b], samples.data(), res.data()), RB_OK);
+            ASSERT_EQ(res, expected) << "isa " << batches[b].isa << " step " << i;
+        }
+    }
+}
+
+} // namespace
\ No newline at end of file
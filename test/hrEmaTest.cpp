@@ -3,6 +3,8 @@
 #include "hr_ema.h"
 
 #include <list>
+#include <random>
+#include <vector>
 
 namespace
 {
@@ -70,4 +72,144 @@ TEST(hrEmaTest, hr_ema_calc_GivenNotFullBufferWithOverwrittenValues_CalculatesCo
     uint8_t expectedEma = 118;
     EXPECT_EQ(res, expectedEma);
 }
+
+TEST(hrEmaTest, hr_ema_init_GivenInvalidArguments_ReturnsError)
+{
+    ring_buffer_t  rb = {};
+    hr_ema_state_t state;
+
+    EXPECT_EQ(hr_ema_init(NULL, &rb), RB_INVALID_ARG);
+    EXPECT_EQ(hr_ema_init(&state, &rb), RB_NOT_INIT);
+}
+
+TEST(hrEmaTest, hr_ema_push_GivenPrefilledBuffer_MatchesEmaCalc)
+{
+    // Arrange
+    std::list<uint8_t> givenHrs = {65, 50, 75};
+
+    const size_t elSize   = sizeof(uint8_t);
+    const size_t cap      = 10;
+    const size_t buffSize = (cap + 1) * elSize;
+    char         buff[buffSize];
+
+    ring_buffer_t rb;
+    ASSERT_EQ(rb_init(&rb, buff, buffSize, elSize), RB_OK);
+    for (auto val: givenHrs)
+    {
+        ASSERT_EQ(rb_add(&rb, &val), RB_OK);
+    }
+
+    hr_ema_state_t state;
+    ASSERT_EQ(hr_ema_init(&state, &rb), RB_OK);
+
+    // Act
+    uint8_t val = 100;
+    ASSERT_EQ(rb_add(&rb, &val), RB_OK);
+    uint8_t res;
+    ASSERT_EQ(hr_ema_push(&state, val, NULL, &res), RB_OK);
+
+    // Assert
+    EXPECT_EQ(res, hr_ema_calc(&rb));
+}
+
+TEST(hrEmaTest, hr_ema_push_GivenSlidingWindows_MatchesEmaCalc)
+{
+    std::uniform_int_distribution<int> dist(44, 185);
+
+    // the double sum lands near a rounding boundary a few times per thousand samples
+    for (unsigned seed = 1; seed <= 20; ++seed)
+    {
+        std::mt19937 gen(seed);
+        for (size_t window: {1, 2, 5, 10, 100, 500})
+        {
+            std::vector<uint8_t> buff(window + 1);
+            ring_buffer_t        rb;
+            ASSERT_EQ(rb_init(&rb, buff.data(), buff.size(), sizeof(uint8_t)), RB_OK);
+
+            hr_ema_state_t state;
+            ASSERT_EQ(hr_ema_init(&state, &rb), RB_OK);
+
+            size_t mismatches = 0;
+            for (size_t i = 0; i < 5 * window + 100; ++i)
+            {
+                uint8_t val = dist(gen);
+                uint8_t old;
+                bool    evicted;
+                ASSERT_EQ(rb_push_overwrite(&rb, &val, &old, &evicted), RB_OK);
+
+                uint8_t res;
+                ASSERT_EQ(hr_ema_push(&state, val, evicted ? &old : NULL, &res), RB_OK);
+                mismatches += (res != hr_ema_calc(&rb));
+            }
+            EXPECT_EQ(mismatches, 0) << "seed " << seed << ", window " << window;
+        }
+    }
+}
+
+TEST(hrEmaTest, hr_ema_push_GivenEmptyBufferOrInvalidArgument_ReturnsError)
+{
+    uint8_t       buff[4];
+    ring_buffer_t rb;
+    ASSERT_EQ(rb_init(&rb, buff, sizeof(buff), sizeof(uint8_t)), RB_OK);
+
+    hr_ema_state_t state;
+    ASSERT_EQ(hr_ema_init(&state, &rb), RB_OK);
+
+    uint8_t res = 7;
+    EXPECT_EQ(hr_ema_push(&state, 60, NULL, &res), RB_EMPTY);
+    EXPECT_EQ(res, 7);
+    EXPECT_EQ(hr_ema_push(NULL, 60, NULL, &res), RB_INVALID_ARG);
+    EXPECT_EQ(hr_ema_push(&state, 60, NULL, NULL), RB_INVALID_ARG);
+}
+
+TEST(hrEmaTest, hr_ema_calc_fixed_GivenSlidingWindows_DiffersFromEmaCalcByAtMostOne)
+{
+    std::mt19937                       gen(42);
+    std::uniform_int_distribution<int> dist(44, 185);
+    const hr_ema_cfg_t                 cfg = {HR_EMA_ALPHA_Q15(HR_EMA_ALPHA)};
+
+    for (size_t window: {1, 2, 5, 10, 100})
+    {
+        std::vector<uint8_t> buff(window + 1);
+        ring_buffer_t        rb;
+        ASSERT_EQ(rb_init(&rb, buff.data(), buff.size(), sizeof(uint8_t)), RB_OK);
+
+        for (size_t i = 0; i < 5 * window + 100; ++i)
+        {
+            uint8_t val = dist(gen);
+            ASSERT_EQ(rb_push_overwrite(&rb, &val, NULL, NULL), RB_OK);
+
+            const int diff = (int)hr_ema_calc_fixed(&rb, &cfg) - (int)hr_ema_calc(&rb);
+            ASSERT_LE(abs(diff), 1) << "window " << window << ", sample " << i;
+        }
+    }
+}
+
+TEST(hrEmaTest, hr_ema_calc_fixed_GivenRuntimeAlpha_CalculatesCorrectEma)
+{
+    std::list<uint8_t> givenHrs = {65, 50, 75};
+
+    const size_t elSize   = sizeof(uint8_t);
+    const size_t cap      = 10;
+    const size_t buffSize = (cap + 1) * elSize;
+    char         buff[buffSize];
+
+    ring_buffer_t rb;
+    ASSERT_EQ(rb_init(&rb, buff, buffSize, elSize), RB_OK);
+    for (auto val: givenHrs)
+    {
+        ASSERT_EQ(rb_add(&rb, &val), RB_OK);
+    }
+
+    hr_ema_cfg_t cfg = {HR_EMA_ALPHA_Q15(0.8f)};
+    EXPECT_EQ(hr_ema_calc_fixed(&rb, &cfg), 71); // 70.6
+    cfg.alpha = HR_EMA_ALPHA_Q15(0.5f);
+    EXPECT_EQ(hr_ema_calc_fixed(&rb, &cfg), 66); // 66.25
+    cfg.alpha = HR_EMA_Q15_ONE;
+    EXPECT_EQ(hr_ema_calc_fixed(&rb, &cfg), 75); // newest value
+    cfg.alpha = 0;
+    EXPECT_EQ(hr_ema_calc_fixed(&rb, &cfg), 65); // oldest value
+    EXPECT_EQ(hr_ema_calc_fixed(&rb, NULL), 0);
+}
+
 } // namespace
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+
+#include "hr_filter.h"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// single-stage filter with its own memory
+class Filter
+{
+public:
+
+    explicit Filter(std::vector<hr_filter_cfg_t> cfg)
+        : m_mem(hr_filter_mem_size(cfg.data(), cfg.size()))
+    {
+        m_ret = hr_filter_init(&m_filter, m_mem.data(), m_mem.size(), cfg.data(),
+                               cfg.size());
+    }
+
+    rb_ret_t initRet() const
+    {
+        return m_ret;
+    }
+
+    uint8_t push(uint8_t sample)
+    {
+        uint8_t out = 0;
+        EXPECT_EQ(hr_filter_push(&m_filter, sample, &out), RB_OK);
+        return out;
+    }
+
+    hr_filter_t m_filter;
+
+private:
+
+    std::vector<char> m_mem;
+    rb_ret_t          m_ret;
+};
+
+uint8_t referenceMedian(const std::deque<uint8_t>& window)
+{
+    std::vector<uint8_t> sorted(window.begin(), window.end());
+    std::sort(sorted.begin(), sorted.end());
+    const size_t n = sorted.size();
+    if (n % 2 == 1)
+    {
+        return sorted[n / 2];
+    }
+    return (uint8_t)((sorted[(n / 2) - 1] + sorted[n / 2] + 1) / 2);
+}
+
+uint8_t referenceSma(const std::deque<uint8_t>& window)
+{
+    uint64_t sum = 0;
+    for (uint8_t val: window)
+    {
+        sum += val;
+    }
+    return (uint8_t)((2 * sum + window.size()) / (2 * window.size()));
+}
+
+TEST(hrFilterTest, hr_filter_init_GivenInvalidArguments_ReturnsError)
+{
+    hr_filter_t       filter;
+    hr_filter_cfg_t   cfg[2] = {{HR_FILTER_MEDIAN, 5}, {HR_FILTER_SMA, 3}};
+    std::vector<char> mem(hr_filter_mem_size(cfg, 2));
+
+    EXPECT_EQ(hr_filter_init(NULL, mem.data(), mem.size(), cfg, 2), RB_INVALID_ARG);
+    EXPECT_EQ(hr_filter_init(&filter, NULL, mem.size(), cfg, 2), RB_INVALID_ARG);
+    EXPECT_EQ(hr_filter_init(&filter, mem.data(), mem.size() - 1, cfg, 2),
+              RB_INVALID_ARG);
+    EXPECT_EQ(hr_filter_init(&filter, mem.data(), mem.size(), cfg, 0), RB_INVALID_ARG);
+    EXPECT_EQ(hr_filter_init(&filter, mem.data(), mem.size(), cfg,
+                             HR_FILTER_MAX_STAGES + 1),
+              RB_INVALID_ARG);
+    cfg[1].window = 0;
+    EXPECT_EQ(hr_filter_init(&filter, mem.data(), mem.size(), cfg, 2), RB_INVALID_ARG);
+    cfg[1].window = 3;
+    ASSERT_EQ(hr_filter_init(&filter, mem.data(), mem.size(), cfg, 2), RB_OK);
+
+    uint8_t out;
+    EXPECT_EQ(hr_filter_push(&filter, 60, NULL), RB_INVALID_ARG);
+    EXPECT_EQ(hr_filter_stage_out(&filter, 2, &out), RB_INVALID_ARG);
+}
+
+TEST(hrFilterTest, hr_filter_push_GivenNotInitializedFilter_ReturnsError)
+{
+    hr_filter_t filter = {};
+    uint8_t     out;
+
+    EXPECT_EQ(hr_filter_push(&filter, 60, &out), RB_NOT_INIT);
+    EXPECT_EQ(hr_filter_stage_out(&filter, 0, &out), RB_NOT_INIT);
+}
+
+TEST(hrFilterTest, hr_filter_push_GivenSlidingWindows_MatchesSortedMedianAndSma)
+{
+    std::mt19937                       gen(42);
+    std::uniform_int_distribution<int> dist(44, 185);
+
+    for (size_t window: {1, 2, 5, 8, 33, 100})
+    {
+        Filter median({{HR_FILTER_MEDIAN, window}});
+        Filter sma({{HR_FILTER_SMA, window}});
+        ASSERT_EQ(median.initRet(), RB_OK);
+        ASSERT_EQ(sma.initRet(), RB_OK);
+
+        std::deque<uint8_t> samples;
+        for (size_t i = 0; i < 5 * window + 100; ++i)
+        {
+            // long runs of equal values exercise the heaps with duplicates
+            const uint8_t val = (i % 50 < 10) ? 70 : dist(gen);
+            samples.push_back(val);
+            if (samples.size() > window)
+            {
+                samples.pop_front();
+            }
+
+            ASSERT_EQ(median.push(val), referenceMedian(samples))
+                << "window " << window << ", sample " << i;
+            ASSERT_EQ(sma.push(val), referenceSma(samples))
+                << "window " << window << ", sample " << i;
+        }
+    }
+}
+
+TEST(hrFilterTest, hr_filter_push_GivenChainedStages_MatchesStagesAppliedInTurn)
+{
+    std::mt19937                       gen(7);
+    std::uniform_int_distribution<int> dist(44, 185);
+
+    Filter chain({{HR_FILTER_MEDIAN, 5}, {HR_FILTER_EMA, 10}, {HR_FILTER_SMA, 4}});
+    Filter median({{HR_FILTER_MEDIAN, 5}});
+    Filter ema({{HR_FILTER_EMA, 10}});
+    Filter sma({{HR_FILTER_SMA, 4}});
+    ASSERT_EQ(chain.initRet(), RB_OK);
+
+    // the EMA stage gives the result of hr_ema_calc over the window of its inputs
+    std::vector<uint8_t> buff(11);
+    ring_buffer_t        rb;
+    ASSERT_EQ(rb_init(&rb, buff.data(), buff.size(), sizeof(uint8_t)), RB_OK);
+
+    for (size_t i = 0; i < 200; ++i)
+    {
+        // spikes like motion artifacts
+        const uint8_t val = (i % 17 == 0) ? 220 : dist(gen);
+
+        const uint8_t m = median.push(val);
+        const uint8_t e = ema.push(m);
+        ASSERT_EQ(rb_push_overwrite(&rb, &m, NULL, NULL), RB_OK);
+        EXPECT_EQ(e, hr_ema_calc(&rb));
+
+        uint8_t stageOut;
+        ASSERT_EQ(chain.push(val), sma.push(e));
+        ASSERT_EQ(hr_filter_stage_out(&chain.m_filter, 0, &stageOut), RB_OK);
+        EXPECT_EQ(stageOut, m);
+        ASSERT_EQ(hr_filter_stage_out(&chain.m_filter, 1, &stageOut), RB_OK);
+        EXPECT_EQ(stageOut, e);
+    }
+}
+
+} // namespace
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include "hr_gen.h"
 
+#include <thread>
+#include <vector>
+
 namespace
 {
 TEST(hrGenTest, hr_gen_random_GeneratesWithinGivenRange)
@@ -14,4 +17,115 @@ TEST(hrGenTest, hr_gen_random_GeneratesWithinGivenRange)
         EXPECT_LE(value, HR_GEN_MAX_HR);
     }
 }
+
+TEST(hrGenTest, hr_gen_init_GivenInvalidArguments_ReturnsError)
+{
+    hr_gen_t gen;
+    uint8_t  out;
+
+    EXPECT_EQ(hr_gen_init(NULL, 1), RB_INVALID_ARG);
+    ASSERT_EQ(hr_gen_init(&gen, 1), RB_OK);
+    EXPECT_EQ(hr_gen_fill(NULL, &out, 1), RB_INVALID_ARG);
+    EXPECT_EQ(hr_gen_fill(&gen, NULL, 1), RB_INVALID_ARG);
+    EXPECT_EQ(hr_gen_fill(&gen, NULL, 0), RB_OK);
+}
+
+TEST(hrGenTest, hr_gen_fill_GivenSameSeed_ProducesSameSequence)
+{
+    hr_gen_t first;
+    hr_gen_t second;
+    hr_gen_t other;
+    ASSERT_EQ(hr_gen_init(&first, 42), RB_OK);
+    ASSERT_EQ(hr_gen_init(&second, 42), RB_OK);
+    ASSERT_EQ(hr_gen_init(&other, 43), RB_OK);
+
+    std::vector<uint8_t> a(1000);
+    std::vector<uint8_t> b(1000);
+    std::vector<uint8_t> c(1000);
+    ASSERT_EQ(hr_gen_fill(&first, a.data(), a.size()), RB_OK);
+    ASSERT_EQ(hr_gen_fill(&second, b.data(), b.size()), RB_OK);
+    ASSERT_EQ(hr_gen_fill(&other, c.data(), c.size()), RB_OK);
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+}
+
+TEST(hrGenTest, hr_gen_fill_GivenMixedCalls_MatchesSingleValues)
+{
+    hr_gen_t bulk;
+    hr_gen_t single;
+    ASSERT_EQ(hr_gen_init(&bulk, 7), RB_OK);
+    ASSERT_EQ(hr_gen_init(&single, 7), RB_OK);
+
+    // chunks that start and end inside a block
+    std::vector<uint8_t> res;
+    for (size_t n: {3, 1, 17, 0, 8, 5, 64, 2})
+    {
+        std::vector<uint8_t> chunk(n);
+        ASSERT_EQ(hr_gen_fill(&bulk, chunk.data(), n), RB_OK);
+        res.insert(res.end(), chunk.begin(), chunk.end());
+        res.push_back(hr_gen_next(&bulk));
+    }
+
+    for (size_t i = 0; i < res.size(); ++i)
+    {
+        ASSERT_EQ(res[i], hr_gen_next(&single)) << "index " << i;
+    }
+}
+
+TEST(hrGenTest, hr_gen_fill_GeneratesEveryValueWithinRange)
+{
+    const size_t range = HR_GEN_MAX_HR - HR_GEN_MIN_HR + 1;
+    const size_t n     = range * 2000;
+
+    hr_gen_t gen;
+    ASSERT_EQ(hr_gen_init(&gen, 2024), RB_OK);
+    std::vector<uint8_t> out(n);
+    ASSERT_EQ(hr_gen_fill(&gen, out.data(), n), RB_OK);
+
+    std::vector<size_t> hist(256, 0);
+    for (uint8_t val: out)
+    {
+        hist[val]++;
+    }
+
+    // each value is expected 2000 times, the bound is far beyond the random deviation
+    for (size_t val = 0; val < hist.size(); ++val)
+    {
+        if ((val < HR_GEN_MIN_HR) || (val > HR_GEN_MAX_HR))
+        {
+            EXPECT_EQ(hist[val], 0) << "value " << val;
+        }
+        else
+        {
+            EXPECT_GT(hist[val], 1700) << "value " << val;
+            EXPECT_LT(hist[val], 2300) << "value " << val;
+        }
+    }
+}
+
+TEST(hrGenTest, hr_gen_random_GivenSeveralThreads_GeneratesWithinGivenRange)
+{
+    std::vector<std::thread> threads;
+    std::vector<int>         outOfRange(4, 0);
+    for (size_t t = 0; t < outOfRange.size(); ++t)
+    {
+        threads.emplace_back([&outOfRange, t]() {
+            for (size_t i = 0; i < 10000; ++i)
+            {
+                uint8_t value = hr_gen_random();
+                outOfRange[t] += (value < HR_GEN_MIN_HR) || (value > HR_GEN_MAX_HR);
+            }
+        });
+    }
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+
+    for (int count: outOfRange)
+    {
+        EXPECT_EQ(count, 0);
+    }
+}
 } // namespace
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+
+#include "hr_hub.h"
+
+#include <vector>
+
+namespace
+{
+
+// EMA of the stream after the given number of samples, computed on a single thread
+uint8_t referenceEma(uint64_t seed, size_t window, uint64_t nSamples)
+{
+    std::vector<uint8_t> buff(window + 1);
+    ring_buffer_t        rb;
+    hr_ema_state_t       state;
+    hr_gen_t             gen;
+    rb_init(&rb, buff.data(), buff.size(), sizeof(uint8_t));
+    hr_ema_init(&state, &rb);
+    hr_gen_init(&gen, seed);
+
+    uint8_t ema = 0;
+    for (uint64_t i = 0; i < nSamples; ++i)
+    {
+        uint8_t val = hr_gen_next(&gen);
+        uint8_t old;
+        bool    evicted;
+        rb_push_overwrite(&rb, &val, &old, &evicted);
+        hr_ema_push(&state, val, evicted ? &old : NULL, &ema);
+    }
+    return ema;
+}
+
+TEST(hrHubTest, hr_hub_init_GivenInvalidArguments_ReturnsError)
+{
+    hr_hub_t          hub;
+    std::vector<char> mem(hr_hub_mem_size(10, 4, 2));
+
+    EXPECT_EQ(hr_hub_init(NULL, mem.data(), mem.size(), 10, 4, 2, 1), RB_INVALID_ARG);
+    EXPECT_EQ(hr_hub_init(&hub, NULL, mem.size(), 10, 4, 2, 1), RB_INVALID_ARG);
+    EXPECT_EQ(hr_hub_init(&hub, mem.data(), mem.size() - 1, 10, 4, 2, 1), RB_INVALID_ARG);
+    EXPECT_EQ(hr_hub_init(&hub, mem.data(), mem.size(), 0, 4, 2, 1), RB_INVALID_ARG);
+    EXPECT_EQ(hr_hub_init(&hub, mem.data(), mem.size(), 10, 0, 2, 1), RB_INVALID_ARG);
+    EXPECT_EQ(hr_hub_init(&hub, mem.data(), mem.size(), 10, 4, 0, 1), RB_INVALID_ARG);
+    ASSERT_EQ(hr_hub_init(&hub, mem.data(), mem.size(), 10, 4, 2, 1), RB_OK);
+
+    uint8_t ema;
+    EXPECT_EQ(hr_hub_set_rate(&hub, 10, 1), RB_INVALID_ARG);
+    EXPECT_EQ(hr_hub_ema(&hub, 10, &ema), RB_INVALID_ARG);
+    EXPECT_EQ(hr_hub_destroy(&hub), RB_OK);
+}
+
+TEST(hrHubTest, hr_hub_run_GivenNotInitializedHub_ReturnsError)
+{
+    hr_hub_t hub = {};
+    uint8_t  ema;
+
+    EXPECT_EQ(hr_hub_run(&hub, 1, NULL), RB_NOT_INIT);
+    EXPECT_EQ(hr_hub_ema(&hub, 0, &ema), RB_NOT_INIT);
+    EXPECT_EQ(hr_hub_destroy(&hub), RB_NOT_INIT);
+}
+
+TEST(hrHubTest, hr_hub_run_GivenUnevenRates_MatchesSingleThreadedStreams)
+{
+    const size_t   nStreams = 1000;
+    const size_t   window   = 10;
+    const uint64_t seed     = 1234;
+    const uint32_t ticks    = 7;
+
+    for (size_t nThreads: {1, 3, 8})
+    {
+        hr_hub_t          hub;
+        std::vector<char> mem(hr_hub_mem_size(nStreams, window, nThreads));
+        ASSERT_EQ(hr_hub_init(&hub, mem.data(), mem.size(), nStreams, window, nThreads,
+                              seed),
+                  RB_OK);
+
+        // the first shard gets most of the load
+        uint64_t expectedSamples = 0;
+        for (size_t s = 0; s < nStreams; ++s)
+        {
+            const uint32_t rate = (s < nStreams / 8) ? 20 : (s % 3);
+            ASSERT_EQ(hr_hub_set_rate(&hub, s, rate), RB_OK);
+            expectedSamples += (uint64_t)rate * ticks;
+        }
+
+        uint64_t samples = 0;
+        for (int run = 0; run < 2; ++run)
+        {
+            ASSERT_EQ(hr_hub_run(&hub, ticks, &samples), RB_OK);
+            EXPECT_EQ(samples, expectedSamples);
+        }
+
+        size_t mismatches = 0;
+        for (size_t s = 0; s < nStreams; ++s)
+        {
+            const uint32_t rate = (s < nStreams / 8) ? 20 : (s % 3);
+            uint8_t        ema;
+            ASSERT_EQ(hr_hub_ema(&hub, s, &ema), RB_OK);
+            mismatches += (ema != referenceEma(seed + s, window, 2ull * rate * ticks));
+        }
+        EXPECT_EQ(mismatches, 0u) << nThreads << " threads";
+        EXPECT_EQ(hr_hub_destroy(&hub), RB_OK);
+    }
+}
+
+} // namespace
\ No newline at end of file
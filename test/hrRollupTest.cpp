@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+
+#include "hr_rollup.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// rollups with their own memory
+class Rollup
+{
+public:
+
+    Rollup(size_t rawDepth, std::vector<hr_rollup_cfg_t> cfg)
+        : m_mem(hr_rollup_mem_size(rawDepth, cfg.data(), cfg.size()))
+    {
+        m_ret = hr_rollup_init(&m_rollup, m_mem.data(), m_mem.size(), rawDepth,
+                               cfg.data(), cfg.size());
+    }
+
+    rb_ret_t initRet() const
+    {
+        return m_ret;
+    }
+
+    hr_rollup_t m_rollup;
+
+private:
+
+    std::vector<char> m_mem;
+    rb_ret_t          m_ret;
+};
+
+hr_rollup_agg_t reference(const std::vector<uint8_t>& samples, uint64_t from, uint64_t to)
+{
+    hr_rollup_agg_t agg = {0, 0, UINT8_MAX, 0};
+    for (uint64_t i = from; i < to; ++i)
+    {
+        agg.sum += samples[i];
+        agg.count++;
+        agg.min = std::min(agg.min, samples[i]);
+        agg.max = std::max(agg.max, samples[i]);
+    }
+    return agg;
+}
+
+void expectAgg(const hr_rollup_agg_t& actual, const hr_rollup_agg_t& expected)
+{
+    EXPECT_EQ(actual.sum, expected.sum);
+    EXPECT_EQ(actual.count, expected.count);
+    EXPECT_EQ(actual.min, expected.min);
+    EXPECT_EQ(actual.max, expected.max);
+}
+
+TEST(HrRollupTest, hr_rollup_init_GivenInvalidConfig_ReturnsInvalidArg)
+{
+    EXPECT_EQ(Rollup(10, {{1, 10}}).initRet(), RB_INVALID_ARG);
+    EXPECT_EQ(Rollup(10, {{2, 0}}).initRet(), RB_INVALID_ARG);
+    EXPECT_EQ(Rollup(0, {{2, 10}}).initRet(), RB_INVALID_ARG);
+
+    // the level below must cover the bucket in progress
+    EXPECT_EQ(Rollup(10, {{11, 10}}).initRet(), RB_INVALID_ARG);
+    EXPECT_EQ(Rollup(10, {{10, 5}, {6, 5}}).initRet(), RB_INVALID_ARG);
+    EXPECT_EQ(Rollup(10, {{10, 6}, {6, 5}}).initRet(), RB_OK);
+    EXPECT_EQ(Rollup(10, {}).initRet(), RB_OK);
+
+    hr_rollup_t     rollup = {};
+    hr_rollup_agg_t agg;
+    EXPECT_EQ(hr_rollup_push(&rollup, 60), RB_NOT_INIT);
+    EXPECT_EQ(hr_rollup_last(&rollup, 1, &agg), RB_NOT_INIT);
+}
+
+TEST(HrRollupTest, hr_rollup_query_GivenInvalidRange_ReturnsInvalidArg)
+{
+    Rollup          r(10, {{5, 4}});
+    hr_rollup_agg_t agg;
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(hr_rollup_push(&r.m_rollup, 60), RB_OK);
+    }
+
+    EXPECT_EQ(hr_rollup_query(&r.m_rollup, 95, 95, &agg), RB_INVALID_ARG);
+    EXPECT_EQ(hr_rollup_query(&r.m_rollup, 95, 101, &agg), RB_INVALID_ARG);
+    EXPECT_EQ(hr_rollup_query(&r.m_rollup, 95, 100, NULL), RB_INVALID_ARG);
+    EXPECT_EQ(hr_rollup_last(&r.m_rollup, 101, &agg), RB_INVALID_ARG);
+
+    // only the last 10 samples and the last 4 buckets of 5 are kept
+    EXPECT_EQ(hr_rollup_query(&r.m_rollup, 80, 100, &agg), RB_OK);
+    EXPECT_EQ(hr_rollup_query(&r.m_rollup, 79, 100, &agg), RB_INVALID_ARG);
+    EXPECT_EQ(hr_rollup_query(&r.m_rollup, 81, 100, &agg), RB_INVALID_ARG);
+    EXPECT_EQ(hr_rollup_query(&r.m_rollup, 85, 99, &agg), RB_OK);
+    EXPECT_EQ(hr_rollup_query(&r.m_rollup, 90, 99, &agg), RB_OK);
+    EXPECT_EQ(agg.count, 9u);
+}
+
+TEST(HrRollupTest, hr_rollup_query_GivenKeptRanges_MatchesScanOfSamples)
+{
+    // widths of 4, 12 and 60 samples
+    Rollup r(50, {{4, 20}, {3, 10}, {5, 6}});
+    ASSERT_EQ(r.initRet(), RB_OK);
+
+    std::mt19937                       gen(7);
+    std::uniform_int_distribution<int> hr(44, 185);
+    std::vector<uint8_t>               samples;
+    for (int i = 0; i < 2000; ++i)
+    {
+        samples.push_back((uint8_t)hr(gen));
+        ASSERT_EQ(hr_rollup_push(&r.m_rollup, samples.back()), RB_OK);
+        const uint64_t total = samples.size();
+
+        for (int q = 0; q < 5; ++q)
+        {
+            const uint64_t to   = std::uniform_int_distribution<uint64_t>(1, total)(gen);
+            const uint64_t from = std::uniform_int_distribution<uint64_t>(0, to - 1)(gen);
+
+            hr_rollup_agg_t agg;
+            rb_ret_t        ret = hr_rollup_query(&r.m_rollup, from, to, &agg);
+            if (ret == RB_OK)
+            {
+                expectAgg(agg, reference(samples, from, to));
+            }
+
+            // ranges within the kept samples are always answered
+            ASSERT_TRUE((ret == RB_OK) || (from + 50 < total));
+        }
+
+        // whole buckets of 12 samples are kept for 10 buckets
+        const uint64_t done = total / 12;
+        if (done > 0)
+        {
+            const uint64_t  first = (done > 10) ? done - 10 : 0;
+            hr_rollup_agg_t agg;
+            ASSERT_EQ(hr_rollup_query(&r.m_rollup, first * 12, done * 12, &agg), RB_OK);
+            expectAgg(agg, reference(samples, first * 12, done * 12));
+        }
+
+        hr_rollup_agg_t agg;
+        ASSERT_EQ(hr_rollup_last(&r.m_rollup, std::min<uint64_t>(total, 50), &agg),
+                  RB_OK);
+        expectAgg(agg, reference(samples, total - std::min<uint64_t>(total, 50), total));
+    }
+}
+
+TEST(HrRollupTest, hr_rollup_last_GivenDayOfSeconds_ReturnsHourAndDayAggregates)
+{
+    // seconds for a little more than a day, minutes and hours
+    Rollup r(90000, {{60, 1500}, {60, 48}});
+    ASSERT_EQ(r.initRet(), RB_OK);
+
+    std::vector<uint8_t> samples;
+    for (uint64_t i = 0; i < 2 * 86400 + 1234; ++i)
+    {
+        samples.push_back((uint8_t)(60 + (i / 60) % 100 + (i % 7)));
+        ASSERT_EQ(hr_rollup_push(&r.m_rollup, samples.back()), RB_OK);
+    }
+
+    const uint64_t total = samples.size();
+    for (uint64_t n: {1ull, 59ull, 3600ull, 86400ull})
+    {
+        hr_rollup_agg_t agg;
+        ASSERT_EQ(hr_rollup_last(&r.m_rollup, n, &agg), RB_OK);
+        expectAgg(agg, reference(samples, total - n, total));
+    }
+
+    // the day before is only kept in minutes and hours
+    hr_rollup_agg_t agg;
+    ASSERT_EQ(hr_rollup_query(&r.m_rollup, 3600, 86400 + 3600, &agg), RB_OK);
+    expectAgg(agg, reference(samples, 3600, 86400 + 3600));
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "gtest/gtest.h"
+
+#include "hr_sink.h"
+
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+// starts a sink writing to an in-memory file, which is read back after the sink is
+// destroyed
+class HrSinkOutput : public ::testing::Test
+{
+public:
+
+    void SetUp() override
+    {
+        m_fd = memfd_create("hr_sink_test", 0);
+        ASSERT_GE(m_fd, 0);
+    }
+
+    void TearDown() override
+    {
+        close(m_fd);
+    }
+
+protected:
+
+    void start(hr_sink_format_t format, size_t depth, size_t batchSize, uint32_t flushMs)
+    {
+        m_cfg = {m_fd, format, depth, batchSize, flushMs, -1};
+        m_mem.resize(hr_sink_mem_size(depth, batchSize));
+        ASSERT_EQ(hr_sink_init(&m_sink, m_mem.data(), m_mem.size(), &m_cfg), RB_OK);
+    }
+
+    std::string contents() const
+    {
+        std::string res(static_cast<size_t>(lseek(m_fd, 0, SEEK_END)), '\0');
+        EXPECT_EQ(pread(m_fd, &res[0], res.size(), 0), static_cast<ssize_t>(res.size()));
+        return res;
+    }
+
+    int               m_fd = -1;
+    hr_sink_cfg_t     m_cfg;
+    std::vector<char> m_mem;
+    hr_sink_t         m_sink = {};
+};
+
+TEST(HrSinkTest, hr_sink_init_WhenGivenInvalidArgument_ReturnsError)
+{
+    hr_sink_t         sink = {};
+    hr_sink_cfg_t     cfg  = {STDOUT_FILENO, HR_SINK_TEXT, 16, 4096, 100, 0};
+    std::vector<char> mem(hr_sink_mem_size(cfg.depth, cfg.batch_size));
+
+    EXPECT_EQ(hr_sink_init(NULL, mem.data(), mem.size(), &cfg), RB_INVALID_ARG);
+    EXPECT_EQ(hr_sink_init(&sink, NULL, mem.size(), &cfg), RB_INVALID_ARG);
+    EXPECT_EQ(hr_sink_init(&sink, mem.data(), mem.size(), NULL), RB_INVALID_ARG);
+    EXPECT_EQ(hr_sink_init(&sink, mem.data(), mem.size() - 1, &cfg), RB_INVALID_ARG);
+
+    hr_sink_cfg_t bad = cfg;
+    bad.fd            = -1;
+    EXPECT_EQ(hr_sink_init(&sink, mem.data(), mem.size(), &bad), RB_INVALID_ARG);
+    bad        = cfg;
+    bad.depth  = 0;
+    EXPECT_EQ(hr_sink_init(&sink, mem.data(), mem.size(), &bad), RB_INVALID_ARG);
+    bad            = cfg;
+    bad.batch_size = HR_SINK_MAX_REC_LEN - 1;
+    EXPECT_EQ(hr_sink_init(&sink, mem.data(), mem.size(), &bad), RB_INVALID_ARG);
+    bad          = cfg;
+    bad.flush_ms = 0;
+    EXPECT_EQ(hr_sink_init(&sink, mem.data(), mem.size(), &bad), RB_INVALID_ARG);
+
+    hr_sink_rec_t   rec   = {};
+    hr_sink_stats_t stats = {};
+    EXPECT_EQ(hr_sink_push(&sink, &rec), RB_NOT_INIT);
+    EXPECT_EQ(hr_sink_stats(&sink, &stats), RB_NOT_INIT);
+    EXPECT_EQ(hr_sink_destroy(&sink, NULL), RB_NOT_INIT);
+    EXPECT_EQ(hr_sink_destroy(NULL, NULL), RB_NOT_INIT);
+}
+
+TEST_F(HrSinkOutput, hr_sink_push_WhenFormatIsText_WritesLines)
+{
+    start(HR_SINK_TEXT, 16, 4096, 1000);
+    hr_sink_rec_t recs[] = {{0, 0, 75, 73}, {12345678901ull, 7, 180, 9}};
+    for (const hr_sink_rec_t& rec : recs)
+    {
+        ASSERT_EQ(hr_sink_push(&m_sink, &rec), RB_OK);
+    }
+    ASSERT_EQ(hr_sink_destroy(&m_sink, NULL), RB_OK);
+
+    EXPECT_EQ(contents(), "sample 0, stream 0: heart rate 75, EMA 73\n"
+                          "sample 12345678901, stream 7: heart rate 180, EMA 9\n");
+}
+
+TEST_F(HrSinkOutput, hr_sink_push_WhenFormatIsCsv_WritesHeaderAndRows)
+{
+    start(HR_SINK_CSV, 16, 4096, 1000);
+    hr_sink_rec_t recs[] = {{1, 2, 60, 61}, {2, 4294967295u, 255, 0}};
+    for (const hr_sink_rec_t& rec : recs)
+    {
+        ASSERT_EQ(hr_sink_push(&m_sink, &rec), RB_OK);
+    }
+    ASSERT_EQ(hr_sink_destroy(&m_sink, NULL), RB_OK);
+
+    EXPECT_EQ(contents(), "seq,stream,hr,ema\n1,2,60,61\n2,4294967295,255,0\n");
+}
+
+TEST_F(HrSinkOutput, hr_sink_push_WhenFormatIsBinary_WritesLittleEndianRecords)
+{
+    start(HR_SINK_BINARY, 16, 4096, 1000);
+    hr_sink_rec_t rec = {0x0102030405060708ull, 0x0a0b0c0d, 200, 100};
+    ASSERT_EQ(hr_sink_push(&m_sink, &rec), RB_OK);
+    ASSERT_EQ(hr_sink_destroy(&m_sink, NULL), RB_OK);
+
+    const unsigned char expected[HR_SINK_BIN_REC_SIZE] = {
+        0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x0d, 0x0c, 0x0b, 0x0a, 200, 100};
+    EXPECT_EQ(contents(), std::string(reinterpret_cast<const char*>(expected),
+                                      sizeof(expected)));
+}
+
+TEST_F(HrSinkOutput, hr_sink_push_WhenManyRecords_WritesAllInOrderInBatches)
+{
+    const uint64_t count = 100000;
+    start(HR_SINK_CSV, 64, 4096, 1000);
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        hr_sink_rec_t rec = {i, 0, static_cast<uint8_t>(i), static_cast<uint8_t>(i / 3)};
+        ASSERT_EQ(hr_sink_push(&m_sink, &rec), RB_OK);
+    }
+    hr_sink_stats_t stats;
+    ASSERT_EQ(hr_sink_destroy(&m_sink, &stats), RB_OK);
+
+    std::string expected = "seq,stream,hr,ema\n";
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        expected += std::to_string(i) + ",0," + std::to_string(i % 256) + "," +
+                    std::to_string((i / 3) % 256) + "\n";
+    }
+    EXPECT_EQ(contents(), expected);
+    EXPECT_EQ(stats.pushed, count);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.written, count);
+    EXPECT_EQ(stats.bytes, expected.size());
+    EXPECT_EQ(stats.write_errors, 0u);
+    EXPECT_LE(stats.writes, expected.size() / (4096 - HR_SINK_MAX_REC_LEN) + 1);
+}
+
+TEST_F(HrSinkOutput, hr_sink_push_WhenFlushIntervalPasses_WritesWithoutFullBatch)
+{
+    start(HR_SINK_TEXT, 16, 4096, 10);
+    hr_sink_rec_t rec = {5, 1, 70, 70};
+    ASSERT_EQ(hr_sink_push(&m_sink, &rec), RB_OK);
+
+    hr_sink_stats_t stats = {};
+    for (int i = 0; (i < 1000) && (stats.written == 0); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ASSERT_EQ(hr_sink_stats(&m_sink, &stats), RB_OK);
+    }
+    EXPECT_EQ(stats.written, 1u);
+    EXPECT_EQ(stats.writes, 1u);
+    EXPECT_EQ(contents(), "sample 5, stream 1: heart rate 70, EMA 70\n");
+    ASSERT_EQ(hr_sink_destroy(&m_sink, NULL), RB_OK);
+}
+
+TEST_F(HrSinkOutput, hr_sink_destroy_WhenSinkThreadIsParked_ReturnsWithoutWaitingForFlush)
+{
+    start(HR_SINK_TEXT, 16, 4096, 60000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    const auto      start = std::chrono::steady_clock::now();
+    hr_sink_stats_t stats;
+    ASSERT_EQ(hr_sink_destroy(&m_sink, &stats), RB_OK);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_EQ(stats.written, 0u);
+    EXPECT_EQ(stats.writes, 0u);
+    EXPECT_EQ(contents(), "");
+}
+
+TEST(HrSinkTest, hr_sink_push_WhenWriterFallsBehind_CountsAndDropsRecords)
+{
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    // the pipe isn't read until the queue overflows, so the sink thread blocks in write
+    const size_t      depth = 8;
+    hr_sink_t         sink  = {};
+    hr_sink_cfg_t     cfg   = {fds[1], HR_SINK_BINARY, depth, 4096, 1, 0};
+    std::vector<char> mem(hr_sink_mem_size(depth, cfg.batch_size));
+    ASSERT_EQ(hr_sink_init(&sink, mem.data(), mem.size(), &cfg), RB_OK);
+
+    const int    pipeSize = fcntl(fds[1], F_GETPIPE_SZ);
+    const size_t attempts =
+        static_cast<size_t>(pipeSize) / HR_SINK_BIN_REC_SIZE + 4096 + 10 * depth;
+    size_t full = 0;
+    for (size_t i = 0; i < attempts; ++i)
+    {
+        hr_sink_rec_t  rec = {i, 0, 60, 60};
+        const rb_ret_t ret = hr_sink_push(&sink, &rec);
+        ASSERT_TRUE((ret == RB_OK) || (ret == RB_FULL));
+        full += (ret == RB_FULL) ? 1 : 0;
+        if (full == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_GT(full, 0u);
+
+    std::thread reader([&]() {
+        char buff[4096];
+        while (read(fds[0], buff, sizeof(buff)) > 0)
+        {
+        }
+    });
+    hr_sink_stats_t stats;
+    ASSERT_EQ(hr_sink_destroy(&sink, &stats), RB_OK);
+    close(fds[1]);
+    reader.join();
+    close(fds[0]);
+
+    EXPECT_EQ(stats.dropped, full);
+    EXPECT_EQ(stats.full_waits, 0u);
+    EXPECT_EQ(stats.pushed + stats.dropped, attempts);
+    EXPECT_EQ(stats.written, stats.pushed);
+    EXPECT_EQ(stats.bytes, stats.pushed * HR_SINK_BIN_REC_SIZE);
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include "ring_buffer.h"
+
+#include <cerrno>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+TEST(rbAllocTest, rb_create_WhenGivenInvalidArgument_ReturnsError)
+{
+    ring_buffer_t rb;
+    uint8_t       buff[8];
+
+    EXPECT_EQ(rb_create(NULL, 10, 1, 0), RB_INVALID_ARG);
+    EXPECT_EQ(rb_create(&rb, 0, 1, 0), RB_INVALID_ARG);
+    EXPECT_EQ(rb_create(&rb, 10, 0, 0), RB_INVALID_ARG);
+    EXPECT_EQ(rb_create(&rb, SIZE_MAX / 2, 8, 0), RB_INVALID_ARG);
+
+    // only buffers created by rb_create can be destroyed
+    ASSERT_EQ(rb_init(&rb, buff, sizeof(buff), 1), RB_OK);
+    EXPECT_EQ(rb_destroy(&rb), RB_INVALID_ARG);
+}
+
+TEST(rbAllocTest, rb_create_GivenCapacity_AllocatesAlignedBuffer)
+{
+    ring_buffer_t rb;
+    ASSERT_EQ(rb_create(&rb, 1000, sizeof(uint32_t), RB_CREATE_PREFAULT), RB_OK);
+    EXPECT_EQ((uintptr_t)rb.buff % RB_CACHE_LINE_SIZE, 0u);
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(rb_add(&rb, &i), RB_OK);
+    }
+    EXPECT_EQ(rb_is_full(&rb), true);
+
+    rb_it_t  it;
+    uint32_t val;
+    ASSERT_EQ(rb_init_read_it(&rb, &it), RB_OK);
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(rb_get_next_val(&it, &val), RB_OK);
+        EXPECT_EQ(val, i);
+    }
+
+    EXPECT_EQ(rb_destroy(&rb), RB_OK);
+    EXPECT_EQ(rb_destroy(&rb), RB_NOT_INIT);
+}
+
+TEST(rbAllocTest, rb_create_GivenPinningOptions_CreatesUsableBuffer)
+{
+    ring_buffer_t  rb;
+    const uint32_t opts = RB_CREATE_POW2 | RB_CREATE_THP | RB_CREATE_PREFAULT |
+                          RB_CREATE_MLOCK;
+    const rb_ret_t ret  = rb_create(&rb, 1 << 20, sizeof(uint64_t), opts);
+    if ((ret == RB_IO_ERROR) && ((errno == EPERM) || (errno == ENOMEM)))
+    {
+        GTEST_SKIP() << "memory can't be locked";
+    }
+    ASSERT_EQ(ret, RB_OK);
+    EXPECT_EQ(rb.cap, 1u << 20);
+    EXPECT_EQ((uintptr_t)rb.buff % RB_HUGE_PAGE_SIZE, 0u);
+
+    uint64_t val = 42;
+    ASSERT_EQ(rb_push_overwrite(&rb, &val, NULL, NULL), RB_OK);
+    EXPECT_EQ(rb_destroy(&rb), RB_OK);
+}
+
+TEST(rbAllocTest, rb_create_WhenMirrored_WrappedElementsAreContiguous)
+{
+    // 12-byte elements, the capacity is rounded up so that the buffer ends on a page
+    struct El
+    {
+        uint32_t a;
+        uint64_t b;
+    } __attribute__((packed));
+
+    ring_buffer_t rb;
+    ASSERT_EQ(rb_create(&rb, 100, sizeof(El), RB_CREATE_MIRROR), RB_OK);
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    EXPECT_EQ((rb.cap * sizeof(El)) % page, 0u);
+    EXPECT_GE(rb.cap, 101u);
+
+    // move the head and tail close to the end of the buffer
+    std::vector<El> els(rb.cap);
+    for (size_t i = 0; i < rb.cap; ++i)
+    {
+        els[i] = {(uint32_t)i, i * 3};
+    }
+    size_t n;
+    ASSERT_EQ(rb_add_n(&rb, els.data(), rb.cap - 3, &n), RB_OK);
+    ASSERT_EQ(rb_remove_n(&rb, rb.cap - 3, &n), RB_OK);
+
+    // the whole free space can be reserved at once and the write wraps
+    void* ptr;
+    ASSERT_EQ(rb_reserve_write(&rb, 10, &ptr, &n), RB_OK);
+    EXPECT_EQ(n, 10u);
+    memcpy(ptr, els.data(), 10 * sizeof(El));
+    ASSERT_EQ(rb_commit_write(&rb, 10), RB_OK);
+
+    // the element after the end of the buffer is the first one
+    EXPECT_EQ(memcmp((char*)rb.buff + (rb.cap * sizeof(El)), rb.buff, sizeof(El)), 0);
+
+    ASSERT_EQ(rb_peek_read(&rb, &ptr, &n), RB_OK);
+    ASSERT_EQ(n, 10u);
+    EXPECT_EQ(memcmp(ptr, els.data(), 10 * sizeof(El)), 0);
+
+    rb_it_t it;
+    El      out[10];
+    ASSERT_EQ(rb_init_read_it(&rb, &it), RB_OK);
+    ASSERT_EQ(rb_read_n(&it, out, 10, &n), RB_OK);
+    EXPECT_EQ(memcmp(out, els.data(), sizeof(out)), 0);
+    EXPECT_EQ(rb_destroy(&rb), RB_OK);
+}
+
+TEST(rbAllocTest, rb_create_WhenMirroredPow2_WrapsWithFreeRunningIndices)
+{
+    ring_buffer_t rb;
+    ASSERT_EQ(rb_create(&rb, 8, sizeof(uint32_t), RB_CREATE_MIRROR | RB_CREATE_POW2),
+              RB_OK);
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    EXPECT_EQ(rb.cap, page / sizeof(uint32_t));
+
+    std::vector<uint32_t> vals(rb.cap + rb.cap / 2);
+    for (size_t i = 0; i < vals.size(); ++i)
+    {
+        vals[i] = (uint32_t)i;
+    }
+
+    size_t n;
+    ASSERT_EQ(rb_add_n(&rb, vals.data(), rb.cap, &n), RB_OK);
+    ASSERT_EQ(rb_remove_n(&rb, rb.cap / 2 + 1, &n), RB_OK);
+    ASSERT_EQ(rb_add_n(&rb, vals.data() + rb.cap, rb.cap / 2, &n), RB_OK);
+    EXPECT_EQ(n, rb.cap / 2);
+
+    void* ptr;
+    ASSERT_EQ(rb_peek_read(&rb, &ptr, &n), RB_OK);
+    ASSERT_EQ(n, rb.cap - 1);
+    EXPECT_EQ(memcmp(ptr, vals.data() + rb.cap / 2 + 1, n * sizeof(uint32_t)), 0);
+    EXPECT_EQ(rb_destroy(&rb), RB_OK);
+}
+
+} // namespace
\ No newline at end of file
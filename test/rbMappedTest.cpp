@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+
+#include "rb_mapped.h"
+
+#include <cstddef>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+class RbMappedTest : public ::testing::Test
+{
+public:
+
+    void SetUp() override
+    {
+        m_path = "/tmp/rbMappedTest_" + std::to_string(getpid()) + ".rb";
+        unlink(m_path.c_str());
+    }
+
+    void TearDown() override
+    {
+        unlink(m_path.c_str());
+    }
+
+protected:
+
+    std::vector<uint32_t> readAll(rb_mapped_t* mrb)
+    {
+        std::vector<uint32_t> res;
+        rb_it_t               it;
+        uint32_t              val;
+        EXPECT_EQ(rb_init_read_it(&mrb->rb, &it), RB_OK);
+        while (rb_get_next_val(&it, &val) == RB_OK)
+        {
+            res.push_back(val);
+        }
+        return res;
+    }
+
+    static constexpr size_t m_cap = 4;
+    std::string             m_path;
+};
+
+TEST_F(RbMappedTest, rb_open_mapped_WhenGivenInvalidArgument_ReturnsError)
+{
+    rb_mapped_t mrb;
+
+    EXPECT_EQ(rb_open_mapped(NULL, m_path.c_str(), m_cap, 4), RB_INVALID_ARG);
+    EXPECT_EQ(rb_open_mapped(&mrb, NULL, m_cap, 4), RB_INVALID_ARG);
+    EXPECT_EQ(rb_open_mapped(&mrb, m_path.c_str(), 0, 4), RB_INVALID_ARG);
+    EXPECT_EQ(rb_open_mapped(&mrb, m_path.c_str(), m_cap, 0), RB_INVALID_ARG);
+    EXPECT_EQ(rb_open_mapped(&mrb, "/nonexistent/dir/file", m_cap, 4), RB_IO_ERROR);
+    EXPECT_EQ(rb_mapped_commit(&mrb), RB_NOT_INIT);
+}
+
+TEST_F(RbMappedTest, rb_open_mapped_GivenClosedBuffer_RestoresElements)
+{
+    rb_mapped_t mrb;
+    ASSERT_EQ(rb_open_mapped(&mrb, m_path.c_str(), m_cap, sizeof(uint32_t)), RB_OK);
+    EXPECT_TRUE(rb_is_empty(&mrb.rb));
+    for (uint32_t val = 1; val <= 6; ++val)
+    {
+        ASSERT_EQ(rb_push_overwrite(&mrb.rb, &val, NULL, NULL), RB_OK);
+        ASSERT_EQ(rb_mapped_commit(&mrb), RB_OK);
+    }
+    ASSERT_EQ(rb_close_mapped(&mrb), RB_OK);
+
+    ASSERT_EQ(rb_open_mapped(&mrb, m_path.c_str(), m_cap, sizeof(uint32_t)), RB_OK);
+    EXPECT_EQ(readAll(&mrb), std::vector<uint32_t>({3, 4, 5, 6}));
+    EXPECT_EQ(rb_close_mapped(&mrb), RB_OK);
+}
+
+TEST_F(RbMappedTest, rb_open_mapped_GivenOtherLayout_ReturnsError)
+{
+    rb_mapped_t mrb;
+    ASSERT_EQ(rb_open_mapped(&mrb, m_path.c_str(), m_cap, sizeof(uint32_t)), RB_OK);
+    ASSERT_EQ(rb_close_mapped(&mrb), RB_OK);
+
+    EXPECT_EQ(rb_open_mapped(&mrb, m_path.c_str(), m_cap + 1, sizeof(uint32_t)),
+              RB_INVALID_ARG);
+    EXPECT_EQ(rb_open_mapped(&mrb, m_path.c_str(), m_cap * 2, sizeof(uint16_t)),
+              RB_INVALID_ARG);
+}
+
+TEST_F(RbMappedTest, rb_open_mapped_GivenCrashedProcess_RestoresLastCommit)
+{
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        // the child dies without closing, the last push isn't committed
+        rb_mapped_t mrb;
+        if (rb_open_mapped(&mrb, m_path.c_str(), m_cap, sizeof(uint32_t)) != RB_OK)
+        {
+            _exit(1);
+        }
+        for (uint32_t val = 1; val <= 3; ++val)
+        {
+            rb_add(&mrb.rb, &val);
+            rb_mapped_commit(&mrb);
+        }
+        uint32_t val = 4;
+        rb_add(&mrb.rb, &val);
+        _exit(0);
+    }
+
+    int status;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+
+    rb_mapped_t mrb;
+    ASSERT_EQ(rb_open_mapped(&mrb, m_path.c_str(), m_cap, sizeof(uint32_t)), RB_OK);
+    EXPECT_EQ(readAll(&mrb), std::vector<uint32_t>({1, 2, 3}));
+    EXPECT_EQ(rb_close_mapped(&mrb), RB_OK);
+}
+
+TEST_F(RbMappedTest, rb_open_mapped_GivenTornCommit_RestoresPreviousCommit)
+{
+    rb_mapped_t mrb;
+    ASSERT_EQ(rb_open_mapped(&mrb, m_path.c_str(), m_cap, sizeof(uint32_t)), RB_OK);
+    ASSERT_EQ(rb_mapped_set_sync(&mrb, 2), RB_OK);
+    for (uint32_t val = 1; val <= 3; ++val)
+    {
+        ASSERT_EQ(rb_add(&mrb.rb, &val), RB_OK);
+        ASSERT_EQ(rb_mapped_commit(&mrb), RB_OK);
+    }
+    // unmap without the final commit of rb_close_mapped()
+    const uint64_t lastSeq = mrb.seq;
+    ASSERT_EQ(munmap(mrb.map, mrb.map_size), 0);
+    close(mrb.fd);
+
+    // damage the slot of the newest commit, as if the process died while writing it
+    const int fd = open(m_path.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+    const off_t offset = offsetof(rb_mapped_hdr_t, slots) +
+                         (lastSeq & 1) * sizeof(rb_mapped_slot_t) +
+                         offsetof(rb_mapped_slot_t, head);
+    const uint64_t garbage = 0x1234;
+    ASSERT_EQ(pwrite(fd, &garbage, sizeof(garbage), offset), (ssize_t)sizeof(garbage));
+    close(fd);
+
+    ASSERT_EQ(rb_open_mapped(&mrb, m_path.c_str(), m_cap, sizeof(uint32_t)), RB_OK);
+    EXPECT_EQ(readAll(&mrb), std::vector<uint32_t>({1, 2}));
+    EXPECT_EQ(rb_close_mapped(&mrb), RB_OK);
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+
+#include "rb_mpmc.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+class RbMpmcInitialized : public ::testing::Test
+{
+public:
+
+    void SetUp() override
+    {
+        ASSERT_EQ(rb_mpmc_init(&m_rb, m_buff, sizeof(m_buff), m_elSize), RB_OK);
+    }
+
+protected:
+
+    static const size_t m_cap    = 8;
+    const size_t        m_elSize = sizeof(uint32_t);
+    size_t m_buff[RB_MPMC_BUFF_SIZE(m_cap, sizeof(uint32_t)) / sizeof(size_t)];
+    rb_mpmc_t           m_rb;
+};
+
+TEST(RbMpmcTest, rb_mpmc_init_WhenGivenInvalidArgument_ReturnsError)
+{
+    rb_mpmc_t rb = {};
+    size_t    buff[16];
+
+    EXPECT_EQ(rb_mpmc_init(NULL, buff, sizeof(buff), sizeof(int)), RB_INVALID_ARG);
+    EXPECT_EQ(rb_mpmc_init(&rb, NULL, sizeof(buff), sizeof(int)), RB_INVALID_ARG);
+    EXPECT_EQ(rb_mpmc_init(&rb, buff, 0, sizeof(int)), RB_INVALID_ARG);
+    EXPECT_EQ(rb_mpmc_init(&rb, buff, sizeof(buff), 0), RB_INVALID_ARG);
+    EXPECT_EQ(rb_mpmc_init(&rb, (char*)buff + 1, sizeof(buff) - 1, sizeof(int)),
+              RB_INVALID_ARG);
+}
+
+TEST(RbMpmcTest, rb_mpmc_try_push_WhenNotInitialized_ReturnsError)
+{
+    rb_mpmc_t rb  = {};
+    uint32_t  val = 0;
+
+    EXPECT_EQ(rb_mpmc_try_push(&rb, &val), RB_NOT_INIT);
+    EXPECT_EQ(rb_mpmc_try_pop(&rb, &val), RB_NOT_INIT);
+}
+
+TEST(RbMpmcTest, rb_mpmc_init_GivenNonPowerOfTwoCells_RoundsCapacityDown)
+{
+    rb_mpmc_t rb;
+    size_t    buff[RB_MPMC_BUFF_SIZE(13, sizeof(size_t)) / sizeof(size_t)];
+
+    ASSERT_EQ(rb_mpmc_init(&rb, buff, sizeof(buff), sizeof(size_t)), RB_OK);
+    EXPECT_EQ(rb_mpmc_capacity(&rb), 8);
+}
+
+TEST_F(RbMpmcInitialized, rb_mpmc_try_push_GivenEmptyBuffer_WhenAddMaxElements_ThenFull)
+{
+    for (uint32_t i = 0; i < m_cap; ++i)
+    {
+        EXPECT_EQ(rb_mpmc_try_push(&m_rb, &i), RB_OK);
+    }
+
+    uint32_t val = 0;
+    EXPECT_EQ(rb_mpmc_try_push(&m_rb, &val), RB_FULL);
+}
+
+TEST_F(RbMpmcInitialized, rb_mpmc_try_pop_GivenEmptyBuffer_ReturnsError)
+{
+    uint32_t val;
+    EXPECT_EQ(rb_mpmc_try_pop(&m_rb, &val), RB_EMPTY);
+}
+
+TEST_F(RbMpmcInitialized, rb_mpmc_try_pop_WhenWrappedAround_ReadsValuesInOrder)
+{
+    uint32_t next     = 0;
+    uint32_t expected = 0;
+    for (size_t round = 0; round < 3 * m_cap; ++round)
+    {
+        while (rb_mpmc_try_push(&m_rb, &next) == RB_OK)
+        {
+            next++;
+        }
+
+        uint32_t val;
+        for (size_t i = 0; i < m_cap / 2 + 1; ++i)
+        {
+            ASSERT_EQ(rb_mpmc_try_pop(&m_rb, &val), RB_OK);
+            EXPECT_EQ(val, expected++);
+        }
+    }
+}
+
+TEST(RbMpmcTest, rb_mpmc_GivenSeveralProducersAndConsumers_DeliversEachValueOnce)
+{
+    const size_t   nThreads     = 3;
+    const uint32_t nPerProducer = 100000;
+    const uint32_t nValues      = nThreads * nPerProducer;
+
+    static size_t buff[RB_MPMC_BUFF_SIZE(64, sizeof(uint32_t)) / sizeof(size_t)];
+    rb_mpmc_t     rb;
+    ASSERT_EQ(rb_mpmc_init(&rb, buff, sizeof(buff), sizeof(uint32_t)), RB_OK);
+
+    std::vector<std::atomic<uint32_t>> seen(nValues);
+    std::atomic<uint32_t>              consumed(0);
+    std::vector<std::thread>           threads;
+    for (size_t t = 0; t < nThreads; ++t)
+    {
+        threads.emplace_back([&rb, t, nPerProducer]() {
+            for (uint32_t i = 0; i < nPerProducer; ++i)
+            {
+                uint32_t val = t * nPerProducer + i;
+                while (rb_mpmc_try_push(&rb, &val) == RB_FULL)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&rb, &seen, &consumed, nValues]() {
+            while (consumed.load() < nValues)
+            {
+                uint32_t val;
+                if (rb_mpmc_try_pop(&rb, &val) == RB_OK)
+                {
+                    seen[val]++;
+                    consumed++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+
+    size_t wrongCount = 0;
+    for (const auto& count: seen)
+    {
+        wrongCount += (count.load() != 1);
+    }
+    EXPECT_EQ(wrongCount, 0);
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include "rb_shm.h"
+
+#include <chrono>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+
+class RbShmTest : public ::testing::Test
+{
+public:
+
+    void SetUp() override
+    {
+        m_name = "/rbShmTest_" + std::to_string(getpid());
+        rb_shm_unlink(m_name.c_str());
+    }
+
+    void TearDown() override
+    {
+        rb_shm_unlink(m_name.c_str());
+    }
+
+protected:
+
+    std::string m_name;
+};
+
+TEST_F(RbShmTest, rb_shm_create_WhenGivenInvalidArgument_ReturnsError)
+{
+    rb_shm_t rb;
+
+    EXPECT_EQ(rb_shm_create(NULL, NULL, 8, 4), RB_INVALID_ARG);
+    EXPECT_EQ(rb_shm_create(&rb, NULL, 0, 4), RB_INVALID_ARG);
+    EXPECT_EQ(rb_shm_create(&rb, NULL, 8, 0), RB_INVALID_ARG);
+    EXPECT_EQ(rb_shm_attach(&rb, m_name.c_str()), RB_IO_ERROR);
+    EXPECT_EQ(rb_shm_fd(&rb), -1);
+    EXPECT_EQ(rb_shm_push(&rb, &rb), RB_NOT_INIT);
+}
+
+TEST_F(RbShmTest, rb_shm_push_GivenAttachedHandle_TransfersValuesInOrder)
+{
+    rb_shm_t prod;
+    rb_shm_t cons;
+    ASSERT_EQ(rb_shm_create(&prod, m_name.c_str(), 6, sizeof(uint32_t)), RB_OK);
+    EXPECT_EQ(rb_shm_create(&cons, m_name.c_str(), 6, sizeof(uint32_t)), RB_IO_ERROR);
+    ASSERT_EQ(rb_shm_attach(&cons, m_name.c_str()), RB_OK);
+
+    // the capacity is rounded down to 4
+    for (uint32_t val = 0; val < 4; ++val)
+    {
+        ASSERT_EQ(rb_shm_push(&prod, &val), RB_OK);
+    }
+    uint32_t val = 4;
+    EXPECT_EQ(rb_shm_push(&prod, &val), RB_FULL);
+
+    for (uint32_t expected = 0; expected < 4; ++expected)
+    {
+        ASSERT_EQ(rb_shm_pop(&cons, &val), RB_OK);
+        EXPECT_EQ(val, expected);
+    }
+    EXPECT_EQ(rb_shm_pop(&cons, &val), RB_EMPTY);
+
+    EXPECT_EQ(rb_shm_close(&cons), RB_OK);
+    EXPECT_EQ(rb_shm_close(&prod), RB_OK);
+}
+
+TEST_F(RbShmTest, rb_shm_pop_wait_GivenEmptyBuffer_TimesOut)
+{
+    rb_shm_t rb;
+    ASSERT_EQ(rb_shm_create(&rb, NULL, 4, sizeof(uint32_t)), RB_OK);
+
+    uint32_t   val;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(rb_shm_pop_wait(&rb, &val, 20), RB_EMPTY);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(rb_shm_close(&rb), RB_OK);
+}
+
+TEST_F(RbShmTest, rb_shm_pop_wait_GivenSleepingConsumer_WakesUpOnPush)
+{
+    rb_shm_t prod;
+    rb_shm_t cons;
+    ASSERT_EQ(rb_shm_create(&prod, NULL, 4, sizeof(uint32_t)), RB_OK);
+    ASSERT_EQ(rb_shm_attach_fd(&cons, rb_shm_fd(&prod)), RB_OK);
+
+    uint32_t    val = 0;
+    std::thread consumer([&]() { EXPECT_EQ(rb_shm_pop_wait(&cons, &val, 5000), RB_OK); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    const uint32_t sent = 42;
+    ASSERT_EQ(rb_shm_push(&prod, &sent), RB_OK);
+    consumer.join();
+    EXPECT_EQ(val, sent);
+
+    EXPECT_EQ(rb_shm_close(&cons), RB_OK);
+    EXPECT_EQ(rb_shm_close(&prod), RB_OK);
+}
+
+TEST_F(RbShmTest, rb_shm_GivenTwoProcesses_TransfersAllValuesInOrder)
+{
+    const uint32_t nValues = 100000;
+
+    rb_shm_t prod;
+    ASSERT_EQ(rb_shm_create(&prod, m_name.c_str(), 64, sizeof(uint32_t)), RB_OK);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        // a new mapping in the child, likely at another address
+        rb_shm_t cons;
+        if (rb_shm_attach(&cons, m_name.c_str()) != RB_OK)
+        {
+            _exit(2);
+        }
+        for (uint32_t expected = 0; expected < nValues; ++expected)
+        {
+            uint32_t val;
+            if ((rb_shm_pop_wait(&cons, &val, 5000) != RB_OK) || (val != expected))
+            {
+                _exit(1);
+            }
+        }
+        _exit(0);
+    }
+
+    for (uint32_t val = 0; val < nValues; ++val)
+    {
+        ASSERT_EQ(rb_shm_push_wait(&prod, &val, 5000), RB_OK);
+    }
+
+    int status;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_EQ(rb_shm_close(&prod), RB_OK);
+}
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,381 @@
+#include "gtest/gtest.h"
+
+#include "rb_spsc.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+class RbSpscInitialized : public ::testing::Test
+{
+public:
+
+    void SetUp() override
+    {
+        ASSERT_EQ(rb_spsc_init(&m_rb, m_buff, sizeof(m_buff), m_elSize), RB_OK);
+    }
+
+protected:
+
+    static constexpr size_t m_cap    = 5;
+    const size_t            m_elSize = sizeof(size_t);
+    size_t                  m_buff[m_cap + 1];
+    rb_spsc_t               m_rb;
+};
+
+TEST(RbSpscTest, rb_spsc_init_WhenGivenInvalidArgument_ReturnsError)
+{
+    rb_spsc_t rb       = {};
+    size_t    elSize   = sizeof(int);
+    size_t    buffSize = elSize * 5;
+    char      buff[buffSize];
+
+    EXPECT_EQ(rb_spsc_init(NULL, buff, buffSize, elSize), RB_INVALID_ARG);
+    EXPECT_EQ(rb_spsc_init(&rb, NULL, buffSize, elSize), RB_INVALID_ARG);
+    EXPECT_EQ(rb_spsc_init(&rb, buff, 0, elSize), RB_INVALID_ARG);
+    EXPECT_EQ(rb_spsc_init(&rb, buff, buffSize, 0), RB_INVALID_ARG);
+}
+
+TEST(RbSpscTest, rb_spsc_push_WhenNotInitialized_ReturnsError)
+{
+    rb_spsc_t rb  = {};
+    uint32_t  val = 0;
+
+    EXPECT_EQ(rb_spsc_push(&rb, &val), RB_NOT_INIT);
+    EXPECT_EQ(rb_spsc_pop(&rb, &val), RB_NOT_INIT);
+}
+
+TEST(RbSpscTest, rb_spsc_t_ProducerAndConsumerIndicesOnSeparateCacheLines)
+{
+    EXPECT_GE(offsetof(rb_spsc_t, cons) - offsetof(rb_spsc_t, prod), RB_CACHE_LINE_SIZE);
+    EXPECT_GE(offsetof(rb_spsc_t, cfg) - offsetof(rb_spsc_t, cons), RB_CACHE_LINE_SIZE);
+}
+
+TEST_F(RbSpscInitialized, rb_spsc_push_GivenEmptyBuffer_WhenAddMaxElements_ThenFull)
+{
+    for (size_t i = 0; i < m_cap; ++i)
+    {
+        EXPECT_EQ(rb_spsc_push(&m_rb, &i), RB_OK);
+    }
+    EXPECT_TRUE(rb_spsc_is_full(&m_rb));
+
+    size_t val = 0;
+    EXPECT_EQ(rb_spsc_push(&m_rb, &val), RB_FULL);
+}
+
+TEST_F(RbSpscInitialized, rb_spsc_pop_GivenEmptyBuffer_ReturnsError)
+{
+    size_t val;
+    EXPECT_TRUE(rb_spsc_is_empty(&m_rb));
+    EXPECT_EQ(rb_spsc_pop(&m_rb, &val), RB_EMPTY);
+}
+
+TEST_F(RbSpscInitialized, rb_spsc_pop_WhenWrappedAround_ReadsValuesInOrder)
+{
+    size_t next     = 0;
+    size_t expected = 0;
+    for (size_t round = 0; round < 3 * m_cap; ++round)
+    {
+        // keep the buffer partially filled so both indices wrap several times
+        while (rb_spsc_push(&m_rb, &next) == RB_OK)
+        {
+            next++;
+        }
+
+        size_t val;
+        for (size_t i = 0; i < m_cap / 2 + 1; ++i)
+        {
+            ASSERT_EQ(rb_spsc_pop(&m_rb, &val), RB_OK);
+            EXPECT_EQ(val, expected++);
+        }
+    }
+}
+
+TEST_F(RbSpscInitialized, rb_spsc_pop_n_WhenWrappedAround_ReadsAvailableValuesInOrder)
+{
+    size_t vals[m_cap + 1];
+    size_t popped = 9;
+    EXPECT_EQ(rb_spsc_pop_n(&m_rb, vals, m_cap, &popped), RB_EMPTY);
+    EXPECT_EQ(popped, 0);
+    EXPECT_EQ(rb_spsc_pop_n(&m_rb, vals, 0, &popped), RB_OK);
+
+    size_t next     = 0;
+    size_t expected = 0;
+    for (size_t round = 0; round < 3 * m_cap; ++round)
+    {
+        while (rb_spsc_push(&m_rb, &next) == RB_OK)
+        {
+            next++;
+        }
+
+        // asks for more than is kept every other round
+        const size_t n = (round % 2 == 0) ? m_cap / 2 + 1 : m_cap + 1;
+        ASSERT_EQ(rb_spsc_pop_n(&m_rb, vals, n, &popped), RB_OK);
+        ASSERT_EQ(popped, (n > m_cap) ? m_cap : n);
+        for (size_t i = 0; i < popped; ++i)
+        {
+            EXPECT_EQ(vals[i], expected++);
+        }
+    }
+}
+
+TEST(RbSpscTest, rb_spsc_GivenProducerAndConsumerThreads_TransfersAllValuesInOrder)
+{
+    const size_t nValues = 1000000;
+    uint64_t     buff[64];
+    rb_spsc_t    rb;
+    ASSERT_EQ(rb_spsc_init(&rb, buff, sizeof(buff), sizeof(buff[0])), RB_OK);
+
+    std::thread producer([&rb, nValues]() {
+        for (uint64_t i = 0; i < nValues; ++i)
+        {
+            while (rb_spsc_push(&rb, &i) == RB_FULL)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    size_t mismatches = 0;
+    for (uint64_t expected = 0; expected < nValues; ++expected)
+    {
+        uint64_t val;
+        while (rb_spsc_pop(&rb, &val) == RB_EMPTY)
+        {
+            std::this_thread::yield();
+        }
+        mismatches += (val != expected);
+    }
+    producer.join();
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_TRUE(rb_spsc_is_empty(&rb));
+}
+
+TEST(RbSpscTest, rb_spsc_push_overwrite_GivenNotOverwriteBuffer_ReturnsError)
+{
+    size_t    buff[4];
+    size_t    val = 0;
+    rb_spsc_t rb;
+    ASSERT_EQ(rb_spsc_init(&rb, buff, sizeof(buff), sizeof(buff[0])), RB_OK);
+
+    EXPECT_EQ(rb_spsc_push_overwrite(&rb, &val, NULL, NULL), RB_INVALID_ARG);
+}
+
+TEST(RbSpscTest, rb_spsc_push_overwrite_GivenFullBuffer_EvictsOldestElement)
+{
+    const size_t cap = 4;
+    size_t       buff[cap + 1];
+    rb_spsc_t    rb;
+    ASSERT_EQ(rb_spsc_init_overwrite(&rb, buff, sizeof(buff), sizeof(buff[0])), RB_OK);
+
+    for (size_t i = 0; i < cap; ++i)
+    {
+        ASSERT_EQ(rb_spsc_push(&rb, &i), RB_OK);
+    }
+    size_t val = 9;
+    EXPECT_TRUE(rb_spsc_is_full(&rb));
+    EXPECT_EQ(rb_spsc_push(&rb, &val), RB_FULL);
+
+    size_t old     = 0;
+    bool   evicted = false;
+    ASSERT_EQ(rb_spsc_push_overwrite(&rb, &val, &old, &evicted), RB_OK);
+    EXPECT_TRUE(evicted);
+    EXPECT_EQ(old, 0);
+
+    size_t expectedValues[] = {1, 2, 3, 9};
+    for (size_t expected: expectedValues)
+    {
+        ASSERT_EQ(rb_spsc_pop(&rb, &val), RB_OK);
+        EXPECT_EQ(val, expected);
+    }
+    EXPECT_EQ(rb_spsc_pop(&rb, &val), RB_EMPTY);
+
+    size_t vals[cap];
+    size_t popped = 0;
+    ASSERT_EQ(rb_spsc_push_overwrite(&rb, &val, &old, &evicted), RB_OK);
+    ASSERT_EQ(rb_spsc_pop_n(&rb, vals, cap, &popped), RB_OK);
+    EXPECT_EQ(popped, 1);
+    EXPECT_EQ(vals[0], 9);
+}
+
+TEST(RbSpscTest, rb_spsc_push_overwrite_GivenConcurrentConsumer_EachValueSeenAtMostOnce)
+{
+    const uint64_t nValues = 200000;
+    uint64_t       buff[16];
+    rb_spsc_t      rb;
+    ASSERT_EQ(rb_spsc_init_overwrite(&rb, buff, sizeof(buff), sizeof(buff[0])), RB_OK);
+
+    uint64_t    nEvicted = 0;
+    std::thread producer([&rb, &nEvicted, nValues]() {
+        for (uint64_t i = 1; i <= nValues; ++i)
+        {
+            bool evicted = false;
+            rb_spsc_push_overwrite(&rb, &i, NULL, &evicted);
+            nEvicted += evicted;
+        }
+    });
+
+    // values must come out strictly increasing, gaps are the evicted values
+    uint64_t nPopped    = 0;
+    uint64_t last       = 0;
+    size_t   mismatches = 0;
+    while (last < nValues)
+    {
+        uint64_t val;
+        if (rb_spsc_pop(&rb, &val) == RB_OK)
+        {
+            mismatches += (val <= last);
+            last = val;
+            nPopped++;
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(nPopped + nEvicted, nValues);
+}
+
+TEST_F(RbSpscInitialized, rb_spsc_pop_wait_GivenEmptyBuffer_TimesOut)
+{
+    size_t     val;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(rb_spsc_pop_wait(&m_rb, &val, 20), RB_EMPTY);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(rb_spsc_pop_wait(&m_rb, &val, 0), RB_EMPTY);
+}
+
+TEST_F(RbSpscInitialized, rb_spsc_push_wait_GivenFullBuffer_TimesOut)
+{
+    for (size_t i = 0; i < m_cap; ++i)
+    {
+        EXPECT_EQ(rb_spsc_push_wait(&m_rb, &i, 0), RB_OK);
+    }
+
+    size_t     val   = 0;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(rb_spsc_push_wait(&m_rb, &val, 20), RB_FULL);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST_F(RbSpscInitialized, rb_spsc_pop_wait_GivenSleepingConsumer_WakesUpOnPush)
+{
+    size_t      val = 0;
+    std::thread consumer(
+        [&]() { EXPECT_EQ(rb_spsc_pop_wait(&m_rb, &val, 5000), RB_OK); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    const size_t sent = 42;
+    ASSERT_EQ(rb_spsc_push(&m_rb, &sent), RB_OK);
+    consumer.join();
+    EXPECT_EQ(val, sent);
+}
+
+TEST_F(RbSpscInitialized, rb_spsc_push_wait_GivenSleepingProducer_WakesUpOnPop)
+{
+    for (size_t i = 0; i < m_cap; ++i)
+    {
+        ASSERT_EQ(rb_spsc_push(&m_rb, &i), RB_OK);
+    }
+
+    const size_t sent = 42;
+    std::thread  producer(
+        [&]() { EXPECT_EQ(rb_spsc_push_wait(&m_rb, &sent, 5000), RB_OK); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    size_t val;
+    ASSERT_EQ(rb_spsc_pop(&m_rb, &val), RB_OK);
+    producer.join();
+    EXPECT_TRUE(rb_spsc_is_full(&m_rb));
+}
+
+TEST(RbSpscTest, rb_spsc_wait_GivenProducerAndConsumerThreads_TransfersAllValuesInOrder)
+{
+    const size_t nValues = 1000000;
+    uint64_t     buff[64];
+    rb_spsc_t    rb;
+    ASSERT_EQ(rb_spsc_init(&rb, buff, sizeof(buff), sizeof(buff[0])), RB_OK);
+
+    std::thread producer([&rb, nValues]() {
+        for (uint64_t i = 0; i < nValues; ++i)
+        {
+            EXPECT_EQ(rb_spsc_push_wait(&rb, &i, 5000), RB_OK);
+            // let the consumer run dry now and then, so it has to sleep
+            if ((i % 50000) == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    });
+
+    size_t mismatches = 0;
+    for (uint64_t expected = 0; expected < nValues; ++expected)
+    {
+        uint64_t val = 0;
+        EXPECT_EQ(rb_spsc_pop_wait(&rb, &val, 5000), RB_OK);
+        mismatches += (val != expected);
+    }
+    producer.join();
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_TRUE(rb_spsc_is_empty(&rb));
+}
+
+#ifdef RB_ENABLE_STATS
+TEST_F(RbSpscInitialized, rb_spsc_stats_snapshot_GivenPushesAndPops_CountsThem)
+{
+    size_t val = 0;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(rb_spsc_push(&m_rb, &i), RB_OK);
+    }
+    ASSERT_EQ(rb_spsc_pop(&m_rb, &val), RB_OK);
+    ASSERT_EQ(rb_spsc_pop(&m_rb, &val), RB_OK);
+    for (size_t i = 0; i < m_cap; ++i)
+    {
+        rb_spsc_push(&m_rb, &i);
+    }
+    EXPECT_EQ(rb_spsc_push(&m_rb, &val), RB_FULL);
+    while (rb_spsc_pop(&m_rb, &val) == RB_OK)
+    {
+    }
+
+    rb_stats_t stats;
+    ASSERT_EQ(rb_spsc_stats_snapshot(&m_rb, &stats), RB_OK);
+    EXPECT_EQ(stats.pushes, 3u + m_cap - 1);
+    EXPECT_EQ(stats.pops, stats.pushes);
+    EXPECT_EQ(stats.full_rejects, 2u);
+    EXPECT_EQ(stats.empty_rejects, 1u);
+    EXPECT_EQ(stats.overwrites, 0u);
+    EXPECT_EQ(stats.high_water, m_cap);
+}
+
+TEST(RbSpscTest, rb_spsc_stats_snapshot_GivenOverwriteBuffer_CountsEvictions)
+{
+    size_t    buff[4];
+    rb_spsc_t rb;
+    ASSERT_EQ(rb_spsc_init_overwrite(&rb, buff, sizeof(buff), sizeof(buff[0])), RB_OK);
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(rb_spsc_push_overwrite(&rb, &i, NULL, NULL), RB_OK);
+    }
+
+    rb_stats_t stats;
+    ASSERT_EQ(rb_spsc_stats_snapshot(&rb, &stats), RB_OK);
+    EXPECT_EQ(stats.pushes, 10u);
+    EXPECT_EQ(stats.overwrites, 6u);
+    EXPECT_EQ(stats.high_water, 4u);
+}
+#else
+TEST_F(RbSpscInitialized, rb_spsc_stats_snapshot_WhenStatsDisabled_ReturnsUnsupported)
+{
+    rb_stats_t stats;
+    EXPECT_EQ(rb_spsc_stats_snapshot(&m_rb, &stats), RB_UNSUPPORTED);
+}
+#endif
+
+} // namespace
\ No newline at end of file
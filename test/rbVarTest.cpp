@@ -0,0 +1,222 @@
+#include "gtest/gtest.h"
+
+#include "rb_var.h"
+
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+
+namespace
+{
+
+class RbVarInitialized : public ::testing::Test
+{
+public:
+
+    void SetUp() override
+    {
+        ASSERT_EQ(rb_var_init(&m_rb, m_buff, sizeof(m_buff)), RB_OK);
+    }
+
+protected:
+
+    // pushes a record filled with the given byte
+    rb_ret_t pushFilled(size_t len, char fill)
+    {
+        std::string rec(len, fill);
+        return rb_var_push(&m_rb, rec.data(), rec.size());
+    }
+
+    std::string peekString()
+    {
+        const void* ptr = NULL;
+        size_t      len = 0;
+        EXPECT_EQ(rb_var_peek(&m_rb, &ptr, &len), RB_OK);
+        return std::string((const char*)ptr, len);
+    }
+
+    uint64_t m_buff[16];
+    rb_var_t m_rb;
+};
+
+TEST(RbVarTest, rb_var_init_WhenGivenInvalidArgument_ReturnsError)
+{
+    rb_var_t rb;
+    uint64_t buff[4];
+
+    EXPECT_EQ(rb_var_init(NULL, buff, sizeof(buff)), RB_INVALID_ARG);
+    EXPECT_EQ(rb_var_init(&rb, NULL, sizeof(buff)), RB_INVALID_ARG);
+    EXPECT_EQ(rb_var_init(&rb, buff, 2 * RB_VAR_ALIGN), RB_INVALID_ARG);
+    EXPECT_EQ(rb_var_init(&rb, buff, sizeof(buff)), RB_OK);
+    EXPECT_EQ(rb_var_max_len(&rb), sizeof(buff) - RB_VAR_HDR_SIZE - RB_VAR_ALIGN);
+}
+
+TEST(RbVarTest, rb_var_push_WhenNotInitialized_ReturnsError)
+{
+    rb_var_t    rb  = {};
+    const void* ptr = NULL;
+    size_t      len = 0;
+
+    EXPECT_EQ(rb_var_push(&rb, "a", 1), RB_NOT_INIT);
+    EXPECT_EQ(rb_var_peek(&rb, &ptr, &len), RB_NOT_INIT);
+    EXPECT_EQ(rb_var_release(&rb), RB_NOT_INIT);
+}
+
+TEST_F(RbVarInitialized, rb_var_push_GivenMixedRecords_ReadsThemBackInOrder)
+{
+    const uint8_t hr     = 72;
+    const int16_t ecg[5] = {-3, 120, 512, -40, 7};
+    const char*   note   = "arrhythmia";
+
+    EXPECT_EQ(rb_var_push(&m_rb, &hr, sizeof(hr)), RB_OK);
+    EXPECT_EQ(rb_var_push(&m_rb, ecg, sizeof(ecg)), RB_OK);
+    EXPECT_EQ(rb_var_push(&m_rb, note, strlen(note)), RB_OK);
+    EXPECT_EQ(rb_var_count(&m_rb), 3u);
+
+    const void* ptr = NULL;
+    size_t      len = 0;
+    ASSERT_EQ(rb_var_peek(&m_rb, &ptr, &len), RB_OK);
+    EXPECT_EQ(len, sizeof(hr));
+    EXPECT_EQ(*(const uint8_t*)ptr, hr);
+    ASSERT_EQ(rb_var_release(&m_rb), RB_OK);
+
+    ASSERT_EQ(rb_var_peek(&m_rb, &ptr, &len), RB_OK);
+    ASSERT_EQ(len, sizeof(ecg));
+    EXPECT_EQ((uintptr_t)ptr % RB_VAR_ALIGN, 0u);
+    EXPECT_EQ(memcmp(ptr, ecg, sizeof(ecg)), 0);
+    ASSERT_EQ(rb_var_release(&m_rb), RB_OK);
+
+    EXPECT_EQ(peekString(), note);
+    ASSERT_EQ(rb_var_release(&m_rb), RB_OK);
+    EXPECT_EQ(rb_var_peek(&m_rb, &ptr, &len), RB_EMPTY);
+    EXPECT_EQ(rb_var_release(&m_rb), RB_EMPTY);
+}
+
+TEST_F(RbVarInitialized, rb_var_reserve_WhenRecordDoesNotFitAtEnd_WrapsWithoutSplitting)
+{
+    // 128 bytes: three 40-byte records, then free space at both ends
+    ASSERT_EQ(pushFilled(32, 'a'), RB_OK);
+    ASSERT_EQ(pushFilled(32, 'b'), RB_OK);
+    ASSERT_EQ(pushFilled(32, 'c'), RB_OK);
+    ASSERT_EQ(rb_var_release(&m_rb), RB_OK);
+    ASSERT_EQ(rb_var_release(&m_rb), RB_OK);
+
+    void* ptr = NULL;
+    ASSERT_EQ(rb_var_reserve(&m_rb, 48, &ptr), RB_OK);
+    EXPECT_EQ(ptr, (char*)m_buff + RB_VAR_HDR_SIZE);
+    memset(ptr, 'd', 48);
+    ASSERT_EQ(rb_var_commit(&m_rb, 48), RB_OK);
+
+    EXPECT_EQ(peekString(), std::string(32, 'c'));
+    ASSERT_EQ(rb_var_release(&m_rb), RB_OK);
+    EXPECT_EQ(peekString(), std::string(48, 'd'));
+}
+
+TEST_F(RbVarInitialized, rb_var_reserve_WhenNoContiguousSpace_ReturnsFull)
+{
+    ASSERT_EQ(pushFilled(64, 'a'), RB_OK);
+    ASSERT_EQ(pushFilled(24, 'b'), RB_OK);
+    EXPECT_EQ(pushFilled(24, 'c'), RB_FULL);
+    EXPECT_EQ(pushFilled(rb_var_max_len(&m_rb) + 1, 'c'), RB_INVALID_ARG);
+
+    // space is freed at the start, but the record must not overrun the tail
+    ASSERT_EQ(rb_var_release(&m_rb), RB_OK);
+    EXPECT_EQ(pushFilled(64, 'c'), RB_FULL);
+    EXPECT_EQ(pushFilled(56, 'c'), RB_OK);
+    EXPECT_EQ(rb_var_count(&m_rb), 2u);
+}
+
+TEST_F(RbVarInitialized, rb_var_commit_GivenShorterOrNoLength_StoresOrCancels)
+{
+    void* ptr = NULL;
+    EXPECT_EQ(rb_var_commit(&m_rb, 1), RB_INVALID_ARG);
+
+    ASSERT_EQ(rb_var_reserve(&m_rb, 16, &ptr), RB_OK);
+    EXPECT_EQ(rb_var_commit(&m_rb, 17), RB_INVALID_ARG);
+    EXPECT_EQ(rb_var_commit(&m_rb, 0), RB_OK);
+    EXPECT_EQ(rb_var_count(&m_rb), 0u);
+
+    ASSERT_EQ(rb_var_reserve(&m_rb, 16, &ptr), RB_OK);
+    memcpy(ptr, "abc", 3);
+    ASSERT_EQ(rb_var_commit(&m_rb, 3), RB_OK);
+    EXPECT_EQ(peekString(), "abc");
+}
+
+TEST(RbVarTest, rb_var_GivenRandomRecords_MatchesQueueModel)
+{
+    std::mt19937                          gen(11);
+    std::uniform_int_distribution<size_t> lenDist(1, 100);
+    char                                  buff[1000];
+    rb_var_t                              rb;
+    ASSERT_EQ(rb_var_init(&rb, buff, sizeof(buff)), RB_OK);
+
+    std::deque<std::string> model;
+    size_t                  fulls = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        if (gen() % 2)
+        {
+            std::string rec(lenDist(gen), char('a' + (i % 26)));
+            const rb_ret_t ret = rb_var_push(&rb, rec.data(), rec.size());
+            ASSERT_TRUE((ret == RB_OK) || (ret == RB_FULL));
+            if (ret == RB_OK)
+            {
+                model.push_back(rec);
+            }
+            fulls += (ret == RB_FULL);
+        }
+        else
+        {
+            const void* ptr = NULL;
+            size_t      len = 0;
+            if (model.empty())
+            {
+                ASSERT_EQ(rb_var_peek(&rb, &ptr, &len), RB_EMPTY);
+                continue;
+            }
+            ASSERT_EQ(rb_var_peek(&rb, &ptr, &len), RB_OK);
+            ASSERT_EQ(std::string((const char*)ptr, len), model.front());
+            ASSERT_GE((const char*)ptr, buff);
+            ASSERT_LE((const char*)ptr + len, buff + sizeof(buff));
+            ASSERT_EQ(rb_var_release(&rb), RB_OK);
+            model.pop_front();
+        }
+        ASSERT_EQ(rb_var_count(&rb), model.size());
+    }
+    EXPECT_GT(fulls, 0u);
+}
+
+TEST(RbVarTest, rb_var_next_WhenRecordsWrap_ReadsAllRecordsOldestFirst)
+{
+    std::mt19937                          gen(5);
+    std::uniform_int_distribution<size_t> lenDist(1, 100);
+    char                                  buff[1000];
+    rb_var_t                              rb;
+    ASSERT_EQ(rb_var_init(&rb, buff, sizeof(buff)), RB_OK);
+
+    std::deque<std::string> model;
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string rec(lenDist(gen), char('a' + (i % 26)));
+        while (rb_var_push(&rb, rec.data(), rec.size()) == RB_FULL)
+        {
+            ASSERT_EQ(rb_var_release(&rb), RB_OK);
+            model.pop_front();
+        }
+        model.push_back(rec);
+
+        rb_var_it_t it;
+        const void* ptr;
+        size_t      len;
+        ASSERT_EQ(rb_var_init_read_it(&rb, &it), RB_OK);
+        for (const std::string& expected: model)
+        {
+            ASSERT_EQ(rb_var_next(&it, &ptr, &len), RB_OK);
+            ASSERT_EQ(std::string((const char*)ptr, len), expected);
+        }
+        ASSERT_EQ(rb_var_next(&it, &ptr, &len), RB_EMPTY);
+    }
+}
+
+} // namespace
\ No newline at end of file
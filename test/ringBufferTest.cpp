@@ -56,6 +56,54 @@ public:
     }
 };
 
+class RingBufferPow2 : public RingBufferTest
+{
+public:
+
+    void SetUp() override
+    {
+        ASSERT_EQ(rb_init_pow2(&m_rb, m_buff, sizeof(m_buff), sizeof(m_buff[0])), RB_OK);
+    }
+
+protected:
+
+    static constexpr size_t m_cap = 8;
+    // one more element than needed, it can't be used by the power of two capacity
+    size_t m_buff[m_cap + 1];
+};
+
+// timestamped sample, the timestamp must come first
+struct TsSample
+{
+    uint64_t ts;
+    uint32_t val;
+};
+
+class RingBufferTs : public RingBufferTest
+{
+public:
+
+    void SetUp() override
+    {
+        ASSERT_EQ(rb_init_ts(&m_rb, m_buff, sizeof(m_buff), sizeof(m_buff[0])), RB_OK);
+    }
+
+protected:
+
+    // adds samples with timestamps 10 * i, evicting the oldest ones, so they wrap
+    void fill(size_t n)
+    {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            TsSample sample = {10u * i, i};
+            ASSERT_EQ(rb_push_overwrite(&m_rb, &sample, NULL, NULL), RB_OK);
+        }
+    }
+
+    static constexpr size_t m_cap = 8;
+    TsSample                m_buff[m_cap + 1];
+};
+
 TEST_F(RingBufferTest, rb_init_WhenGivenInvalidArgument_ReturnsError)
 {
     // Arrange
@@ -423,4 +471,513 @@ TEST_F(RingBufferTest, rb_get_next_val_WhenReadComplexStructure_ReadCorrectValue
     EXPECT_EQ(el2, expectedEl2);
 }
 
+TEST_F(RingBufferTest, rb_add_n_WhenNotInitialized_ReturnsError)
+{
+    ring_buffer_t rb      = {};
+    size_t        vals[2] = {};
+    size_t        count   = 1;
+
+    EXPECT_EQ(rb_add_n(&rb, vals, 2, &count), RB_NOT_INIT);
+    EXPECT_EQ(count, 0);
+    EXPECT_EQ(rb_remove_n(&rb, 2, NULL), RB_NOT_INIT);
+}
+
+TEST_F(RingBufferInitialized, rb_add_n_GivenMoreElementsThanFreeSpace_AddsUntilFull)
+{
+    size_t vals[] = {1, 2, 3, 4, 5, 6, 7};
+    size_t added  = 0;
+
+    EXPECT_EQ(rb_add_n(&m_rb, vals, 7, &added), RB_OK);
+    EXPECT_EQ(added, m_cap);
+    EXPECT_TRUE(rb_is_full(&m_rb));
+
+    EXPECT_EQ(rb_add_n(&m_rb, vals, 1, &added), RB_FULL);
+    EXPECT_EQ(added, 0);
+}
+
+TEST_F(RingBufferInitialized, rb_add_n_GivenZeroElements_Succeeds)
+{
+    size_t added = 1;
+    EXPECT_EQ(rb_add_n(&m_rb, NULL, 0, &added), RB_OK);
+    EXPECT_EQ(added, 0);
+}
+
+TEST_F(RingBufferFull, rb_add_n_WhenWrapsAround_ReadsCorrectValues)
+{
+    // initial values [0,1,2,3,4], leave [3,4] with tail in the middle of the buffer
+    ASSERT_EQ(rb_remove_n(&m_rb, 3, NULL), RB_OK);
+
+    size_t vals[] = {7, 8, 9};
+    size_t added  = 0;
+    ASSERT_EQ(rb_add_n(&m_rb, vals, 3, &added), RB_OK);
+    ASSERT_EQ(added, 3);
+    EXPECT_EQ(m_rb.head, 2);
+
+    size_t expectedValues[] = {3, 4, 7, 8, 9};
+    size_t readValues[6];
+    size_t read = 0;
+
+    rb_it_t it = {};
+    ASSERT_EQ(rb_init_read_it(&m_rb, &it), RB_OK);
+    EXPECT_EQ(rb_read_n(&it, readValues, 6, &read), RB_OK);
+    ASSERT_EQ(read, m_cap);
+    for (size_t i = 0; i < m_cap; ++i)
+    {
+        EXPECT_EQ(readValues[i], expectedValues[i]);
+    }
+    EXPECT_EQ(rb_read_n(&it, readValues, 1, &read), RB_EMPTY);
+    EXPECT_EQ(read, 0);
+}
+
+TEST_F(RingBufferFull, rb_read_n_WhenReadInParts_ContinuesFromIteratorPosition)
+{
+    rb_it_t it = {};
+    ASSERT_EQ(rb_init_read_it(&m_rb, &it), RB_OK);
+
+    size_t vals[2];
+    ASSERT_EQ(rb_read_n(&it, vals, 2, NULL), RB_OK);
+    EXPECT_EQ(vals[0], 0);
+    EXPECT_EQ(vals[1], 1);
+
+    size_t val;
+    ASSERT_EQ(rb_get_next_val(&it, &val), RB_OK);
+    EXPECT_EQ(val, 2);
+}
+
+TEST_F(RingBufferFull, rb_remove_n_GivenMoreElementsThanStored_RemovesAll)
+{
+    size_t removed = 0;
+    EXPECT_EQ(rb_remove_n(&m_rb, m_cap + 3, &removed), RB_OK);
+    EXPECT_EQ(removed, m_cap);
+    EXPECT_TRUE(rb_is_empty(&m_rb));
+
+    EXPECT_EQ(rb_remove_n(&m_rb, 1, &removed), RB_EMPTY);
+    EXPECT_EQ(removed, 0);
+}
+
+TEST_F(RingBufferInitialized, rb_reserve_write_WhenCommitted_ElementsCanBeRead)
+{
+    void*  ptr   = NULL;
+    size_t count = 0;
+    ASSERT_EQ(rb_reserve_write(&m_rb, 3, &ptr, &count), RB_OK);
+    ASSERT_EQ(count, 3);
+    EXPECT_EQ(ptr, m_buff);
+
+    // serialize in place
+    size_t* vals = (size_t*)ptr;
+    vals[0]      = 10;
+    vals[1]      = 11;
+    EXPECT_TRUE(rb_is_empty(&m_rb));
+    ASSERT_EQ(rb_commit_write(&m_rb, 2), RB_OK);
+
+    ASSERT_EQ(rb_peek_read(&m_rb, &ptr, &count), RB_OK);
+    ASSERT_EQ(count, 2);
+    EXPECT_EQ(((size_t*)ptr)[0], 10);
+    EXPECT_EQ(((size_t*)ptr)[1], 11);
+}
+
+TEST_F(RingBufferFull, rb_reserve_write_GivenFullBuffer_ReturnsError)
+{
+    void*  ptr;
+    size_t count;
+    EXPECT_EQ(rb_reserve_write(&m_rb, 1, &ptr, &count), RB_FULL);
+    EXPECT_EQ(count, 0);
+}
+
+TEST_F(RingBufferFull, rb_reserve_write_WhenFreeSpaceWraps_ReturnsRegionUpToTheEnd)
+{
+    // initial values [0,1,2,3,4], head is at the last slot of the buffer
+    ASSERT_EQ(rb_remove_n(&m_rb, 3, NULL), RB_OK);
+
+    void*  ptr;
+    size_t count;
+    ASSERT_EQ(rb_reserve_write(&m_rb, 3, &ptr, &count), RB_OK);
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(ptr, (char*)m_buff + m_cap * m_elSize);
+    ASSERT_EQ(rb_commit_write(&m_rb, count), RB_OK);
+
+    ASSERT_EQ(rb_reserve_write(&m_rb, 3, &ptr, &count), RB_OK);
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(ptr, m_buff);
+    EXPECT_EQ(rb_commit_write(&m_rb, 3), RB_INVALID_ARG);
+}
+
+TEST_F(RingBufferInitialized, rb_peek_read_GivenEmptyBuffer_ReturnsError)
+{
+    void*  ptr;
+    size_t count;
+    EXPECT_EQ(rb_peek_read(&m_rb, &ptr, &count), RB_EMPTY);
+    EXPECT_EQ(rb_peek_read(&m_rb, NULL, &count), RB_INVALID_ARG);
+}
+
+TEST_F(RingBufferFull, rb_peek_read_WhenElementsWrap_ReturnsBothSegmentsInOrder)
+{
+    // initial values [0,1,2,3,4], make them wrap: [3,4,7,8]
+    ASSERT_EQ(rb_remove_n(&m_rb, 3, NULL), RB_OK);
+    size_t vals[] = {7, 8};
+    ASSERT_EQ(rb_add_n(&m_rb, vals, 2, NULL), RB_OK);
+
+    void*  ptr;
+    size_t count;
+    ASSERT_EQ(rb_peek_read(&m_rb, &ptr, &count), RB_OK);
+    ASSERT_EQ(count, 3);
+    EXPECT_EQ(((size_t*)ptr)[0], 3);
+    EXPECT_EQ(((size_t*)ptr)[2], 7);
+    ASSERT_EQ(rb_release_read(&m_rb, count), RB_OK);
+
+    ASSERT_EQ(rb_peek_read(&m_rb, &ptr, &count), RB_OK);
+    ASSERT_EQ(count, 1);
+    EXPECT_EQ(((size_t*)ptr)[0], 8);
+    EXPECT_EQ(rb_release_read(&m_rb, 2), RB_INVALID_ARG);
+    ASSERT_EQ(rb_release_read(&m_rb, 1), RB_OK);
+    EXPECT_TRUE(rb_is_empty(&m_rb));
+}
+
+TEST_F(RingBufferInitialized, rb_size_WhenElementsAddedAndRemoved_ReturnsCount)
+{
+    EXPECT_EQ(rb_size(&m_rb), 0);
+
+    size_t vals[] = {1, 2, 3, 4};
+    ASSERT_EQ(rb_add_n(&m_rb, vals, 4, NULL), RB_OK);
+    ASSERT_EQ(rb_remove_n(&m_rb, 3, NULL), RB_OK);
+    ASSERT_EQ(rb_add_n(&m_rb, vals, 4, NULL), RB_OK);
+
+    EXPECT_EQ(rb_size(&m_rb), 5);
+}
+
+TEST_F(RingBufferTest, rb_init_pow2_WhenGivenInvalidArgument_ReturnsError)
+{
+    char buff[16];
+
+    EXPECT_EQ(rb_init_pow2(NULL, buff, sizeof(buff), 1), RB_INVALID_ARG);
+    EXPECT_EQ(rb_init_pow2(&m_rb, NULL, sizeof(buff), 1), RB_INVALID_ARG);
+    EXPECT_EQ(rb_init_pow2(&m_rb, buff, 0, 1), RB_INVALID_ARG);
+    EXPECT_EQ(rb_init_pow2(&m_rb, buff, sizeof(buff), 0), RB_INVALID_ARG);
+}
+
+TEST_F(RingBufferPow2, rb_add_GivenPow2Buffer_UsesAllSlots)
+{
+    EXPECT_EQ(m_rb.cap, m_cap);
+    for (size_t i = 0; i < m_cap; ++i)
+    {
+        EXPECT_EQ(rb_add(&m_rb, &i), RB_OK);
+    }
+
+    size_t val = 0;
+    EXPECT_TRUE(rb_is_full(&m_rb));
+    EXPECT_EQ(rb_add(&m_rb, &val), RB_FULL);
+    EXPECT_EQ(rb_size(&m_rb), m_cap);
+}
+
+TEST_F(RingBufferPow2, rb_get_next_val_WhenIndicesRunPastCapacity_ReadsValuesInOrder)
+{
+    size_t next     = 0;
+    size_t expected = 0;
+    for (size_t round = 0; round < 5 * m_cap; ++round)
+    {
+        while (rb_add(&m_rb, &next) == RB_OK)
+        {
+            next++;
+        }
+
+        rb_it_t it = {};
+        ASSERT_EQ(rb_init_read_it(&m_rb, &it), RB_OK);
+        for (size_t i = 0; i < 3; ++i)
+        {
+            size_t val;
+            ASSERT_EQ(rb_get_next_val(&it, &val), RB_OK);
+            EXPECT_EQ(val, expected + i);
+        }
+        ASSERT_EQ(rb_remove_n(&m_rb, 3, NULL), RB_OK);
+        expected += 3;
+    }
+
+    // head and tail are free-running, the slots are obtained by masking
+    EXPECT_GT(m_rb.head, m_cap);
+    EXPECT_EQ(rb_size(&m_rb), m_rb.head - m_rb.tail);
+}
+
+TEST_F(RingBufferPow2, rb_add_n_WhenWrapsAround_ReadsCorrectValues)
+{
+    size_t vals[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    ASSERT_EQ(rb_add_n(&m_rb, vals, 6, NULL), RB_OK);
+    ASSERT_EQ(rb_remove_n(&m_rb, 5, NULL), RB_OK);
+
+    size_t added = 0;
+    ASSERT_EQ(rb_add_n(&m_rb, vals + 6, 4, &added), RB_OK);
+    ASSERT_EQ(added, 4);
+
+    void*  ptr;
+    size_t count;
+    ASSERT_EQ(rb_peek_read(&m_rb, &ptr, &count), RB_OK);
+    EXPECT_EQ(count, 3);
+
+    size_t  expectedValues[] = {5, 6, 7, 8, 9};
+    size_t  readValues[5];
+    size_t  read = 0;
+    rb_it_t it   = {};
+    ASSERT_EQ(rb_init_read_it(&m_rb, &it), RB_OK);
+    ASSERT_EQ(rb_read_n(&it, readValues, 5, &read), RB_OK);
+    ASSERT_EQ(read, 5);
+    for (size_t i = 0; i < read; ++i)
+    {
+        EXPECT_EQ(readValues[i], expectedValues[i]);
+    }
+}
+
+TEST_F(RingBufferTest, rb_push_overwrite_WhenNotInitialized_ReturnsError)
+{
+    ring_buffer_t rb  = {};
+    size_t        val = 0;
+    EXPECT_EQ(rb_push_overwrite(&rb, &val, NULL, NULL), RB_NOT_INIT);
+}
+
+TEST_F(RingBufferInitialized, rb_push_overwrite_GivenNotFullBuffer_DoesNotEvict)
+{
+    size_t val     = 3;
+    size_t old     = 0;
+    bool   evicted = true;
+    EXPECT_EQ(rb_push_overwrite(&m_rb, &val, &old, &evicted), RB_OK);
+    EXPECT_FALSE(evicted);
+    EXPECT_EQ(rb_size(&m_rb), 1);
+}
+
+TEST_F(RingBufferFull, rb_push_overwrite_GivenFullBuffer_EvictsOldestElement)
+{
+    // initial values [0,1,2,3,4]
+    size_t val     = 7;
+    size_t old     = 0;
+    bool   evicted = false;
+    EXPECT_EQ(rb_push_overwrite(&m_rb, &val, &old, &evicted), RB_OK);
+    EXPECT_TRUE(evicted);
+    EXPECT_EQ(old, 0);
+    EXPECT_TRUE(rb_is_full(&m_rb));
+
+    size_t  expectedValues[] = {1, 2, 3, 4, 7};
+    size_t  readValues[5];
+    size_t  read = 0;
+    rb_it_t it   = {};
+    ASSERT_EQ(rb_init_read_it(&m_rb, &it), RB_OK);
+    ASSERT_EQ(rb_read_n(&it, readValues, 5, &read), RB_OK);
+    ASSERT_EQ(read, 5);
+    for (size_t i = 0; i < read; ++i)
+    {
+        EXPECT_EQ(readValues[i], expectedValues[i]);
+    }
+}
+
+TEST_F(RingBufferPow2, rb_push_overwrite_GivenFullPow2Buffer_EvictsOldestElement)
+{
+    for (size_t i = 0; i < 3 * m_cap; ++i)
+    {
+        size_t old     = 0;
+        bool   evicted = false;
+        ASSERT_EQ(rb_push_overwrite(&m_rb, &i, &old, &evicted), RB_OK);
+        EXPECT_EQ(evicted, i >= m_cap);
+        if (evicted)
+        {
+            EXPECT_EQ(old, i - m_cap);
+        }
+    }
+    EXPECT_EQ(rb_size(&m_rb), m_cap);
+}
+
+TEST_F(RingBufferTest, rb_seek_time_GivenNotTimestampedBuffer_ReturnsUnsupported)
+{
+    TsSample   buff[4];
+    rb_it_t    it;
+    rb_range_t range;
+
+    EXPECT_EQ(rb_init_ts(&m_rb, buff, sizeof(buff), sizeof(uint32_t)), RB_INVALID_ARG);
+    ASSERT_EQ(rb_init(&m_rb, buff, sizeof(buff), sizeof(buff[0])), RB_OK);
+    EXPECT_EQ(rb_seek_time(&m_rb, 0, &it), RB_UNSUPPORTED);
+    EXPECT_EQ(rb_seek_range(&m_rb, 0, 1, &range), RB_UNSUPPORTED);
+    EXPECT_EQ(rb_seek_time(&m_rb, 0, NULL), RB_INVALID_ARG);
+}
+
+TEST_F(RingBufferTs, rb_seek_time_WhenElementsWrap_FindsOldestElementNotBefore)
+{
+    fill(20); // timestamps 120..190, wrapped around the end of the buffer
+
+    rb_it_t  it;
+    TsSample sample;
+    ASSERT_EQ(rb_seek_time(&m_rb, 125, &it), RB_OK);
+    ASSERT_EQ(rb_get_next_val(&it, &sample), RB_OK);
+    EXPECT_EQ(sample.ts, 130u);
+    ASSERT_EQ(rb_get_next_val(&it, &sample), RB_OK);
+    EXPECT_EQ(sample.ts, 140u);
+
+    ASSERT_EQ(rb_seek_time(&m_rb, 180, &it), RB_OK);
+    ASSERT_EQ(rb_get_next_val(&it, &sample), RB_OK);
+    EXPECT_EQ(sample.val, 18u);
+
+    ASSERT_EQ(rb_seek_time(&m_rb, 0, &it), RB_OK);
+    ASSERT_EQ(rb_get_next_val(&it, &sample), RB_OK);
+    EXPECT_EQ(sample.ts, 120u);
+
+    ASSERT_EQ(rb_seek_time(&m_rb, 191, &it), RB_OK);
+    EXPECT_EQ(rb_get_next_val(&it, &sample), RB_EMPTY);
+}
+
+TEST_F(RingBufferTs, rb_seek_range_GivenTimeRange_ReadsElementsWithinIt)
+{
+    fill(13); // timestamps 50..120
+
+    rb_range_t range;
+    TsSample   sample;
+    ASSERT_EQ(rb_seek_range(&m_rb, 75, 110, &range), RB_OK);
+    EXPECT_EQ(rb_range_left(&range), 3u);
+    for (uint64_t ts: {80u, 90u, 100u})
+    {
+        ASSERT_EQ(rb_range_next(&range, &sample), RB_OK);
+        EXPECT_EQ(sample.ts, ts);
+    }
+    EXPECT_EQ(rb_range_next(&range, &sample), RB_EMPTY);
+
+    ASSERT_EQ(rb_seek_range(&m_rb, 0, 1000, &range), RB_OK);
+    EXPECT_EQ(rb_range_left(&range), m_cap);
+    ASSERT_EQ(rb_seek_range(&m_rb, 90, 90, &range), RB_OK);
+    EXPECT_EQ(rb_range_left(&range), 0u);
+    ASSERT_EQ(rb_seek_range(&m_rb, 200, 300, &range), RB_OK);
+    EXPECT_EQ(rb_range_next(&range, &sample), RB_EMPTY);
+}
+
+TEST_F(RingBufferTs, rb_seek_range_GivenEqualTimestamps_IncludesAllOfThem)
+{
+    for (uint32_t i = 0; i < m_cap; ++i)
+    {
+        TsSample sample = {100u + (i / 3), i};
+        ASSERT_EQ(rb_add(&m_rb, &sample), RB_OK);
+    }
+
+    rb_range_t range;
+    TsSample   sample;
+    ASSERT_EQ(rb_seek_range(&m_rb, 101, 102, &range), RB_OK);
+    EXPECT_EQ(rb_range_left(&range), 3u);
+    ASSERT_EQ(rb_range_next(&range, &sample), RB_OK);
+    EXPECT_EQ(sample.val, 3u);
+}
+
+TEST_F(RingBufferInitialized, rb_at_GivenIndexOutOfRange_ReturnsError)
+{
+    void*  ptr;
+    size_t val = 7;
+
+    EXPECT_EQ(rb_at(&m_rb, 0, &ptr), RB_INVALID_ARG);
+    ASSERT_EQ(rb_add(&m_rb, &val), RB_OK);
+    EXPECT_EQ(rb_at(&m_rb, 1, &ptr), RB_INVALID_ARG);
+    EXPECT_EQ(rb_at(&m_rb, 0, NULL), RB_INVALID_ARG);
+    ASSERT_EQ(rb_at(&m_rb, 0, &ptr), RB_OK);
+    EXPECT_EQ(*(size_t*)ptr, val);
+}
+
+TEST_F(RingBufferFull, rb_at_WhenElementsWrap_ReturnsElementsFromOldest)
+{
+    // contents 3, 4, 5, 6 wrapped around the end of the buffer
+    for (size_t i = 5; i < 7; ++i)
+    {
+        ASSERT_EQ(rb_remove(&m_rb), RB_OK);
+        ASSERT_EQ(rb_add(&m_rb, &i), RB_OK);
+    }
+    ASSERT_EQ(rb_remove(&m_rb), RB_OK);
+
+    void* ptr;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        ASSERT_EQ(rb_at(&m_rb, i, &ptr), RB_OK);
+        EXPECT_EQ(*(size_t*)ptr, i + 3);
+    }
+    EXPECT_EQ(rb_at(&m_rb, 4, &ptr), RB_INVALID_ARG);
+}
+
+TEST_F(RingBufferPow2, rb_at_WhenIndicesRunPastCapacity_ReturnsElementsFromOldest)
+{
+    for (size_t i = 0; i < 2 * m_cap + 3; ++i)
+    {
+        ASSERT_EQ(rb_push_overwrite(&m_rb, &i, NULL, NULL), RB_OK);
+    }
+
+    void* ptr;
+    for (size_t i = 0; i < m_cap; ++i)
+    {
+        ASSERT_EQ(rb_at(&m_rb, i, &ptr), RB_OK);
+        EXPECT_EQ(*(size_t*)ptr, m_cap + 3 + i);
+    }
+}
+
+TEST_F(RingBufferInitialized, rb_peek_newest_GivenEmptyBuffer_ReturnsError)
+{
+    void* ptr;
+    EXPECT_EQ(rb_peek_newest(&m_rb, &ptr), RB_EMPTY);
+    EXPECT_EQ(rb_peek_oldest(&m_rb, &ptr), RB_EMPTY);
+}
+
+TEST_F(RingBufferFull, rb_peek_newest_WhenHeadAtZero_ReturnsLastSlot)
+{
+    // head wraps to the first slot, the newest element is in the last one
+    size_t val = 10;
+    ASSERT_EQ(rb_remove(&m_rb), RB_OK);
+    ASSERT_EQ(rb_add(&m_rb, &val), RB_OK);
+
+    void* ptr;
+    ASSERT_EQ(rb_peek_newest(&m_rb, &ptr), RB_OK);
+    EXPECT_EQ(*(size_t*)ptr, val);
+    ASSERT_EQ(rb_peek_oldest(&m_rb, &ptr), RB_OK);
+    EXPECT_EQ(*(size_t*)ptr, 1u);
+    EXPECT_EQ(rb_size(&m_rb), m_cap);
+}
+
+TEST_F(RingBufferFull, rb_get_prev_val_WhenElementsWrap_ReadsNewestToOldest)
+{
+    for (size_t i = 5; i < 8; ++i)
+    {
+        ASSERT_EQ(rb_remove(&m_rb), RB_OK);
+        ASSERT_EQ(rb_add(&m_rb, &i), RB_OK);
+    }
+
+    rb_it_t it;
+    size_t  val;
+    ASSERT_EQ(rb_init_reverse_it(&m_rb, &it), RB_OK);
+    for (size_t i = 0; i < m_cap; ++i)
+    {
+        ASSERT_EQ(rb_get_prev_val(&it, &val), RB_OK);
+        EXPECT_EQ(val, 7 - i);
+    }
+    EXPECT_EQ(rb_get_prev_val(&it, &val), RB_EMPTY);
+}
+
+#ifdef RB_ENABLE_STATS
+TEST_F(RingBufferInitialized, rb_stats_snapshot_GivenMixedOperations_CountsThem)
+{
+    size_t vals[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    size_t added;
+    size_t removed;
+
+    ASSERT_EQ(rb_add_n(&m_rb, vals, 4, &added), RB_OK);
+    ASSERT_EQ(rb_remove(&m_rb), RB_OK);
+    ASSERT_EQ(rb_add_n(&m_rb, vals, 3, &added), RB_OK); // only 2 fit
+    EXPECT_EQ(rb_add(&m_rb, &vals[0]), RB_FULL);
+    ASSERT_EQ(rb_push_overwrite(&m_rb, &vals[0], NULL, NULL), RB_OK);
+    ASSERT_EQ(rb_remove_n(&m_rb, 10, &removed), RB_OK);
+    EXPECT_EQ(rb_remove(&m_rb), RB_EMPTY);
+
+    rb_stats_t stats;
+    ASSERT_EQ(rb_stats_snapshot(&m_rb, &stats), RB_OK);
+    EXPECT_EQ(stats.pushes, 7u);
+    EXPECT_EQ(stats.pops, 6u);
+    EXPECT_EQ(stats.full_rejects, 2u);
+    EXPECT_EQ(stats.empty_rejects, 2u);
+    EXPECT_EQ(stats.overwrites, 1u);
+    EXPECT_EQ(stats.high_water, m_cap);
+
+    EXPECT_EQ(rb_stats_snapshot(&m_rb, NULL), RB_INVALID_ARG);
+}
+#else
+TEST_F(RingBufferInitialized, rb_stats_snapshot_WhenStatsDisabled_ReturnsUnsupported)
+{
+    rb_stats_t stats;
+    EXPECT_EQ(rb_stats_snapshot(&m_rb, &stats), RB_UNSUPPORTED);
+}
+#endif
+
 } // namespace
\ No newline at end of file
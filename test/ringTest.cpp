@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+
+#include "hr_ema.h"
+#include "ring_buffer.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+struct Sample
+{
+    uint32_t ts;
+    uint32_t hr;
+    uint64_t seq;
+};
+
+template<typename Ring>
+std::vector<int> toVector(const Ring& ring)
+{
+    std::vector<int> res;
+    for (const auto& val: ring)
+    {
+        res.push_back(val);
+    }
+    return res;
+}
+
+TEST(ringTest, push_GivenFullRing_ReturnsFalse)
+{
+    rb::ring<int, 3> ring;
+    static_assert(rb::ring<int, 3>::capacity() == 3, "");
+    static_assert(!rb::ring<int, 3>::is_pow2, "");
+
+    EXPECT_TRUE(ring.empty());
+    EXPECT_TRUE(ring.push(1));
+    EXPECT_TRUE(ring.push(2));
+    EXPECT_TRUE(ring.push(3));
+    EXPECT_TRUE(ring.full());
+    EXPECT_FALSE(ring.push(4));
+    EXPECT_EQ(ring.size(), 3u);
+}
+
+TEST(ringTest, pop_GivenWrappedRing_ReturnsElementsInOrder)
+{
+    rb::ring<int, 3> odd;
+    rb::ring<int, 4> pow2;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(odd.push(i));
+        ASSERT_TRUE(pow2.push(i));
+
+        int out = -1;
+        ASSERT_TRUE(odd.pop(out));
+        EXPECT_EQ(out, i);
+        ASSERT_TRUE(pow2.pop(out));
+        EXPECT_EQ(out, i);
+    }
+    EXPECT_TRUE(odd.empty());
+    EXPECT_FALSE(odd.pop());
+}
+
+TEST(ringTest, begin_GivenWrappedRing_IteratesFromOldest)
+{
+    rb::ring<int, 5> ring;
+    for (int i = 0; i < 12; ++i)
+    {
+        ring.push_overwrite(i);
+    }
+
+    EXPECT_EQ(toVector(ring), std::vector<int>({7, 8, 9, 10, 11}));
+    EXPECT_EQ(ring.front(), 7);
+    EXPECT_EQ(ring.back(), 11);
+    EXPECT_EQ(ring[2], 9);
+}
+
+TEST(ringTest, push_GivenMoveOnlyType_MovesElements)
+{
+    rb::ring<std::unique_ptr<int>, 2> ring;
+
+    EXPECT_TRUE(ring.push(std::make_unique<int>(1)));
+    EXPECT_TRUE(ring.emplace(new int(2)));
+    EXPECT_FALSE(ring.push(std::make_unique<int>(3)));
+
+    std::unique_ptr<int> out;
+    ASSERT_TRUE(ring.pop(out));
+    EXPECT_EQ(*out, 1);
+    EXPECT_EQ(*ring.front(), 2);
+}
+
+TEST(ringTest, clear_GivenNonTrivialType_DestroysElements)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        rb::ring<std::shared_ptr<int>, 4> ring;
+        for (int i = 0; i < 6; ++i)
+        {
+            ring.push_overwrite(counter);
+        }
+        EXPECT_EQ(counter.use_count(), 5);
+
+        ring.pop();
+        EXPECT_EQ(counter.use_count(), 4);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(ringTest, c_handle_GivenCApi_SharesElements)
+{
+    rb::ring<uint8_t, 10> ring;
+    ring_buffer_t*        rb = ring.c_handle();
+
+    uint8_t val = 60;
+    ASSERT_EQ(rb_add(rb, &val), RB_OK);
+    ASSERT_TRUE(ring.push(70));
+    EXPECT_EQ(rb_size(rb), 2u);
+    EXPECT_EQ(ring.size(), 2u);
+    EXPECT_EQ(ring.front(), 60);
+    EXPECT_EQ(ring.back(), 70);
+
+    ASSERT_EQ(rb_remove(rb), RB_OK);
+    EXPECT_EQ(ring.front(), 70);
+    EXPECT_EQ(hr_ema_calc(rb), 70);
+}
+
+TEST(ringTest, c_handle_GivenPow2Ring_MatchesCIteration)
+{
+    rb::ring<Sample, 8> ring;
+    for (uint32_t i = 0; i < 13; ++i)
+    {
+        ring.push_overwrite(Sample{i, 60 + i, i * 10u});
+    }
+
+    rb_it_t it;
+    ASSERT_EQ(rb_init_read_it(ring.c_handle(), &it), RB_OK);
+    for (const Sample& expected: ring)
+    {
+        Sample out;
+        ASSERT_EQ(rb_get_next_val(&it, &out), RB_OK);
+        EXPECT_EQ(out.ts, expected.ts);
+        EXPECT_EQ(out.seq, expected.seq);
+    }
+    Sample out;
+    EXPECT_EQ(rb_get_next_val(&it, &out), RB_EMPTY);
+}
+
+} // namespace
\ No newline at end of file